@@ -16,6 +16,13 @@ OMP_NUM_THREADS=4 make test || cat Testing/Temporary/LastTest.log / # "/" intent
 cmake -DCMAKE_BUILD_TYPE=RelWithDebInfo ../ 
 VERBOSE=1 make 
 OMP_NUM_THREADS=4 make test || cat Testing/Temporary/LastTest.log / # "/" intentional! (just to make cat exit with an error code)
+# 32-bit multiplicities, in a separate build directory (the 64-bit build is the one installed)
+mkdir ../build_n_t_32bit
+cd ../build_n_t_32bit
+cmake -DCMAKE_BUILD_TYPE=RelWithDebInfo -DLIBCLOUDPHXX_N_T_32BIT=ON ../
+VERBOSE=1 make
+OMP_NUM_THREADS=4 make test || cat Testing/Temporary/LastTest.log / # "/" intentional! (just to make cat exit with an error code)
+cd ../build
 sudo make install
 cd ../..
 
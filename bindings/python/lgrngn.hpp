@@ -56,6 +56,91 @@ namespace libcloudphxx
         ))); // TODO: this assumes Python 2 -> make it compatible with P3 or require P2 in CMake
       }
 
+      template <typename real_t>
+      bp::list diag_moms(
+        lgr::particles_proto_t<real_t> *arg,
+        const bp::list &reqs
+      ) {
+        std::vector<lgr::moms_req_t<real_t> > vec;
+        for (int i = 0; i < len(reqs); ++i)
+          vec.push_back(bp::extract<lgr::moms_req_t<real_t> >(reqs[i]));
+
+        bp::list res;
+        for (auto &ptr : arg->diag_moms(vec))
+          res.append(bp::object(bp::handle<>(PyBuffer_FromMemory(
+            ptr, 
+            sizeof(real_t)
+            * std::max(1, arg->opts_init->nx) 
+            * std::max(1, arg->opts_init->ny) 
+            * std::max(1, arg->opts_init->nz) 
+          )))); // TODO: this assumes Python 2 (as outbuf above)
+        return res;
+      }
+
+      template <typename real_t>
+      bp::list diag_moms_tot(
+        lgr::particles_proto_t<real_t> *arg,
+        const bp::list &reqs
+      ) {
+        std::vector<lgr::moms_req_t<real_t> > vec;
+        for (int i = 0; i < len(reqs); ++i)
+          vec.push_back(bp::extract<lgr::moms_req_t<real_t> >(reqs[i]));
+
+        bp::list res;
+        for (auto &val : arg->diag_moms_tot(vec))
+          res.append(val);
+        return res;
+      }
+
+      template <typename real_t>
+      void set_moms(
+	lgr::moms_req_t<real_t> *arg,
+	const bp::list &vec
+      )
+      {
+        arg->moms.clear();
+	for (int i = 0; i < len(vec); ++i)
+	  arg->moms.push_back(bp::extract<int>(vec[i]));
+      }
+
+      template <typename real_t>
+      bp::list get_moms(
+	lgr::moms_req_t<real_t> *arg
+      )
+      {
+        bp::list res;
+        for (auto &k : arg->moms) res.append(k);
+        return res;
+      }
+
+      inline void set_snap_attrs(
+	lgr::snapshot_opts_t *arg,
+	const bp::list &vec
+      )
+      {
+        arg->attrs.clear();
+	for (int i = 0; i < len(vec); ++i)
+	  arg->attrs.push_back(bp::extract<lgr::snap_attr_t::snap_attr_t>(vec[i]));
+      }
+
+      inline bp::list get_snap_attrs(
+	lgr::snapshot_opts_t *arg
+      )
+      {
+        bp::list res;
+        for (auto &a : arg->attrs) res.append(a);
+        return res;
+      }
+
+      inline bp::dict get_peak_bytes(
+	lgr::workspace_info_t *arg
+      )
+      {
+        bp::dict res;
+        for (auto &p : arg->peak_bytes) res[p.first] = p.second;
+        return res;
+      }
+
       template <typename real_t>
       const std::array<int, 3> sz(
         const lgr::particles_proto_t<real_t> &arg
@@ -100,6 +185,41 @@ namespace libcloudphxx
 	);
       }
 
+      // 
+      template <typename real_t>
+      void restore(
+	lgr::particles_proto_t<real_t> *arg,
+	const std::string &path,
+	const bp_array &th,
+	const bp_array &rv,
+	const bp_array &rhod,
+        const bp_array &Cx,
+        const bp_array &Cy,
+        const bp_array &Cz,
+        const bp::dict &ambient_chem
+      )
+      {
+        typedef std::map<enum lgr::chem_species_t, const lgr::arrinfo_t<real_t> > map_t;
+        map_t map;
+
+        for (int i = 0; i < len(ambient_chem.keys()); ++i)
+          map.insert(typename map_t::value_type(
+            bp::extract<enum lgr::chem_species_t>(ambient_chem.keys()[i]),
+            np2ai<real_t>(bp::extract<bp_array>(ambient_chem.values()[i]), sz(*arg))
+          ));
+
+	arg->restore(
+	  path,
+	  np2ai<real_t>(th,      sz(*arg)),
+	  np2ai<real_t>(rv,      sz(*arg)),
+	  np2ai<real_t>(rhod,    sz(*arg)),
+          np2ai<real_t>(Cx,      sz(*arg)),
+          np2ai<real_t>(Cy,      sz(*arg)),
+          np2ai<real_t>(Cz,      sz(*arg)),
+          map // ambient_chem
+	);
+      }
+
       // 
       template <typename real_t>
       void step_sync(
@@ -187,7 +187,9 @@ BOOST_PYTHON_MODULE(libcloudphxx)
     bp::enum_<lgr::backend_t>("backend_t")
       .value("serial", lgr::serial)
       .value("OpenMP", lgr::OpenMP)
-      .value("CUDA",   lgr::CUDA);
+      .value("CUDA",   lgr::CUDA)
+      .value("multi_CUDA", lgr::multi_CUDA)
+      .value("multi_OpenMP", lgr::multi_OpenMP);
     bp::enum_<lgr::kernel_t::kernel_t>("kernel_t") 
       .value("geometric", lgr::kernel_t::geometric)
       .value("golovin", lgr::kernel_t::golovin)
@@ -210,6 +212,26 @@ BOOST_PYTHON_MODULE(libcloudphxx)
       .value("implicit", lgr::as_t::implicit)
       .value("euler", lgr::as_t::euler)
       .value("pred_corr", lgr::as_t::pred_corr);
+    bp::enum_<lgr::sort_t::sort_t>("sort_t") 
+      .value("full", lgr::sort_t::full)
+      .value("incremental", lgr::sort_t::incremental);
+    bp::enum_<lgr::cond_solver_t::cond_solver_t>("cond_solver_t") 
+      .value("toms748", lgr::cond_solver_t::toms748)
+      .value("newton", lgr::cond_solver_t::newton);
+    bp::enum_<lgr::attr_t::attr_t>("attr_t") 
+      .value("rd", lgr::attr_t::rd)
+      .value("rw", lgr::attr_t::rw)
+      .value("kappa", lgr::attr_t::kappa);
+
+    bp::enum_<lgr::snap_attr_t::snap_attr_t>("snap_attr_t") 
+      .value("x", lgr::snap_attr_t::x)
+      .value("y", lgr::snap_attr_t::y)
+      .value("z", lgr::snap_attr_t::z)
+      .value("rd3", lgr::snap_attr_t::rd3)
+      .value("rw2", lgr::snap_attr_t::rw2)
+      .value("kpa", lgr::snap_attr_t::kpa)
+      .value("n", lgr::snap_attr_t::n)
+      .value("chem", lgr::snap_attr_t::chem);
 
     bp::enum_<lgr::chem_species_t>("chem_species_t")
       .value("H",    lgr::H)
@@ -258,12 +280,22 @@ BOOST_PYTHON_MODULE(libcloudphxx)
       .def_readwrite("sedi_switch", &lgr::opts_init_t<real_t>::sedi_switch)
       .def_readwrite("src_switch", &lgr::opts_init_t<real_t>::src_switch)
       .def_readwrite("exact_sstp_cond", &lgr::opts_init_t<real_t>::exact_sstp_cond)
+      .def_readwrite("adaptive_sstp_cond", &lgr::opts_init_t<real_t>::adaptive_sstp_cond)
       .def_readwrite("sstp_cond", &lgr::opts_init_t<real_t>::sstp_cond)
       .def_readwrite("sstp_coal", &lgr::opts_init_t<real_t>::sstp_coal)
+      .def_readwrite("adaptive_sstp_coal", &lgr::opts_init_t<real_t>::adaptive_sstp_coal)
+      .def_readwrite("sstp_coal_max", &lgr::opts_init_t<real_t>::sstp_coal_max)
       .def_readwrite("sstp_chem", &lgr::opts_init_t<real_t>::sstp_chem)
       .def_readwrite("supstp_src", &lgr::opts_init_t<real_t>::supstp_src)
       .def_readwrite("kernel", &lgr::opts_init_t<real_t>::kernel)
+      .def_readwrite("kernel_eff_file", &lgr::opts_init_t<real_t>::kernel_eff_file)
+      .def_readwrite("tab_vterm", &lgr::opts_init_t<real_t>::tab_vterm)
+      .def_readwrite("tab_kernel", &lgr::opts_init_t<real_t>::tab_kernel)
+      .def_readwrite("tab_kernel_n_r", &lgr::opts_init_t<real_t>::tab_kernel_n_r)
+      .def_readwrite("tab_kernel_r_min", &lgr::opts_init_t<real_t>::tab_kernel_r_min)
       .def_readwrite("adve_scheme", &lgr::opts_init_t<real_t>::adve_scheme)
+      .def_readwrite("sort_engine", &lgr::opts_init_t<real_t>::sort_engine)
+      .def_readwrite("cond_solver", &lgr::opts_init_t<real_t>::cond_solver)
       .def_readwrite("sd_conc", &lgr::opts_init_t<real_t>::sd_conc)
       .def_readwrite("sd_conc_large_tail", &lgr::opts_init_t<real_t>::sd_conc_large_tail)
       .def_readwrite("sd_const_multi", &lgr::opts_init_t<real_t>::sd_const_multi)
@@ -274,8 +306,47 @@ BOOST_PYTHON_MODULE(libcloudphxx)
       .def_readwrite("chem_rho", &lgr::opts_init_t<real_t>::chem_rho)
       .def_readwrite("RH_max", &lgr::opts_init_t<real_t>::RH_max)
       .def_readwrite("rng_seed", &lgr::opts_init_t<real_t>::rng_seed)
+      .def_readwrite("reorder_freq", &lgr::opts_init_t<real_t>::reorder_freq)
+      .def_readwrite("reorder_threshold", &lgr::opts_init_t<real_t>::reorder_threshold)
       .add_property("kernel_parameters", &lgrngn::get_kp<real_t>, &lgrngn::set_kp<real_t>)
     ;
+    bp::class_<lgr::moms_req_t<real_t> >("moms_req_t")
+      .def_readwrite("rng_attr", &lgr::moms_req_t<real_t>::rng_attr)
+      .def_readwrite("rng_min", &lgr::moms_req_t<real_t>::rng_min)
+      .def_readwrite("rng_max", &lgr::moms_req_t<real_t>::rng_max)
+      .def_readwrite("mom_attr", &lgr::moms_req_t<real_t>::mom_attr)
+      .add_property("moms", &lgrngn::get_moms<real_t>, &lgrngn::set_moms<real_t>)
+    ;
+    bp::class_<lgr::snapshot_opts_t>("snapshot_opts_t")
+      .add_property("attrs", &lgrngn::get_snap_attrs, &lgrngn::set_snap_attrs)
+      .def_readwrite("sd_stride", &lgr::snapshot_opts_t::sd_stride)
+      .def_readwrite("stp_stride", &lgr::snapshot_opts_t::stp_stride)
+    ;
+    bp::class_<lgr::cond_stats_t>("cond_stats_t")
+      .def_readonly("n_solve", &lgr::cond_stats_t::n_solve)
+      .def_readonly("n_iter", &lgr::cond_stats_t::n_iter)
+      .def_readonly("n_iter_max", &lgr::cond_stats_t::n_iter_max)
+      .def_readonly("n_fallback", &lgr::cond_stats_t::n_fallback)
+    ;
+    bp::class_<lgr::vt_tab_info_t>("vt_tab_info_t")
+      .def_readonly("n_r", &lgr::vt_tab_info_t::n_r)
+      .def_readonly("n_T", &lgr::vt_tab_info_t::n_T)
+      .def_readonly("n_rhod", &lgr::vt_tab_info_t::n_rhod)
+      .def_readonly("err_rel", &lgr::vt_tab_info_t::err_rel)
+    ;
+    bp::class_<lgr::kernel_tab_info_t>("kernel_tab_info_t")
+      .def_readonly("n_r", &lgr::kernel_tab_info_t::n_r)
+      .def_readonly("r_min", &lgr::kernel_tab_info_t::r_min)
+      .def_readonly("r_max", &lgr::kernel_tab_info_t::r_max)
+      .def_readonly("err_max", &lgr::kernel_tab_info_t::err_max)
+      .def_readonly("err_rel", &lgr::kernel_tab_info_t::err_rel)
+    ;
+    bp::class_<lgr::workspace_info_t>("workspace_info_t")
+      .def_readonly("reserved_bytes", &lgr::workspace_info_t::reserved_bytes)
+      .def_readonly("resident_bytes", &lgr::workspace_info_t::resident_bytes)
+      .def_readonly("n_alloc", &lgr::workspace_info_t::n_alloc)
+      .add_property("peak_bytes", &lgrngn::get_peak_bytes)
+    ;
     bp::class_<lgr::particles_proto_t<real_t>/*, boost::noncopyable*/>("particles_proto_t")
       .add_property("opts_init", &lgrngn::get_oi<real_t>)
       .def("init",         &lgrngn::init<real_t>, (
@@ -287,6 +358,20 @@ BOOST_PYTHON_MODULE(libcloudphxx)
         bp::arg("Cz")  = BP_ARR_FROM_BP_OBJ,
         bp::arg("ambient_chem") = bp::dict()
       ))
+      .def("restore",      &lgrngn::restore<real_t>, (
+        bp::arg("path"),
+        bp::arg("th")  = BP_ARR_FROM_BP_OBJ,
+        bp::arg("rv")  = BP_ARR_FROM_BP_OBJ,
+        bp::arg("rhod")= BP_ARR_FROM_BP_OBJ,
+        bp::arg("Cx")  = BP_ARR_FROM_BP_OBJ,
+        bp::arg("Cy")  = BP_ARR_FROM_BP_OBJ,
+        bp::arg("Cz")  = BP_ARR_FROM_BP_OBJ,
+        bp::arg("ambient_chem") = bp::dict()
+      ))
+      .def("checkpoint",   &lgr::particles_proto_t<real_t>::checkpoint)
+      .def("snapshot_open", &lgr::particles_proto_t<real_t>::snapshot_open)
+      .def("snapshot",     &lgr::particles_proto_t<real_t>::snapshot)
+      .def("snapshot_close", &lgr::particles_proto_t<real_t>::snapshot_close)
       .def("step_sync",    &lgrngn::step_sync<real_t>, (
         bp::arg("th")  = BP_ARR_FROM_BP_OBJ,
         bp::arg("rv")  = BP_ARR_FROM_BP_OBJ,
@@ -297,12 +382,16 @@ BOOST_PYTHON_MODULE(libcloudphxx)
         bp::arg("ambient_chem") = bp::dict()
       ))
       .def("step_async",   &lgr::particles_proto_t<real_t>::step_async)
+      .def("step_async_begin", &lgr::particles_proto_t<real_t>::step_async_begin)
+      .def("step_async_wait", &lgr::particles_proto_t<real_t>::step_async_wait)
+      .def("step_async_pending", &lgr::particles_proto_t<real_t>::step_async_pending)
       .def("diag_sd_conc", &lgr::particles_proto_t<real_t>::diag_sd_conc)
       .def("diag_all",     &lgr::particles_proto_t<real_t>::diag_all)
       .def("diag_rw_ge_rc",&lgr::particles_proto_t<real_t>::diag_rw_ge_rc)
       .def("diag_RH_ge_Sc",&lgr::particles_proto_t<real_t>::diag_RH_ge_Sc)
       .def("diag_RH",&lgr::particles_proto_t<real_t>::diag_RH)
       .def("diag_vel_div",&lgr::particles_proto_t<real_t>::diag_vel_div)
+      .def("diag_sstp_coal",&lgr::particles_proto_t<real_t>::diag_sstp_coal)
       .def("diag_dry_rng", &lgr::particles_proto_t<real_t>::diag_dry_rng)
       .def("diag_wet_rng", &lgr::particles_proto_t<real_t>::diag_wet_rng)
       .def("diag_kappa_rng", &lgr::particles_proto_t<real_t>::diag_kappa_rng)
@@ -313,6 +402,12 @@ BOOST_PYTHON_MODULE(libcloudphxx)
       .def("diag_chem",    &lgr::particles_proto_t<real_t>::diag_chem)
       .def("diag_precip_rate",    &lgr::particles_proto_t<real_t>::diag_precip_rate)
       .def("diag_puddle",    &lgrngn::diag_puddle<real_t>)
+      .def("diag_moms",    &lgrngn::diag_moms<real_t>)
+      .def("diag_moms_tot", &lgrngn::diag_moms_tot<real_t>)
+      .def("diag_cond_stats", &lgr::particles_proto_t<real_t>::diag_cond_stats)
+      .def("diag_kernel_tab", &lgr::particles_proto_t<real_t>::diag_kernel_tab)
+      .def("diag_vt_tab", &lgr::particles_proto_t<real_t>::diag_vt_tab)
+      .def("diag_workspace", &lgr::particles_proto_t<real_t>::diag_workspace)
       .def("outbuf",       &lgrngn::outbuf<real_t>)
     ;
     // functions
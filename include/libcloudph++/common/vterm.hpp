@@ -148,6 +148,22 @@ namespace libcloudphxx
         }
       }
  
+      // slip correction factor from Beard 1976, the velocity is proportional to it for r <= 503.5um
+      template <typename real_t>
+      BOOST_GPU_ENABLED
+      quantity<si::dimensionless, real_t> vt_beard76_C_ac( 
+	quantity<si::length, real_t> r, //radius
+	quantity<si::temperature, real_t> T, //temperature
+	quantity<si::pressure, real_t> p, //pressure
+        quantity<si::dynamic_viscosity, real_t> eta
+      ) 
+      {
+        using earth::p_stp;
+
+        quantity<si::dimensionless, real_t> l = ( real_t(6.62e-8)  * (eta / si::pascals / si::seconds/ real_t(1.818e-5) )  * (p_stp<real_t>() / p)  *  pow(T / si::kelvins / real_t(293.15), real_t(1./2.)) );
+        return real_t(1.) + real_t(1.255) * l * si::meters / r;
+      }
+
       // the exact formula from Beard 1976
       // has to be calculated using double prec, on single prec with -use_fast_math it fails on CUDA
       template <typename real_t>
@@ -166,16 +182,14 @@ namespace libcloudphxx
 
         if(r <= quantity<si::length, real_t>(real_t(9.5e-6) * si::meters)) //TODO: < 0.5um
         {
-          quantity<si::dimensionless, real_t> l = ( real_t(6.62e-8)  * (eta / si::pascals / si::seconds/ real_t(1.818e-5) )  * (p_stp<real_t>() / p)  *  pow(T / si::kelvins / real_t(293.15), real_t(1./2.)) );
-          quantity<si::dimensionless, real_t> C_ac = real_t(1.) + real_t(1.255) * l * si::meters / r;
+          quantity<si::dimensionless, real_t> C_ac = vt_beard76_C_ac(r, T, p, eta);
           return ( (rho_w<real_t>()-rhoa) * g<real_t>() / ( real_t(4.5) * eta) * C_ac * r *r);
         } 
 
         else if(r <= quantity<si::length, real_t>(real_t(5.035e-4) * si::meters))
         {
           const double b[7] = { -0.318657e1, 0.992696, -0.153193e-2, -0.987059e-3, -0.578878e-3, 0.855176e-4,-0.327815e-5};
-          quantity<si::dimensionless, real_t> l = ( real_t(6.62e-8)  * (eta / si::pascals / si::seconds/ real_t(1.818e-5) )  * (p_stp<real_t>() / p)  *  pow(T / si::kelvins / real_t(293.15), real_t(1./2.)) );
-          quantity<si::dimensionless, real_t> C_ac = real_t(1.) + real_t(1.255) * l * si::meters / r;
+          quantity<si::dimensionless, real_t> C_ac = vt_beard76_C_ac(r, T, p, eta);
           quantity<si::dimensionless, real_t> log_N_Da = log( real_t(32./3.) * r * r * r * rhoa * (rho_w<real_t>() - rhoa) * g<real_t>() / eta / eta );
           quantity<si::dimensionless, real_t> Y = 0.;
           for(int i=0; i<7; ++i)
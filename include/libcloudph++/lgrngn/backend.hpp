@@ -6,7 +6,7 @@ namespace libcloudphxx
   {
     // to make inclusion of Thrust not neccesarry here
 //<listing>
-    enum backend_t { serial, OpenMP, CUDA, multi_CUDA }; 
+    enum backend_t { serial, OpenMP, CUDA, multi_CUDA, multi_OpenMP }; 
 //</listing>
   };
 };
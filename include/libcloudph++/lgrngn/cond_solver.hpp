@@ -0,0 +1,33 @@
+/** @file
+  * @copyright University of Warsaw
+  * @brief Choice of the implicit condensational growth solver and its iteration statistics
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  */
+
+#pragma once 
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace cond_solver_t //separate namespace to avoid member name conflicts with other enumerators, TODO: in c++11 change it to an enum class
+    {   
+//<listing>
+      enum cond_solver_t { toms748, newton }; 
+//</listing>
+    }; 
+
+    // statistics of the condensation solver accumulated over all substeps of the last timestep
+    struct cond_stats_t
+    {
+      unsigned long long 
+        n_solve,    // number of per-particle implicit growth problems solved
+        n_iter,     // total number of iterations (toms748 function evaluations or Newton steps)
+        n_iter_max, // maximal number of iterations needed by a single particle
+        n_fallback; // number of times Newton did not converge and toms748 was used
+
+      cond_stats_t() : n_solve(0), n_iter(0), n_iter_max(0), n_fallback(0) {}
+    };
+  };
+};
@@ -5,6 +5,7 @@
 #include <cassert>
 #include <memory>
 #include <map>
+#include <string>
 #include <unordered_map>
 
 #include <boost/ptr_container/ptr_vector.hpp>
@@ -10,5 +10,16 @@ namespace libcloudphxx
       enum kernel_t { undefined, geometric, golovin, hall, hall_davis_no_waals, Long, onishi_hall, onishi_hall_davis_no_waals, hall_pinsky_1000mb_grav, hall_pinsky_cumulonimbus, hall_pinsky_stratocumulus, vohl_davis_no_waals}; 
 //</listing>
     };
+
+    // resolution and accuracy of the tabulated collision kernel (opts_init.tab_kernel)
+    struct kernel_tab_info_t
+    {
+      int n_r;           // number of grid points in radius (0 if the kernel is not tabulated)
+      double r_min, r_max, // range of tabulated radii [m]
+             err_max,    // max abs. difference between the tabulated and exact radius-dependent kernel multiplier (over the whole range of the table)
+             err_rel;    // err_max divided by the largest value of the multiplier
+
+      kernel_tab_info_t() : n_r(0), r_min(0), r_max(0), err_max(0), err_rel(0) {}
+    };
   };
 };
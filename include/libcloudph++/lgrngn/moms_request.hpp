@@ -0,0 +1,43 @@
+/** @file
+  * @copyright University of Warsaw
+  * @brief Definition of a structure describing a batched request for statistical moments
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  */
+
+#pragma once
+
+#include <vector>
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace attr_t //separate namespace to avoid member name conflicts with other enumerators, TODO: in c++11 change it to an enum class
+    {
+//<listing>
+      enum attr_t { rd, rw, kappa }; // dry radius, wet radius, hygroscopicity
+//</listing>
+    };
+
+//<listing>
+    template<typename real_t>
+    struct moms_req_t
+    {
+      // particle selection: rng_min <= rng_attr < rng_max (radii in metres)
+      attr_t::attr_t rng_attr;
+      real_t rng_min, rng_max;
+
+      // attribute of which the moments are computed and their orders
+      attr_t::attr_t mom_attr;
+      std::vector<int> moms;
+//</listing>
+
+      // ctor with defaults (all particles, wet radius)
+      moms_req_t() :
+        rng_attr(attr_t::rw), rng_min(0), rng_max(1),
+        mom_attr(attr_t::rw)
+      {}
+    };
+  };
+};
@@ -11,6 +11,8 @@
 #include <libcloudph++/lgrngn/kernel.hpp>
 #include <libcloudph++/lgrngn/terminal_velocity.hpp>
 #include <libcloudph++/lgrngn/advection_scheme.hpp>
+#include <libcloudph++/lgrngn/sort_engine.hpp>
+#include <libcloudph++/lgrngn/cond_solver.hpp>
 #include <libcloudph++/lgrngn/chem.hpp>
 
 namespace libcloudphxx
@@ -45,6 +47,14 @@ namespace libcloudphxx
 
       // no. of substeps 
       int sstp_cond, sstp_coal; 
+
+      // if true, the number of coalescence substeps is set separately in each cell (starting from sstp_coal)
+      // and can go up or down from one timestep to another depending on the collision probabilities
+      bool adaptive_sstp_coal;
+
+      // upper limit of the number of coalescence substeps in a cell (adaptive_sstp_coal); pair probabilities
+      // in cells at the limit may exceed coal_prob_max (handled as multiple collisions)
+      int sstp_coal_max;
   
       // timestep interval at which source will be applied
       int supstp_src;
@@ -86,17 +96,38 @@ namespace libcloudphxx
 
       // super-droplet advection scheme
       as_t::as_t adve_scheme;
+
+      // algorithm used to sort super-droplets by cell index
+      sort_t::sort_t sort_engine;
+
+      // root-finding algorithm used in the implicit condensational growth
+      cond_solver_t::cond_solver_t cond_solver;
 //</listing>
  
       // coalescence kernel parameters
       std::vector<real_t> kernel_parameters;
 
+      // if not empty, collision efficiencies are read from this file instead of the built-in table of the selected kernel 
+      // (text, values separated with whitespace or commas, ordered as the built-in tables)
+      std::string kernel_eff_file;
+
+      // if true, terminal velocities are interpolated from a (ln r, T, ln rhod) table precomputed at init,
+      // pressure enters through an exact prefactor; the max interpolation error is reported by diag_vt_tab()
+      // (ca. 0.5% with the default resolution), outside of the table range the exact formula is used
+      bool tab_vterm;
+
+      // tabulation of the radius-dependent part of the coalescence kernel (Long, efficiency-based and Onishi kernels)
+      bool tab_kernel;         // if true, it is precomputed at init and interpolated bilinearly in ln(r)
+      int tab_kernel_n_r;      // number of grid points in radius
+      real_t tab_kernel_r_min; // smallest tabulated radius [m], the largest is the limit of the efficiency table
+
       // chem
       bool chem_switch,  // if false no chemical reactions throughout the whole simulation (no memory allocation)
            coal_switch,  // if false no coalescence throughout the whole simulation
            sedi_switch,  // if false no sedimentation throughout the whole simulation
            src_switch,   // if false no source throughout the whole simulation
-           exact_sstp_cond; // if true, use per-particle sstp_cond logic, if false, use per-cell
+           exact_sstp_cond, // if true, use per-particle sstp_cond logic, if false, use per-cell
+           adaptive_sstp_cond; // if true, each SD uses as many of the sstp_cond substeps as its growth rate requires (needs exact_sstp_cond)
 
       int sstp_chem;
       real_t chem_rho;
@@ -107,12 +138,17 @@ namespace libcloudphxx
       // rng seed
       int rng_seed;
 
-      // no of GPUs to use, 0 for all available
+      // no of GPUs to use in multi_CUDA, 0 for all available;
+      // no of x-slabs in multi_OpenMP, 0 for one per OpenMP thread
       int dev_count; 
 
       // GPU number to use, only used in CUDA backend (and not in multi_CUDA)
       int dev_id;
 
+      // physical reordering of super-droplet attributes into cell order
+      int reorder_freq;         // every reorder_freq timesteps (0 - off)
+      real_t reorder_threshold; // or if the fraction of super-droplets out of cell order exceeds it (0 - off)
+
       // ctor with defaults (C++03 compliant) ...
       opts_init_t() : 
         nx(0), ny(0), nz(0),
@@ -125,20 +161,31 @@ namespace libcloudphxx
         sd_const_multi_dry_sizes(0),
         dt(0),   
         sstp_cond(1), sstp_coal(1), sstp_chem(1),         
+        adaptive_sstp_coal(false),
+        sstp_coal_max(100),
         supstp_src(1),
         chem_switch(false),  // chemical reactions turned off by default
         sedi_switch(true),  // sedimentation turned on by default
         coal_switch(true),  // coalescence turned on by default
         src_switch(false),  // source turned off by default
         exact_sstp_cond(false),
+        adaptive_sstp_cond(false),
         RH_max(.95), // value seggested in Lebo and Seinfeld 2011
         chem_rho(0), // dry particle density  //TODO add checking if the user gave a different value (np w init)  (was 1.8e-3)
         rng_seed(44),
         terminal_velocity(vt_t::undefined),
         kernel(kernel_t::undefined),
         adve_scheme(as_t::implicit),
+        sort_engine(sort_t::full),
+        cond_solver(cond_solver_t::toms748),
+        tab_vterm(false),
+        tab_kernel(false),
+        tab_kernel_n_r(512),
+        tab_kernel_r_min(1e-7),
         dev_count(0),
         dev_id(-1),
+        reorder_freq(0),
+        reorder_threshold(0),
         n_sd_max(0),
         src_sd_conc(0),
         src_z1(0)
@@ -5,6 +5,9 @@
 #include "opts.hpp"
 #include "output.hpp"
 #include "opts_init.hpp"
+#include "moms_request.hpp"
+#include "snapshot.hpp"
+#include "workspace.hpp"
 #include "arrinfo.hpp"
 #include "backend.hpp"
 
@@ -28,6 +31,33 @@ namespace libcloudphxx
       ) { 
         assert(false);
       }  
+
+      // alternative to init(): particles read from a file written by checkpoint() instead of
+      // new SDs (Eulerian fields as in init(), i.e. from the time of the checkpoint)
+      virtual void restore(
+        const std::string &path,
+        const arrinfo_t<real_t> th,
+        const arrinfo_t<real_t> rv,
+        const arrinfo_t<real_t> rhod,
+        const arrinfo_t<real_t> courant_x = arrinfo_t<real_t>(),
+        const arrinfo_t<real_t> courant_y = arrinfo_t<real_t>(), 
+        const arrinfo_t<real_t> courant_z = arrinfo_t<real_t>(),
+        const std::map<enum chem_species_t, const arrinfo_t<real_t> > ambient_chem = std::map<enum chem_species_t, const arrinfo_t<real_t> >()
+      ) { 
+        assert(false);
+      }  
+
+      // saves the complete state of the particles, to be called after init()/restore() or step_async();
+      // with multi_CUDA, multi_OpenMP and in MPI runs one file per device/slab/rank is written (.<id> appended to path)
+      virtual void checkpoint(const std::string &path)              { assert(false); }
+
+      // streaming output of SD attributes: snapshot() copies the attributes selected in snapshot_open()
+      // to a staging buffer and returns, the record is appended to the file by a background thread;
+      // to be called after init()/restore() or step_async(); snapshot_close() waits for pending writes
+      // (with multi_CUDA, multi_OpenMP and in MPI runs one file per device/slab/rank, as in checkpoint())
+      virtual void snapshot_open(const std::string &path, const snapshot_opts_t &) { assert(false); }
+      virtual void snapshot()                                       { assert(false); }
+      virtual void snapshot_close()                                 { assert(false); }
  
       // stuff that requires Eulerian component to wait
       virtual void step_sync(
@@ -50,6 +80,22 @@ namespace libcloudphxx
         assert(false); 
       }  
 
+      // runs step_async() on an internal worker thread and returns immediately;
+      // until step_async_wait() returns, only step_async_pending() and step_sync() may
+      // be called (the latter waits for the worker first, so at most one step is in flight);
+      // the Eulerian arrays passed to step_sync() are not accessed by step_async() and
+      // may be modified meanwhile, outbuf() and the diag_moms() buffers must not be read
+      virtual void step_async_begin(
+        const opts_t<real_t> &
+      ) { 
+        assert(false); 
+      }  
+
+      // blocks until the step started with step_async_begin() completes,
+      // rethrowing any exception thrown by it
+      virtual void step_async_wait()                                { assert(false); }
+      virtual bool step_async_pending()                             { assert(false); return false; }
+
       // method for accessing super-droplet statistics
       virtual void diag_sd_conc()                                   { assert(false); }
       virtual void diag_RH()                                   { assert(false); }
@@ -67,7 +113,34 @@ namespace libcloudphxx
       virtual void diag_kappa_rng(const real_t&, const real_t&)     { assert(false); }
       virtual void diag_max_rw()                                    { assert(false); }
       virtual void diag_vel_div()                                   { assert(false); }
+      virtual void diag_sstp_coal()                                 { assert(false); }
+      // accumulated rainfall etc. (in MPI runs: collective, summed over all ranks)
       virtual std::map<output_t, real_t> diag_puddle()              { assert(false); }
+
+      // condensation solver iteration statistics accumulated over the last timestep
+      virtual cond_stats_t diag_cond_stats()                        { assert(false); return cond_stats_t(); }
+
+      // resolution and interpolation error of the tabulated collision kernel (opts_init.tab_kernel)
+      virtual kernel_tab_info_t diag_kernel_tab()                   { assert(false); return kernel_tab_info_t(); }
+
+      // resolution and interpolation error of the terminal velocity table (opts_init.tab_vterm)
+      virtual vt_tab_info_t diag_vt_tab()                           { assert(false); return vt_tab_info_t(); }
+
+      // memory held by the temporaries and peak usage per stage of the timestep
+      virtual workspace_info_t diag_workspace()                     { assert(false); return workspace_info_t(); }
+
+      // computes all the moments requested in one pass over the particles; returns 
+      // pointers to n_cell-long buffers, one per requested moment, in order of the requests
+      // (valid until the next call)
+      virtual std::vector<real_t*> diag_moms(
+        const std::vector<moms_req_t<real_t> > &
+      )                                                             { assert(false); return std::vector<real_t*>(); }
+
+      // totals over the whole domain (sums over all SDs of n times the attribute to the given power)
+      // of the moments requested as in diag_moms(), in order of the requests (in MPI runs: collective)
+      virtual std::vector<real_t> diag_moms_tot(
+        const std::vector<moms_req_t<real_t> > &
+      )                                                             { assert(false); return std::vector<real_t>(); }
       virtual real_t *outbuf()                                      { assert(false); return NULL; }
 
       // storing a pointer to opts_init (e.g. for interrogatin about
@@ -93,6 +166,21 @@ namespace libcloudphxx
         const arrinfo_t<real_t> courant_z,
         const std::map<enum chem_species_t, const arrinfo_t<real_t> > ambient_chem
       );
+      void restore(
+        const std::string &path,
+        const arrinfo_t<real_t> th,
+        const arrinfo_t<real_t> rv,
+        const arrinfo_t<real_t> rhod,
+        const arrinfo_t<real_t> courant_x,
+        const arrinfo_t<real_t> courant_y, 
+        const arrinfo_t<real_t> courant_z,
+        const std::map<enum chem_species_t, const arrinfo_t<real_t> > ambient_chem
+      );
+      void checkpoint(const std::string &path);
+      void snapshot_open(const std::string &path, const snapshot_opts_t &);
+      void snapshot();
+      void snapshot_close();
+
       // time-stepping methods
       void step_sync(
         const opts_t<real_t> &,
@@ -108,6 +196,11 @@ namespace libcloudphxx
       void step_async(
         const opts_t<real_t> &
       );
+      void step_async_begin(
+        const opts_t<real_t> &
+      );
+      void step_async_wait();
+      bool step_async_pending();
 
       // diagnostic methods
       void diag_sd_conc();
@@ -134,7 +227,14 @@ namespace libcloudphxx
       void diag_kappa(const int&);
       void diag_max_rw();
       void diag_vel_div();
+      void diag_sstp_coal();
       std::map<output_t, real_t> diag_puddle();
+      cond_stats_t diag_cond_stats();
+      kernel_tab_info_t diag_kernel_tab();
+      vt_tab_info_t diag_vt_tab();
+      workspace_info_t diag_workspace();
+      std::vector<real_t*> diag_moms(const std::vector<moms_req_t<real_t> > &);
+      std::vector<real_t> diag_moms_tot(const std::vector<moms_req_t<real_t> > &);
       real_t *outbuf();
 
       struct impl;
@@ -166,6 +266,20 @@ namespace libcloudphxx
         const arrinfo_t<real_t> courant_z = arrinfo_t<real_t>(),
         const std::map<enum chem_species_t, const arrinfo_t<real_t> > ambient_chem = std::map<enum chem_species_t, const arrinfo_t<real_t> >()
       );
+      void restore(
+        const std::string &path,
+        const arrinfo_t<real_t> th,
+        const arrinfo_t<real_t> rv,
+        const arrinfo_t<real_t> rhod,
+        const arrinfo_t<real_t> courant_x = arrinfo_t<real_t>(),
+        const arrinfo_t<real_t> courant_y = arrinfo_t<real_t>(), 
+        const arrinfo_t<real_t> courant_z = arrinfo_t<real_t>(),
+        const std::map<enum chem_species_t, const arrinfo_t<real_t> > ambient_chem = std::map<enum chem_species_t, const arrinfo_t<real_t> >()
+      );
+      void checkpoint(const std::string &path);
+      void snapshot_open(const std::string &path, const snapshot_opts_t &);
+      void snapshot();
+      void snapshot_close();
 
       // time-stepping methods
       void step_sync(
@@ -181,6 +295,105 @@ namespace libcloudphxx
       void step_async(
         const opts_t<real_t> &
       );
+      void step_async_begin(
+        const opts_t<real_t> &
+      );
+      void step_async_wait();
+      bool step_async_pending();
+
+      // diagnostic methods
+      void diag_sd_conc();
+      void diag_RH();
+      void diag_dry_rng(
+        const real_t &r_mi, const real_t &r_mx
+      );
+      void diag_wet_rng(
+        const real_t &r_mi, const real_t &r_mx
+      );
+      void diag_dry_mom(const int &k);
+      void diag_wet_mom(const int &k);
+      void diag_wet_mass_dens(const real_t&, const real_t&);
+      real_t *outbuf();
+
+      void diag_chem(const enum chem_species_t&);
+      void diag_rw_ge_rc();
+      void diag_RH_ge_Sc();
+      void diag_all();
+      void diag_precip_rate();
+      void diag_max_rw();
+      void diag_vel_div();
+      void diag_sstp_coal();
+      std::map<output_t, real_t> diag_puddle();
+      cond_stats_t diag_cond_stats();
+      kernel_tab_info_t diag_kernel_tab();
+      vt_tab_info_t diag_vt_tab();
+      workspace_info_t diag_workspace();
+      std::vector<real_t*> diag_moms(const std::vector<moms_req_t<real_t> > &);
+      std::vector<real_t> diag_moms_tot(const std::vector<moms_req_t<real_t> > &);
+
+      struct impl;
+      std::unique_ptr<impl> pimpl;
+
+      // constructors
+      particles_t(const opts_init_t<real_t> &opts_init);
+
+      // dtor
+      ~particles_t();
+
+      // helper typedef
+      typedef particles_proto_t<real_t> parent_t;
+    };
+
+    // specialization for the multi_OpenMP backend (x-slabs of the domain handled by
+    // separate OpenMP instances, e.g. one per NUMA node, opts_init.dev_count of them)
+    // the interface is the same as for other backends (above)
+    template <typename real_t>
+    struct particles_t<real_t, multi_OpenMP>: particles_proto_t<real_t>
+    {
+      // initialisation 
+      void init(
+        const arrinfo_t<real_t> th,
+        const arrinfo_t<real_t> rv,
+        const arrinfo_t<real_t> rhod,
+        const arrinfo_t<real_t> courant_x = arrinfo_t<real_t>(),
+        const arrinfo_t<real_t> courant_y = arrinfo_t<real_t>(), 
+        const arrinfo_t<real_t> courant_z = arrinfo_t<real_t>(),
+        const std::map<enum chem_species_t, const arrinfo_t<real_t> > ambient_chem = std::map<enum chem_species_t, const arrinfo_t<real_t> >()
+      );
+      void restore(
+        const std::string &path,
+        const arrinfo_t<real_t> th,
+        const arrinfo_t<real_t> rv,
+        const arrinfo_t<real_t> rhod,
+        const arrinfo_t<real_t> courant_x = arrinfo_t<real_t>(),
+        const arrinfo_t<real_t> courant_y = arrinfo_t<real_t>(), 
+        const arrinfo_t<real_t> courant_z = arrinfo_t<real_t>(),
+        const std::map<enum chem_species_t, const arrinfo_t<real_t> > ambient_chem = std::map<enum chem_species_t, const arrinfo_t<real_t> >()
+      );
+      void checkpoint(const std::string &path);
+      void snapshot_open(const std::string &path, const snapshot_opts_t &);
+      void snapshot();
+      void snapshot_close();
+
+      // time-stepping methods
+      void step_sync(
+        const opts_t<real_t> &,
+        arrinfo_t<real_t> th,
+        arrinfo_t<real_t> rv,
+        const arrinfo_t<real_t> rhod      = arrinfo_t<real_t>(),
+        const arrinfo_t<real_t> courant_x = arrinfo_t<real_t>(),
+        const arrinfo_t<real_t> courant_y = arrinfo_t<real_t>(),
+        const arrinfo_t<real_t> courant_z = arrinfo_t<real_t>(),
+        std::map<enum chem_species_t, arrinfo_t<real_t> > ambient_chem = std::map<enum chem_species_t, arrinfo_t<real_t> >()
+      );
+      void step_async(
+        const opts_t<real_t> &
+      );
+      void step_async_begin(
+        const opts_t<real_t> &
+      );
+      void step_async_wait();
+      bool step_async_pending();
 
       // diagnostic methods
       void diag_sd_conc();
@@ -203,7 +416,14 @@ namespace libcloudphxx
       void diag_precip_rate();
       void diag_max_rw();
       void diag_vel_div();
+      void diag_sstp_coal();
       std::map<output_t, real_t> diag_puddle();
+      cond_stats_t diag_cond_stats();
+      kernel_tab_info_t diag_kernel_tab();
+      vt_tab_info_t diag_vt_tab();
+      workspace_info_t diag_workspace();
+      std::vector<real_t*> diag_moms(const std::vector<moms_req_t<real_t> > &);
+      std::vector<real_t> diag_moms_tot(const std::vector<moms_req_t<real_t> > &);
 
       struct impl;
       std::unique_ptr<impl> pimpl;
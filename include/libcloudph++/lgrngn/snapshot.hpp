@@ -0,0 +1,44 @@
+/** @file
+  * @copyright University of Warsaw
+  * @brief Definition of options of the streaming output of super-droplet attributes
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  */
+
+#pragma once
+
+#include <vector>
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace snap_attr_t //separate namespace to avoid member name conflicts with other enumerators, TODO: in c++11 change it to an enum class
+    {
+//<listing>
+      enum snap_attr_t { x, y, z, rd3, rw2, kpa, n, chem }; // chem: mass of all chem_all species
+//</listing>
+    };
+
+//<listing>
+    struct snapshot_opts_t
+    {
+      // attributes written, in the given order
+      std::vector<snap_attr_t::snap_attr_t> attrs;
+
+      // every sd_stride-th super-droplet is written
+      int sd_stride;
+
+      // every stp_stride-th call to snapshot() writes a record (e.g. calling snapshot()
+      // after each step_async() with stp_stride=10 gives a record every 10 timesteps)
+      int stp_stride;
+//</listing>
+
+      // ctor with defaults (all SDs, multiplicities and wet radii, every call)
+      snapshot_opts_t() :
+        attrs({snap_attr_t::n, snap_attr_t::rw2}),
+        sd_stride(1), stp_stride(1)
+      {}
+    };
+  };
+};
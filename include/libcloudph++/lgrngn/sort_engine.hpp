@@ -0,0 +1,14 @@
+#pragma once 
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace sort_t //separate namespace to avoid member name conflicts with other enumerators, TODO: in c++11 change it to an enum class
+    {   
+//<listing>
+      enum sort_t { full, incremental }; 
+//</listing>
+    }; 
+  };
+};
@@ -10,5 +10,14 @@ namespace libcloudphxx
       enum vt_t { undefined, beard76, beard77, beard77fast, khvorostyanov_spherical, khvorostyanov_nonspherical }; 
 //</listing>
     }; 
+
+    // resolution and accuracy of the terminal velocity table (opts_init.tab_vterm)
+    struct vt_tab_info_t
+    {
+      int n_r, n_T, n_rhod; // number of grid points in ln(r), T and ln(rhod) (0 if velocities are not tabulated)
+      double err_rel;       // max relative difference between the tabulated and exact velocity at the centres of table cells
+
+      vt_tab_info_t() : n_r(0), n_T(0), n_rhod(0), err_rel(0) {}
+    };
   };
 };
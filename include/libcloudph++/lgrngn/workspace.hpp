@@ -0,0 +1,34 @@
+/** @file
+  * @copyright University of Warsaw
+  * @brief Memory usage of the temporary storage for per-particle and per-cell computations
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  */
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    // temporaries are allocated once for n_sd_max super-droplets; the per-particle and per-cell
+    // ones are resident, the scoped ones are leased from pools and accounted for when leased
+    struct workspace_info_t
+    {
+      std::size_t
+        reserved_bytes, // memory held by all temporaries (device and host memory for the CUDA backend)
+        resident_bytes, // current size of the per-particle and per-cell temporaries (follows n_part)
+        n_alloc;        // number of times a temporary had to grow beyond what was reserved at init()
+
+      // maximal number of bytes of temporaries in use during each stage (e.g. "coal", "src"):
+      // the resident ones at the n_part of the stage plus those leased from the pools
+      std::map<std::string, std::size_t> peak_bytes;
+
+      workspace_info_t() : reserved_bytes(0), resident_bytes(0), n_alloc(0) {}
+    };
+  };
+};
@@ -5,10 +5,6 @@
 
 #include <libcloudph++/lgrngn/factory.hpp>
 
-#if defined(STD_FUTURE_WORKS)
-#  include <future>
-#endif
-
 // @brief a minimalistic kinematic cloud model with lagrangian microphysics
 //        built on top of the mpdata_2d solver (by extending it with
 //        custom hook_ante_loop() and hook_post_step() methods)
@@ -48,49 +44,63 @@ class kin_cloud_2d_lgrngn : public kin_cloud_2d_common<ct_params_t>
     this->f_puddle << "\n";
 
    
-    // recording requested statistical moments
+    // recording requested statistical moments (all computed in one pass)
     {
+      using libcloudphxx::lgrngn::moms_req_t;
+      namespace attr_t = libcloudphxx::lgrngn::attr_t;
+
+      std::vector<moms_req_t<real_t>> reqs;
+      std::vector<std::string> names;
+
       // dry
       int rng_num = 0;
-
       for (auto &rng_moms : params.out_dry)
       {
-        auto &rng(rng_moms.first);
-        prtcls->diag_dry_rng(rng.first / si::metres, rng.second / si::metres);
-        for (auto &mom : rng_moms.second)
-        {
-          prtcls->diag_dry_mom(mom);
-          this->record_aux(aux_name("rd", rng_num, mom), prtcls->outbuf());
-        }
+        moms_req_t<real_t> req;
+        req.rng_attr = attr_t::rd;
+        req.rng_min = rng_moms.first.first / si::metres;
+        req.rng_max = rng_moms.first.second / si::metres;
+        req.mom_attr = attr_t::rd;
+        req.moms = rng_moms.second;
+        reqs.push_back(req);
+        for (auto &mom : rng_moms.second) names.push_back(aux_name("rd", rng_num, mom));
         rng_num++;
       }
-    }
-    {
+
       // wet
-      int rng_num = 0;
+      rng_num = 0;
       for (auto &rng_moms : params.out_wet)
       {
-        auto &rng(rng_moms.first);
-        prtcls->diag_wet_rng(rng.first / si::metres, rng.second / si::metres);
-        for (auto &mom : rng_moms.second)
-        {
-          prtcls->diag_wet_mom(mom);
-          this->record_aux(aux_name("rw", rng_num, mom), prtcls->outbuf());
-        }
+        moms_req_t<real_t> req;
+        req.rng_attr = attr_t::rw;
+        req.rng_min = rng_moms.first.first / si::metres;
+        req.rng_max = rng_moms.first.second / si::metres;
+        req.mom_attr = attr_t::rw;
+        req.moms = rng_moms.second;
+        reqs.push_back(req);
+        for (auto &mom : rng_moms.second) names.push_back(aux_name("rw", rng_num, mom));
         rng_num++;
       }
-    }
-    {
+
       // rw3(rd)
-      int rng_num = 0;
+      rng_num = 0;
       for (auto &rng_moms : params.out_dry)
       {
-        auto &rng(rng_moms.first);
-        prtcls->diag_dry_rng(rng.first / si::metres, rng.second / si::metres);
-        prtcls->diag_wet_mom(3);
-        this->record_aux(aux_name("rw3ofrd", rng_num, 3), prtcls->outbuf());
+        moms_req_t<real_t> req;
+        req.rng_attr = attr_t::rd;
+        req.rng_min = rng_moms.first.first / si::metres;
+        req.rng_max = rng_moms.first.second / si::metres;
+        req.mom_attr = attr_t::rw;
+        req.moms = std::vector<int>(1, 3);
+        reqs.push_back(req);
+        names.push_back(aux_name("rw3ofrd", rng_num, 3));
         rng_num++;
       }
+
+      auto bufs = prtcls->diag_moms(reqs);
+      assert(bufs.size() == names.size());
+      for (std::size_t i = 0; i < bufs.size(); ++i)
+        this->record_aux(names[i], bufs[i]);
     }
   } 
 
@@ -210,10 +220,6 @@ class kin_cloud_2d_lgrngn : public kin_cloud_2d_common<ct_params_t>
     // TODO: barrier?
   }
 
-#if defined(STD_FUTURE_WORKS)
-  std::future<void> ftr;
-#endif
-
   // 
   void hook_post_step()
   {
@@ -223,18 +229,7 @@ class kin_cloud_2d_lgrngn : public kin_cloud_2d_common<ct_params_t>
 
     if (this->rank == 0) 
     {
-      // assuring previous async step finished ...
-#if defined(STD_FUTURE_WORKS)
-      if (
-        params.async && 
-        this->timestep != 0 && // ... but not in first timestep ...
-        ((this->timestep - 1) % this->outfreq != 0) // ... and not after diag call
-        //!((this->timestep-1) == 0 || ((this->timestep-1) % this->outfreq == 0 && (this->timestep-1) >= this->spinup)) // .. and not after diag
-      ) {
-        assert(ftr.valid());
-        ftr.get();
-      } else assert(!ftr.valid());
-#endif
+      // note: step_sync() waits for the async step started in the previous timestep
 
       // running synchronous stuff
       prtcls->step_sync(
@@ -245,32 +240,13 @@ class kin_cloud_2d_lgrngn : public kin_cloud_2d_common<ct_params_t>
 
       // running asynchronous stuff
       {
-        using libcloudphxx::lgrngn::particles_t;
         using libcloudphxx::lgrngn::CUDA;
         using libcloudphxx::lgrngn::multi_CUDA;
 
-#if defined(STD_FUTURE_WORKS)
-        if (params.async)
-        {
-          assert(!ftr.valid());
-
-          if(params.backend == multi_CUDA)
-            ftr = std::async(
-              std::launch::async, 
-              &particles_t<real_t, multi_CUDA>::step_async, 
-              dynamic_cast<particles_t<real_t, multi_CUDA>*>(prtcls.get()),
-              params.cloudph_opts
-            );
-          else if(params.backend == CUDA)
-            ftr = std::async(
-              std::launch::async, 
-              &particles_t<real_t, CUDA>::step_async, 
-              dynamic_cast<particles_t<real_t, CUDA>*>(prtcls.get()),
-              params.cloudph_opts
-            );
-          assert(ftr.valid());
-        } else 
-#endif
+        // overlapping GPU microphysics with CPU advection
+        if (params.async && (params.backend == CUDA || params.backend == multi_CUDA))
+          prtcls->step_async_begin(params.cloudph_opts);
+        else
           prtcls->step_async(params.cloudph_opts);
       }
 
@@ -278,13 +254,7 @@ class kin_cloud_2d_lgrngn : public kin_cloud_2d_common<ct_params_t>
       //if (this->timestep == 0 || (this->timestep % this->outfreq == 0 && this->timestep >= this->spinup))
       if (this->timestep % this->outfreq == 0) 
       { 
-#if defined(STD_FUTURE_WORKS)
-        if (params.async)
-        {
-          assert(ftr.valid());
-          ftr.get();
-        }
-#endif
+        prtcls->step_async_wait();
         diag();
       }
     }
@@ -212,10 +212,6 @@ class kin_cloud_2d_lgrngn_chem : public kin_cloud_2d_lgrngn<ct_params_t>
     // TODO: barrier?
   }
 
-#if defined(STD_FUTURE_WORKS)
-//  std::future<real_t> this->ftr;
-#endif
-
   // 
   void hook_post_step()
   {
@@ -225,18 +221,7 @@ class kin_cloud_2d_lgrngn_chem : public kin_cloud_2d_lgrngn<ct_params_t>
 
     if (this->rank == 0) 
     {
-      // assuring previous async step finished ...
-#if defined(STD_FUTURE_WORKS)
-      if (
-        parent_t::params.async && 
-        this->timestep != 0 && // ... but not in first timestep ...
-        //!((this->timestep-1) == 0 || ((this->timestep-1) % this->outfreq == 0 && (this->timestep-1) >= this->spinup)) 
-        ((this->timestep - 1) % this->outfreq != 0)
-      ) {
-        assert(this->ftr.valid());
-        this->ftr.get();
-      } else assert(!this->ftr.valid());
-#endif
+      // note: step_sync() waits for the async step started in the previous timestep
 
       assert(parent_t::params.cloudph_opts_init.chem_switch == true);
 
@@ -263,32 +248,13 @@ class kin_cloud_2d_lgrngn_chem : public kin_cloud_2d_lgrngn<ct_params_t>
 
       // running asynchronous stuff
       {
-        using libcloudphxx::lgrngn::particles_t;
         using libcloudphxx::lgrngn::CUDA;
         using libcloudphxx::lgrngn::multi_CUDA;
 
-#if defined(STD_FUTURE_WORKS)
-        if (parent_t::params.async)
-        {
-          assert(!this->ftr.valid());
-
-          if(parent_t::params.backend == multi_CUDA)
-            this->ftr = std::async(
-              std::launch::async, 
-              &particles_t<real_t, multi_CUDA>::step_async, 
-              dynamic_cast<particles_t<real_t, multi_CUDA>*>(parent_t::prtcls.get()),
-              parent_t::params.cloudph_opts
-            );
-          else if(parent_t::params.backend == CUDA)
-            this->ftr = std::async(
-              std::launch::async, 
-              &particles_t<real_t, CUDA>::step_async, 
-              dynamic_cast<particles_t<real_t, CUDA>*>(parent_t::prtcls.get()),
-              parent_t::params.cloudph_opts
-            );
-          assert(this->ftr.valid());
-        } else 
-#endif
+        // overlapping GPU microphysics with CPU advection
+        if (parent_t::params.async && (parent_t::params.backend == CUDA || parent_t::params.backend == multi_CUDA))
+          parent_t::prtcls->step_async_begin(parent_t::params.cloudph_opts);
+        else
           parent_t::prtcls->step_async(parent_t::params.cloudph_opts);
       }
 
@@ -296,13 +262,7 @@ class kin_cloud_2d_lgrngn_chem : public kin_cloud_2d_lgrngn<ct_params_t>
       //if (this->timestep == 0 || (this->timestep % this->outfreq == 0 && this->timestep >= this->spinup)) 
       if (this->timestep % this->outfreq == 0)
       { 
-#if defined(STD_FUTURE_WORKS)
-        if (parent_t::params.async)
-        {
-          assert(this->ftr.valid());
-          this->ftr.get();
-        }
-#endif
+        parent_t::prtcls->step_async_wait();
         parent_t::diag();
         diag_chem();
         diag_pH();
@@ -233,8 +233,8 @@ void setopts_micro(
 {
   po::options_description opts("Lagrangian microphysics options"); 
   opts.add_options()
-    ("backend", po::value<std::string>()->required() , "one of: CUDA, OpenMP, serial")
-    ("async", po::value<bool>()->default_value(true), "use CPU for advection while GPU does micro (ignored if backend != CUDA)")
+    ("backend", po::value<std::string>()->required() , "one of: CUDA, multi_CUDA, OpenMP, multi_OpenMP, serial")
+    ("async", po::value<bool>()->default_value(true), "use CPU for advection while GPU does micro (ignored if backend is neither CUDA nor multi_CUDA)")
     ("sd_conc", po::value<unsigned long long>()->required() , "super-droplet number per grid cell (unsigned long long)")
     // processes
     ("adve", po::value<bool>()->default_value(rt_params.cloudph_opts.adve) , "particle advection     (1=on, 0=off)")
@@ -271,6 +271,7 @@ void setopts_micro(
   else if (backend_str == "OpenMP") rt_params.backend = libcloudphxx::lgrngn::OpenMP;
   else if (backend_str == "serial") rt_params.backend = libcloudphxx::lgrngn::serial;
   else if (backend_str == "multi_CUDA") rt_params.backend = libcloudphxx::lgrngn::multi_CUDA;
+  else if (backend_str == "multi_OpenMP") rt_params.backend = libcloudphxx::lgrngn::multi_OpenMP;
 
   rt_params.async = vm["async"].as<bool>();
 
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      // a single host thread executing one job at a time (started on first use);
+      // submitting a job while the previous one is still running blocks the caller,
+      // exceptions thrown by a job are rethrown by the next wait() or submit()
+      class async_worker
+      {
+        std::thread thread;
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::function<void()> job;
+        std::exception_ptr error;
+        bool busy, quit;
+
+        void loop()
+        {
+          std::unique_lock<std::mutex> lk(mtx);
+          while (true)
+          {
+            cv.wait(lk, [this]{ return quit || bool(job); });
+            if (!job) return;
+
+            std::function<void()> todo;
+            todo.swap(job);
+            lk.unlock();
+
+            std::exception_ptr err;
+            try { todo(); }
+            catch (...) { err = std::current_exception(); }
+
+            lk.lock();
+            error = err;
+            busy = false;
+            cv.notify_all();
+          }
+        }
+
+        void wait(std::unique_lock<std::mutex> &lk)
+        {
+          cv.wait(lk, [this]{ return !busy; });
+          if (error)
+          {
+            std::exception_ptr err = error;
+            error = nullptr;
+            std::rethrow_exception(err);
+          }
+        }
+
+        public:
+
+        async_worker() : busy(false), quit(false) {}
+
+        // enqueues fun after the previous job (if any) completed
+        void submit(const std::function<void()> &fun)
+        {
+          std::unique_lock<std::mutex> lk(mtx);
+          wait(lk);
+          if (!thread.joinable()) thread = std::thread(&async_worker::loop, this);
+          job = fun;
+          busy = true;
+          cv.notify_all();
+        }
+
+        // blocks until the submitted job (if any) completed
+        void wait()
+        {
+          std::unique_lock<std::mutex> lk(mtx);
+          wait(lk);
+        }
+
+        bool pending()
+        {
+          std::lock_guard<std::mutex> lk(mtx);
+          return busy;
+        }
+
+        // waits for the current job (discarding its exceptions) and joins the thread
+        void stop()
+        {
+          {
+            std::unique_lock<std::mutex> lk(mtx);
+            cv.wait(lk, [this]{ return !busy; });
+            error = nullptr;
+            quit = true;
+            cv.notify_all();
+          }
+          if (thread.joinable()) thread.join();
+        }
+
+        ~async_worker() { stop(); }
+      };
+    };
+  };
+};
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <thrust/host_vector.h>
+
+// binary checkpoint files with the complete state of the particles:
+//
+//   ckpt_header_t                    (fixed size, at offset 0)
+//   data sections                    (each starting at a multiple of ckpt_align)
+//   ckpt_section_t x n_sections      (table of contents, at toc_offset)
+//
+// all data are stored raw in host byte order, so that a section can be
+// read in bulk or mmap()-ed directly using the offset from the table of contents
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      const char ckpt_magic[8] = {'L', 'C', 'P', 'P', 'C', 'K', 'P', 'T'};
+      const std::uint32_t ckpt_version = 2; // 2: persistent SD ids (sd_id, sd_id_ctr), Newton warm start (cond_drw2_dt)
+      const std::uint32_t ckpt_endian = 0x01020304;
+      const std::uint64_t ckpt_align = 64;
+
+      struct ckpt_header_t
+      {
+        char magic[8];
+        std::uint32_t version, endian, real_size, n_t_size;
+        std::int64_t nx, ny, nz, n_cell, n_part;
+        std::uint64_t rng_ctr, stp_ctr;
+        std::int64_t reorder_ctr, sstp_coal;
+        std::uint32_t sorted, presorted;
+        std::uint64_t toc_offset, n_sections;
+      };
+
+      struct ckpt_section_t
+      {
+        char name[24];
+        std::uint64_t offset, bytes;
+      };
+
+      class ckpt_writer
+      {
+        const std::string path, tmp_path;
+        std::ofstream file;
+        std::vector<ckpt_section_t> toc;
+
+        void pad()
+        {
+          const std::uint64_t pos = file.tellp();
+          const std::uint64_t len = (ckpt_align - pos % ckpt_align) % ckpt_align;
+          const char zeros[ckpt_align] = {};
+          file.write(zeros, len);
+        }
+
+        void check()
+        {
+          if (!file) throw std::runtime_error(detail::formatter() << "error writing checkpoint file " << tmp_path);
+        }
+
+        public:
+
+        // written to a temporary file renamed in close(), so that an interrupted
+        // checkpoint never leaves a truncated file under the target path
+        ckpt_writer(const std::string &path) :
+          path(path),
+          tmp_path(path + ".tmp"),
+          file(tmp_path.c_str(), std::ios::binary | std::ios::trunc)
+        {
+          check();
+          ckpt_header_t hdr = ckpt_header_t(); // placeholder, see close()
+          file.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+          check();
+        }
+
+        void write_bytes(const std::string &name, const void *data, const std::uint64_t bytes)
+        {
+          assert(name.size() < sizeof(ckpt_section_t().name));
+          pad();
+          ckpt_section_t sec = ckpt_section_t();
+          std::strncpy(sec.name, name.c_str(), sizeof(sec.name) - 1);
+          sec.offset = file.tellp();
+          sec.bytes = bytes;
+          file.write(reinterpret_cast<const char*>(data), bytes);
+          check();
+          toc.push_back(sec);
+        }
+
+        template <class vec_t>
+        void write(const std::string &name, const vec_t &vec)
+        {
+          typedef typename vec_t::value_type T;
+#if defined(__NVCC__)
+          // staging through host memory, one vector at a time
+          const thrust::host_vector<T> tmp(vec);
+          write_bytes(name, thrust::raw_pointer_cast(tmp.data()), tmp.size() * sizeof(T));
+#else
+          write_bytes(name, thrust::raw_pointer_cast(vec.data()), vec.size() * sizeof(T));
+#endif
+        }
+
+        void close(ckpt_header_t hdr)
+        {
+          std::memcpy(hdr.magic, ckpt_magic, sizeof(ckpt_magic));
+          hdr.version = ckpt_version;
+          hdr.endian = ckpt_endian;
+
+          pad();
+          hdr.toc_offset = file.tellp();
+          hdr.n_sections = toc.size();
+          file.write(reinterpret_cast<const char*>(toc.data()), toc.size() * sizeof(ckpt_section_t));
+          file.seekp(0);
+          file.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+          file.close();
+          check();
+
+          if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+            throw std::runtime_error(detail::formatter() << "could not rename " << tmp_path << " to " << path);
+        }
+      };
+
+      class ckpt_reader
+      {
+        const std::string path;
+        std::ifstream file;
+        std::vector<ckpt_section_t> toc;
+
+        void check()
+        {
+          if (!file) throw std::runtime_error(detail::formatter() << "error reading checkpoint file " << path);
+        }
+
+        const ckpt_section_t &find(const std::string &name) const
+        {
+          for (std::size_t i = 0; i < toc.size(); ++i)
+            if (name == toc[i].name) return toc[i];
+          throw std::runtime_error(detail::formatter() << "section " << name << " not found in checkpoint file " << path);
+        }
+
+        public:
+
+        ckpt_header_t hdr;
+
+        ckpt_reader(const std::string &path) :
+          path(path),
+          file(path.c_str(), std::ios::binary)
+        {
+          if (!file) throw std::runtime_error(detail::formatter() << "could not open checkpoint file " << path);
+          file.read(reinterpret_cast<char*>(&hdr), sizeof(hdr));
+          check();
+
+          if (std::memcmp(hdr.magic, ckpt_magic, sizeof(ckpt_magic)) != 0)
+            throw std::runtime_error(detail::formatter() << path << " is not a libcloudph++ checkpoint file");
+          if (hdr.version != ckpt_version)
+            throw std::runtime_error(detail::formatter() << "checkpoint file " << path << " has version " << hdr.version << ", expected " << ckpt_version);
+          if (hdr.endian != ckpt_endian)
+            throw std::runtime_error(detail::formatter() << "checkpoint file " << path << " was written on a machine with different byte order");
+
+          toc.resize(hdr.n_sections);
+          file.seekg(hdr.toc_offset);
+          file.read(reinterpret_cast<char*>(toc.data()), toc.size() * sizeof(ckpt_section_t));
+          check();
+        }
+
+        void read_bytes(const std::string &name, void *data, const std::uint64_t bytes)
+        {
+          const ckpt_section_t &sec(find(name));
+          if (sec.bytes != bytes)
+            throw std::runtime_error(detail::formatter() << "size of section " << name << " in checkpoint file " << path << " is " << sec.bytes << " bytes, expected " << bytes);
+          file.seekg(sec.offset);
+          file.read(reinterpret_cast<char*>(data), bytes);
+          check();
+        }
+
+        // vec resized to the length stored in the file
+        template <class vec_t>
+        void read(const std::string &name, vec_t &vec)
+        {
+          typedef typename vec_t::value_type T;
+          const std::uint64_t bytes = find(name).bytes;
+          if (bytes % sizeof(T) != 0)
+            throw std::runtime_error(detail::formatter() << "size of section " << name << " in checkpoint file " << path << " is not a multiple of the element size");
+          read(name, vec, bytes / sizeof(T));
+        }
+
+        // vec resized to the expected length n, which has to match the one stored in the file
+        template <class vec_t>
+        void read(const std::string &name, vec_t &vec, const std::uint64_t n)
+        {
+          typedef typename vec_t::value_type T;
+          vec.resize(n);
+#if defined(__NVCC__)
+          thrust::host_vector<T> tmp(n);
+          read_bytes(name, thrust::raw_pointer_cast(tmp.data()), n * sizeof(T));
+          thrust::copy(tmp.begin(), tmp.end(), vec.begin());
+#else
+          read_bytes(name, thrust::raw_pointer_cast(vec.data()), n * sizeof(T));
+#endif
+        }
+      };
+    };
+  };
+};
@@ -24,9 +24,20 @@ namespace libcloudphxx
                      rd_max_init = 1e-3;   // bounding values for the initial dry radius distro
         const int bfr_fraction = 2;      // in/out buffers size = ny * nz * n_sd_max / bfr_fraction
         const real_t cond_mlt = 2.;      // arbitrary multiplier that defines range over which equilibrium radius is searched during condensation
+        const unsigned int cond_newton_n_iter = 10;     // max number of Newton iterations before falling back to toms748
+        const unsigned int cond_fallback_flag = 1 << 16; // added to the per-particle iteration count to mark a toms748 fallback
+        const real_t cond_sstp_rel_drw2 = .01; // max relative change in rw2 within one condensation substep in adaptive substepping
+        const real_t kernel_tab_long_r_max = 1e-4; // upper limit of the Long kernel table, its multiplier is 1 for r > 50um
+        const int kernel_tab_err_sub = 4; // the error of the kernel table is estimated at this many points per table interval (in each direction) over the whole table
+        const real_t coal_prob_max = 1;  // max probability of collision of a pair within one coalescence substep in adaptive substepping
         const int vt0_n_bin = 10000;     // number of bins to cache terminal velocity in beard77fast case
-        // range of beard77fast bins:
+        const real_t sort_incremental_max = .5; // incremental sort falls back to full sort if a larger fraction of SDs changed cell
+        // range of beard77fast bins (also the radius range of the tab_vterm table):
         const real_t vt0_ln_r_min, vt0_ln_r_max;
+        // resolution and range of the tab_vterm table in ln(r), T and ln(rhod)
+        const int vt_tab_n_r = 256, vt_tab_n_T = 14, vt_tab_n_rhod = 16;
+        const real_t vt_tab_T_min = 200, vt_tab_T_max = 330,   // [K]
+                     vt_tab_rhod_min = .05, vt_tab_rhod_max = 1.5; // [kg/m3]
 
         // ctor
         config():
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstdlib>
+#include <string>
+
+#if defined(USE_MPI)
+#  include <functional>
+#  include <memory>
+#  include <vector>
+#  include <mpi.h>
+#  include <thrust/host_vector.h>
+#  include "workspace.hpp"
+#endif
+
+// helpers for distributed-memory runs with one x-slab of the domain per MPI rank
+
+#if defined(USE_MPI)
+#  define mpiErrchk(ans) { detail::mpiAssert((ans), __FILE__, __LINE__); }
+#endif
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+#if defined(USE_MPI)
+      inline void mpiAssert(int code, const char *file, int line)
+      {
+        if (code != MPI_SUCCESS)
+        {
+          char msg[MPI_MAX_ERROR_STRING];
+          int len;
+          MPI_Error_string(code, msg, &len);
+          throw std::runtime_error(detail::formatter() << "MPI error: " << msg << " (" << file << ":" << line << ")");
+        }
+      }
+
+      // MPI datatypes corresponding to C++ types
+      template <typename T> MPI_Datatype mpi_type();
+      template <> inline MPI_Datatype mpi_type<float>()              { return MPI_FLOAT; }
+      template <> inline MPI_Datatype mpi_type<double>()             { return MPI_DOUBLE; }
+      template <> inline MPI_Datatype mpi_type<int>()                { return MPI_INT; }
+      template <> inline MPI_Datatype mpi_type<unsigned int>()       { return MPI_UNSIGNED; }
+      template <> inline MPI_Datatype mpi_type<unsigned long>()      { return MPI_UNSIGNED_LONG; }
+      template <> inline MPI_Datatype mpi_type<unsigned long long>() { return MPI_UNSIGNED_LONG_LONG; }
+
+      // MPI_Finalize() at exit, only if MPI was initialised by the library
+      inline void mpi_finalize()
+      {
+        int finalized;
+        MPI_Finalized(&finalized);
+        if (!finalized) MPI_Finalize();
+      }
+#endif
+
+      // number of tasks started by mpirun (1 if not started by it)
+      inline int mpi_env_size()
+      {
+        const char *env[] = {
+          "OMPI_COMM_WORLD_SIZE", // Open MPI
+          "PMI_SIZE"              // MPICH, Slurm
+        };
+        for (int e = 0; e < 2; ++e)
+        {
+          const char *val = std::getenv(env[e]);
+          if (val != NULL && std::atoi(val) > 1) return std::atoi(val);
+        }
+        return 1;
+      }
+
+      // rank and size of MPI_COMM_WORLD; MPI is initialised by the library only if it was not
+      // done by the caller and the process was started by mpirun with more than one task,
+      // otherwise (and if not compiled with MPI) rank=0 and size=1
+      inline void mpi_init(int &rank, int &size)
+      {
+        rank = 0;
+        size = 1;
+#if defined(USE_MPI)
+        int initialized;
+        mpiErrchk(MPI_Initialized(&initialized));
+        if (!initialized)
+        {
+          // a serial run (or a single task, e.g. mpirun -np 1) does not need MPI
+          if (mpi_env_size() < 2) return;
+
+          // step_async_begin() communicates from a worker thread
+          int provided;
+          mpiErrchk(MPI_Init_thread(NULL, NULL, MPI_THREAD_MULTIPLE, &provided));
+          std::atexit(mpi_finalize);
+        }
+        mpiErrchk(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+        mpiErrchk(MPI_Comm_size(MPI_COMM_WORLD, &size));
+#else
+        // each rank would silently simulate a separate periodic domain otherwise
+        const int env_size = mpi_env_size();
+        if (env_size > 1)
+          throw std::runtime_error(detail::formatter() << "mpirun environment with " << env_size << " ranks detected, but libcloudph++ was compiled without MPI support");
+#endif
+      }
+
+      // output files are written separately by each rank, with the rank appended to the path
+      inline std::string mpi_path(const std::string &path, const int &mpi_rank, const int &mpi_size)
+      {
+        return mpi_size > 1 ? path + "." + std::to_string(mpi_rank) : path;
+      }
+
+      // true if MPI calls may be made concurrently from multiple threads
+      inline bool mpi_thread_multiple()
+      {
+#if defined(USE_MPI)
+        int provided;
+        mpiErrchk(MPI_Query_thread(&provided));
+        return provided == MPI_THREAD_MULTIPLE;
+#else
+        return true;
+#endif
+      }
+
+#if defined(USE_MPI)
+      // transfers between neighbouring ranks posted by post() and completed all at once by wait(),
+      // so that local work can be done in between; all ranks post the same transfers (with dst and
+      // src being their neighbours along a ring); in CUDA builds the data is staged through host
+      // vectors leased from a pool and copied to the device by wait()
+      class mpi_xchng_t
+      {
+        std::vector<MPI_Request> req;
+        std::vector<std::function<void(const thrust_size_t &)> > unstage; // one per receive
+        std::vector<int> elem_size;
+
+        public:
+
+        bool pending() const { return !req.empty(); }
+
+        // n_snd elements of snd starting at snd_off are sent to rank dst, while up to n_rcv elements
+        // are received from rank src into rcv starting at rcv_off; snd must not be modified and rcv
+        // must not be read or resized until wait()
+        template <class vec_t>
+        void post(
+          const vec_t &snd, const thrust_size_t snd_off, const thrust_size_t n_snd, const int dst,
+          vec_t &rcv,       const thrust_size_t rcv_off, const thrust_size_t n_rcv, const int src,
+          const int tag,
+          tmp_pool<typename vec_t::value_type, thrust::host_vector<typename vec_t::value_type> > &host_pool
+        )
+        {
+          typedef typename vec_t::value_type T;
+#if defined(__NVCC__)
+          // CUDA-aware MPI is not assumed, staging through host memory
+          typedef typename tmp_pool<T, thrust::host_vector<T> >::lease lease_t;
+          std::shared_ptr<lease_t>
+            snd_h(new lease_t(host_pool.acquire(n_snd))),
+            rcv_h(new lease_t(host_pool.acquire(n_rcv)));
+          thrust::copy(snd.begin() + snd_off, snd.begin() + snd_off + n_snd, (**snd_h).begin());
+          T *snd_p = thrust::raw_pointer_cast((**snd_h).data());
+          T *rcv_p = thrust::raw_pointer_cast((**rcv_h).data());
+          unstage.push_back([snd_h, rcv_h, &rcv, rcv_off](const thrust_size_t &n) {
+            thrust::copy((**rcv_h).begin(), (**rcv_h).begin() + n, rcv.begin() + rcv_off);
+          });
+#else
+          T *snd_p = const_cast<T*>(thrust::raw_pointer_cast(snd.data())) + snd_off;
+          T *rcv_p = thrust::raw_pointer_cast(rcv.data()) + rcv_off;
+          unstage.push_back([](const thrust_size_t &) {});
+#endif
+          elem_size.push_back(sizeof(T));
+          req.push_back(MPI_Request());
+          mpiErrchk(MPI_Irecv(rcv_p, n_rcv, mpi_type<T>(), src, tag, MPI_COMM_WORLD, &req.back()));
+          req.push_back(MPI_Request());
+          mpiErrchk(MPI_Isend(snd_p, n_snd, mpi_type<T>(), dst, tag, MPI_COMM_WORLD, &req.back()));
+        }
+
+        // completes all the posted transfers, returns the number of elements received
+        // by each of them (in the order of posting)
+        std::vector<thrust_size_t> wait()
+        {
+          std::vector<MPI_Status> stat(req.size());
+          if (!req.empty())
+            mpiErrchk(MPI_Waitall(req.size(), req.data(), stat.data()));
+          req.clear();
+
+          std::vector<thrust_size_t> n_rcvd;
+          for (std::size_t r = 0; r < unstage.size(); ++r)
+          {
+            int bytes;
+            mpiErrchk(MPI_Get_count(&stat[2 * r], MPI_BYTE, &bytes));
+            n_rcvd.push_back(bytes / elem_size[r]);
+            unstage[r](n_rcvd.back());
+          }
+          unstage.clear();
+          elem_size.clear();
+          return n_rcvd;
+        }
+      };
+
+      // in-place sum over all ranks
+      template <typename T>
+      void mpi_allreduce_sum(T *buf, const int count)
+      {
+        mpiErrchk(MPI_Allreduce(MPI_IN_PLACE, buf, count, mpi_type<T>(), MPI_SUM, MPI_COMM_WORLD));
+      }
+#endif
+    };
+  };
+};
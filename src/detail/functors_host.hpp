@@ -9,6 +9,8 @@
 
 // TODO: place contents of ths function into files which use them (apparently, there's no reuse)
 
+#include <thrust/tuple.h>
+
 #include <libcloudph++/common/unary_function.hpp>
 
 namespace libcloudphxx
@@ -43,6 +45,37 @@ namespace libcloudphxx
           return true;
         } 
       }; 
+
+      // c_arr_get for three arrays sharing the index mapping
+      template <typename real_t>
+      struct c_arr_get3
+      {   
+        const real_t * const c_arr_a, * const c_arr_b, * const c_arr_c; // member fields
+        c_arr_get3(const real_t * const a, const real_t * const b, const real_t * const c) : 
+          c_arr_a(a), c_arr_b(b), c_arr_c(c) {} // ctor
+
+        // op invoked by transform
+        thrust::tuple<real_t, real_t, real_t> operator()(const thrust_size_t ix) 
+        { 
+          return thrust::make_tuple(c_arr_a[ix], c_arr_b[ix], c_arr_c[ix]); 
+        }
+      }; 
+
+      // c_arr_set for two arrays sharing the index mapping
+      template <typename real_t>
+      struct c_arr_set2
+      {   
+        real_t *c_arr_a, *c_arr_b; // member fields
+        c_arr_set2(real_t *a, real_t *b) : c_arr_a(a), c_arr_b(b) {} // ctor
+
+        // op invoked by transform
+        bool operator()(const thrust_size_t ix, const thrust::tuple<real_t, real_t> &val) 
+        { 
+          c_arr_a[ix] = thrust::get<0>(val); 
+          c_arr_b[ix] = thrust::get<1>(val); 
+          return true;
+        } 
+      }; 
     };
   };
 };
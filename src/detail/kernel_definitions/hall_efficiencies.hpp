@@ -5,17 +5,8 @@ namespace libcloudphxx
   {
     namespace detail
     {
-      template<class real_t>
-      real_t hall_r_max()
-      {
-        return 1100.;
-      }
-
-      template<class real_t>
-      void hall_efficiencies(std::vector<real_t> &vec)
-      {
-        //NVCC doesn't support extended initializer list. First make an array, then copy it to a vector.
-        const real_t arr[] = {
+      // lower triangle of the (R, r) efficiency matrix, cf. kernel_index() and kernel_vector_index()
+      const double hall_efficiencies[] = {
 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
       
 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
@@ -2046,9 +2037,8 @@ namespace libcloudphxx
       
 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
       
-1          };
-      vec = std::vector<real_t>(arr, arr + sizeof(arr) / sizeof(arr[0]) );
-      }
+1
+      };
     }
   }
 }
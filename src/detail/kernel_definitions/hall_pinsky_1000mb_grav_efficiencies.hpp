@@ -1,23 +1,13 @@
 #pragma once
-// Hall efficiencies for large drops and Pinsky 2001 1000mb efficiencies for r <= 21um
 namespace libcloudphxx
 {
   namespace lgrngn
   {
     namespace detail
     {
-      template<class real_t>
-      real_t hall_pinsky_1000mb_grav_r_max()
-      {
-        return 1100.;
-      }
-
       // Hall efficiencies for large drops and Pinsky 2001 1000mb efficiencies for r <= 21um
-      template<class real_t>
-      void hall_pinsky_1000mb_grav_efficiencies(std::vector<real_t> &vec)
-      {
-        //NVCC doesn't support extended initializer list. First make an array, then copy it to a vector.
-        const real_t arr[] = {
+      // lower triangle of the (R, r) efficiency matrix, cf. kernel_index() and kernel_vector_index()
+      const double hall_pinsky_1000mb_grav_efficiencies[] = {
 0, 0, 0, 0, 0.02, 0, 0, 0.0144, 0.0266, 0, 0, 0.0105, 0.0229, 0.0292, 0, 0, 0.0079, 0.019, 0.026, 0.0306, 
       
 0, 0, 0.0063, 0.0159, 0.0229, 0.0279, 0.0306, 0, 0, 0.0051, 0.0135, 0.0201, 0.0247, 0.0279, 0.0306, 0, 0, 0.004, 0.0113, 0.0174, 
@@ -2048,9 +2038,8 @@ namespace libcloudphxx
       
 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
       
-1          };
-      vec = std::vector<real_t>(arr, arr + sizeof(arr) / sizeof(arr[0]) );
-      }
+1
+      };
     }
   }
 }
@@ -5,17 +5,8 @@ namespace libcloudphxx
   {
     namespace detail
     {
-      template<class real_t>
-      real_t hall_pinsky_cumulonimbus_r_max()
-      {
-        return 1100.;
-      }
-
-      template<class real_t>
-      void hall_pinsky_cumulonimbus_efficiencies(std::vector<real_t> &vec)
-      {
-        //NVCC doesn't support extended initializer list. First make an array, then copy it to a vector.
-        const real_t arr[] = {
+      // lower triangle of the (R, r) efficiency matrix, cf. kernel_index() and kernel_vector_index()
+      const double hall_pinsky_cumulonimbus_efficiencies[] = {
 0, 0, 0.178, 0, 0.174, 0.178, 0, 0.09, 0.182, 0.184, 0, 0.064, 0.097, 0.185, 0.186, 0, 0.049, 0.069, 0.101, 0.186, 
       
 0.186, 0, 0.04, 0.053, 0.071, 0.102, 0.186, 0.186, 0, 0.034, 0.043, 0.055, 0.071, 0.102, 0.186, 0.186, 0, 0.029, 0.036, 0.045, 
@@ -2046,9 +2037,8 @@ namespace libcloudphxx
       
 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
       
-1          };
-      vec = std::vector<real_t>(arr, arr + sizeof(arr) / sizeof(arr[0]) );
-      }
+1
+      };
     }
   }
 }
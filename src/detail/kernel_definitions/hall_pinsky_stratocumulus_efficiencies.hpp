@@ -5,17 +5,8 @@ namespace libcloudphxx
   {
     namespace detail
     {
-      template<class real_t>
-      real_t hall_pinsky_stratocumulus_r_max()
-      {
-        return 1100.;
-      }
-
-      template<class real_t>
-      void hall_pinsky_stratocumulus_efficiencies(std::vector<real_t> &vec)
-      {
-        //NVCC doesn't support extended initializer list. First make an array, then copy it to a vector.
-        const real_t arr[] = {
+      // lower triangle of the (R, r) efficiency matrix, cf. kernel_index() and kernel_vector_index()
+      const double hall_pinsky_stratocumulus_efficiencies[] = {
 0, 0, 0.037, 0, 0.034, 0.037, 0, 0.02, 0.039, 0.04, 0, 0.015, 0.028, 0.041, 0.042, 0, 0.011, 0.022, 0.031, 0.042, 
       
 0.042, 0, 0.009, 0.018, 0.026, 0.032, 0.042, 0.042, 0, 0.007, 0.015, 0.022, 0.027, 0.032, 0.042, 0.042, 0, 0.006, 0.013, 0.019, 
@@ -2046,9 +2037,8 @@ namespace libcloudphxx
       
 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
       
-1          };
-      vec = std::vector<real_t>(arr, arr + sizeof(arr) / sizeof(arr[0]) );
-      }
+1
+      };
     }
   }
 }
@@ -5,17 +5,8 @@ namespace libcloudphxx
   {
     namespace detail
     {
-      template<class real_t>
-      real_t vohl_davis_no_waals_r_max()
-      {
-        return 1100.;
-      }
-
-      template<class real_t>
-      void vohl_davis_no_waals_efficiencies(std::vector<real_t> &vec)
-      {
-        //NVCC doesn't support extended initializer list. First make an array, then copy it to a vector.
-        const real_t arr[] = {
+      // lower triangle of the (R, r) efficiency matrix, cf. kernel_index() and kernel_vector_index()
+      const double vohl_davis_no_waals_efficiencies[] = {
 0, 0, 0, 0, 0, 0.0218, 0, 0, 0.014736, 0.024245, 0, 0, 0.009316, 0.019473, 0.025568, 0, 0, 0.010091, 0.015382, 0.023103, 
       
 0.026963, 0, 0, 0.01122, 0.015029, 0.020001, 0.024974, 0.026963, 0, 0, 0.011883, 0.015712, 0.019293, 0.022628, 0.025963, 0.026963, 0, 0, 0.012151, 0.016412, 
@@ -2046,9 +2037,8 @@ namespace libcloudphxx
       
 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
       
-1          };
-      vec = std::vector<real_t>(arr, arr + sizeof(arr) / sizeof(arr[0]) );
-      }
+1
+      };
     }
   }
 }
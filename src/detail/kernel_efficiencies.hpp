@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      // built-in collision efficiency table of the given kernel and its size; NULL for kernels without one
+      // (the tables are defined once, in double precision, in kernel_efficiencies.cpp; converting
+      // them to real_t gives the same values as the former per-precision tables)
+      const double *efficiencies_tab(const kernel_t::kernel_t &, std::size_t &size);
+
+      // largest radius [um] covered by an efficiency table of a given size (lower triangle of an n x n matrix, cf. kernel_index())
+      template<class real_t>
+      real_t efficiencies_r_max(const std::size_t &size)
+      {
+        const std::size_t n = (std::sqrt(8. * size + 1) - 1) / 2 + .5;
+        if (n < 2 || n * (n + 1) / 2 != size)
+          throw std::runtime_error("the number of collision efficiencies does not correspond to a lower-triangular matrix");
+        return n - 1 <= 100 ? n - 1 : 100 + 10 * (n - 1 - 100);
+      }
+
+      // reads efficiencies separated with whitespace or commas, in the order of the built-in tables
+      template<class real_t>
+      void efficiencies_from_file(const std::string &fname, std::vector<real_t> &vec)
+      {
+        std::ifstream file(fname.c_str());
+        if (!file.good()) throw std::runtime_error("could not open collision efficiencies file: " + fname);
+
+        std::stringstream buf;
+        buf << file.rdbuf();
+        std::string str = buf.str();
+        std::replace(str.begin(), str.end(), ',', ' ');
+
+        std::istringstream iss(str);
+        vec.clear();
+        real_t eff;
+        while (iss >> eff) vec.push_back(eff);
+        if (!iss.eof()) throw std::runtime_error("could not parse collision efficiencies file: " + fname);
+
+        efficiencies_r_max<real_t>(vec.size()); // throws if the size is wrong
+      }
+
+      // materialises the efficiencies for the selected kernel only: from the user file if given, otherwise the built-in table
+      template<class real_t>
+      void efficiencies(const opts_init_t<real_t> &opts_init, std::vector<real_t> &vec)
+      {
+        if (!opts_init.kernel_eff_file.empty())
+          return efficiencies_from_file(opts_init.kernel_eff_file, vec);
+
+        std::size_t size;
+        const double *tab = efficiencies_tab(opts_init.kernel, size);
+        if (tab == NULL) throw std::runtime_error("no collision efficiencies defined for the selected kernel");
+        vec.assign(tab, tab + size);
+      }
+    };
+  };
+};
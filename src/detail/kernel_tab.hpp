@@ -0,0 +1,99 @@
+#pragma once
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      // radius-dependent multiplier of a collision kernel tabulated
+      // on a log-spaced n x n grid of radii r_i = r_min * exp(i * dlnr)
+      template <typename real_t>
+      struct kernel_tab
+      {
+        thrust_device::pointer<real_t> data; // n*n values, row-major, symmetric
+        int n;
+        real_t ln_r_min, dlnr;
+
+        BOOST_GPU_ENABLED
+        real_t r(const int &i) const
+        {
+#if !defined(__NVCC__)
+          using std::exp;
+#endif
+          return exp(ln_r_min + i * dlnr);
+        }
+
+        // bilinear interpolation in ln(r), radii outside of the table are clamped to its edges
+        BOOST_GPU_ENABLED
+        real_t operator()(const real_t &rw2_a, const real_t &rw2_b) const
+        {
+#if !defined(__NVCC__)
+          using std::log;
+          using std::min;
+          using std::max;
+#endif
+          // fractional positions within the table (log of r^2 to avoid taking square roots)
+          const real_t
+            u_a = min(max((real_t(.5) * log(rw2_a) - ln_r_min) / dlnr, real_t(0)), real_t(n - 1)),
+            u_b = min(max((real_t(.5) * log(rw2_b) - ln_r_min) / dlnr, real_t(0)), real_t(n - 1));
+          const int
+            i_a = min(int(u_a), n - 2),
+            i_b = min(int(u_b), n - 2);
+          const real_t
+            w_a = u_a - i_a,
+            w_b = u_b - i_b;
+
+          const thrust_size_t ix = thrust_size_t(i_a) * n + i_b;
+          return
+            (real_t(1) - w_a) * ((real_t(1) - w_b) * data[ix]     + w_b * data[ix + 1]) +
+            w_a               * ((real_t(1) - w_b) * data[ix + n] + w_b * data[ix + n + 1]);
+        }
+      };
+
+      // fills the table with the exact multiplier
+      template <typename real_t, class kernel_T>
+      struct kernel_tab_fill
+      {
+        const kernel_T kernel;
+        const kernel_tab<real_t> tab;
+
+        kernel_tab_fill(const kernel_T &kernel, const kernel_tab<real_t> &tab) : kernel(kernel), tab(tab) {}
+
+        BOOST_GPU_ENABLED
+        real_t operator()(const thrust_size_t &ix) const
+        {
+          return kernel.factor(tab.r(ix / tab.n), tab.r(ix % tab.n));
+        }
+      };
+
+      // absolute difference between the tabulated and the exact multiplier at the (ix / m, ix % m) point 
+      // of a grid of m = (n-1) * sub + 1 points in ln(r) spanning the whole table, i.e. at the nodes and 
+      // at sub-1 points within each interval (the centres of the table cells included for even sub)
+      template <typename real_t, class kernel_T>
+      struct kernel_tab_err
+      {
+        const kernel_T kernel;
+        const kernel_tab<real_t> tab;
+        const int sub;
+        const thrust_size_t m;
+
+        kernel_tab_err(const kernel_T &kernel, const kernel_tab<real_t> &tab, const int &sub) : 
+          kernel(kernel), tab(tab), sub(sub), m(thrust_size_t(tab.n - 1) * sub + 1) {}
+
+        BOOST_GPU_ENABLED
+        real_t operator()(const thrust_size_t &ix) const
+        {
+#if !defined(__NVCC__)
+          using std::abs;
+          using std::exp;
+#endif
+          const real_t
+            r_a = exp(tab.ln_r_min + real_t(ix / m) / sub * tab.dlnr),
+            r_b = exp(tab.ln_r_min + real_t(ix % m) / sub * tab.dlnr);
+          return abs(tab(r_a * r_a, r_b * r_b) - kernel.factor(r_a, r_b));
+        }
+      };
+    };
+  };
+};
@@ -10,6 +10,8 @@ namespace libcloudphxx
   {
     using detail::tpl_calc_wrap;
 
+    // kernels are not polymorphic: calc() is resolved at compile time, the coalescence
+    // pass is instantiated for each kernel type (see coal()) so that calc() can be inlined
     template <typename real_t, typename n_t>
     struct kernel_base
     {
@@ -27,7 +29,7 @@ namespace libcloudphxx
         k_params(k_params), n_user_params(n_user_params), r_max(r_max) {}
 
       BOOST_GPU_ENABLED
-      virtual real_t calc(const tpl_calc_wrap<real_t,n_t> &) const {return 0;}
+      real_t calc(const tpl_calc_wrap<real_t,n_t> &) const {return 0;}
     };
 
 
@@ -39,7 +41,7 @@ namespace libcloudphxx
       kernel_golovin(thrust_device::pointer<real_t> k_params) : kernel_base<real_t, n_t>(k_params, 1) {}
 
       BOOST_GPU_ENABLED
-      virtual real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
+      real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
       {
         enum { n_a_ix, n_b_ix, rw2_a_ix, rw2_b_ix, vt_a_ix, vt_b_ix, rd3_a_ix, rd3_b_ix };
 #if !defined(__NVCC__)
@@ -81,7 +83,7 @@ namespace libcloudphxx
       real_t interpolated_efficiency(real_t, real_t) const;
 
       BOOST_GPU_ENABLED
-      virtual real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
+      real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
       {
         enum { n_a_ix, n_b_ix, rw2_a_ix, rw2_b_ix, vt_a_ix, vt_b_ix, rd3_a_ix, rd3_b_ix };
 #if !defined(__NVCC__)
@@ -119,7 +121,7 @@ namespace libcloudphxx
       kernel_geometric_with_multiplier(thrust_device::pointer<real_t> k_params) : kernel_geometric<real_t, n_t>(k_params, 1) {}
 
       BOOST_GPU_ENABLED
-      virtual real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
+      real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
       {
         return kernel_geometric<real_t, n_t>::calc(tpl_wrap) * kernel_base<real_t, n_t>::k_params[0];
       }
@@ -133,28 +135,43 @@ namespace libcloudphxx
       //ctor
       kernel_long() : kernel_geometric<real_t, n_t>() {}
 
+      // radius-dependent multiplier of the geometric kernel (radii in meters)
       BOOST_GPU_ENABLED
-      virtual real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
+      real_t factor(const real_t &rwa, const real_t &rwb) const
       {
 #if !defined(__NVCC__)
-        using std::abs;
-        using std::pow;
         using std::max;
         using std::min;
 #endif
-        real_t res = kernel_geometric<real_t, n_t>::calc(tpl_wrap);
-
-        real_t r_L = max(sqrt(thrust::get<rw2_a_ix>(tpl_wrap.get_rw())), sqrt(thrust::get<rw2_b_ix>(tpl_wrap.get_rw())));
+        real_t r_L = max(rwa, rwb);
         if(r_L < 50.e-6)
         {
-          real_t r_s = min(sqrt(thrust::get<rw2_a_ix>(tpl_wrap.get_rw())), sqrt(thrust::get<rw2_b_ix>(tpl_wrap.get_rw())));
+          real_t r_s = min(rwa, rwb);
           if(r_s <= 3e-6)
-            res = 0.;
+            return 0.;
           else
-            res *= 4.5e8 * r_L * r_L * (1. - 3e-6/r_s);
+            return 4.5e8 * r_L * r_L * (1. - 3e-6/r_s);
         }
-        
-        return  res;
+        return 1.;
+      }
+
+      // kernel value given the radius-dependent multiplier (exact or tabulated)
+      BOOST_GPU_ENABLED
+      real_t calc_factor(const tpl_calc_wrap<real_t,n_t> &tpl_wrap, const real_t &fctr) const
+      {
+        return fctr * kernel_geometric<real_t, n_t>::calc(tpl_wrap);
+      }
+
+      BOOST_GPU_ENABLED
+      real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
+      {
+#if !defined(__NVCC__)
+        using std::sqrt;
+#endif
+        return calc_factor(tpl_wrap, factor(
+          sqrt(thrust::get<rw2_a_ix>(tpl_wrap.get_rw())), 
+          sqrt(thrust::get<rw2_b_ix>(tpl_wrap.get_rw()))
+        ));
       }
     };
 
@@ -164,8 +181,21 @@ namespace libcloudphxx
       //ctor
       kernel_geometric_with_efficiencies(thrust_device::pointer<real_t> k_params, real_t r_max) : kernel_geometric<real_t, n_t>(k_params, 0, r_max) {}
 
+      // radius-dependent multiplier of the geometric kernel, i.e. the collision efficiency
+      BOOST_GPU_ENABLED
+      real_t factor(const real_t &rwa, const real_t &rwb) const
+      {
+        return kernel_geometric<real_t, n_t>::interpolated_efficiency(rwa, rwb);
+      }
+
       BOOST_GPU_ENABLED
-      virtual real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
+      real_t calc_factor(const tpl_calc_wrap<real_t,n_t> &tpl_wrap, const real_t &fctr) const
+      {
+        return fctr * kernel_geometric<real_t, n_t>::calc(tpl_wrap);
+      }
+
+      BOOST_GPU_ENABLED
+      real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
       {
         enum { n_a_ix, n_b_ix, rw2_a_ix, rw2_b_ix, vt_a_ix, vt_b_ix, rd3_a_ix, rd3_b_ix };
 
@@ -173,10 +203,10 @@ namespace libcloudphxx
         using std::sqrt;
 #endif
 
-        return  kernel_geometric<real_t, n_t>::interpolated_efficiency(
-                  sqrt( thrust::get<rw2_a_ix>(tpl_wrap.get_rw())),
-                  sqrt( thrust::get<rw2_b_ix>(tpl_wrap.get_rw()))
-                ) * kernel_geometric<real_t, n_t>::calc(tpl_wrap);
+        return calc_factor(tpl_wrap, factor(
+          sqrt( thrust::get<rw2_a_ix>(tpl_wrap.get_rw())),
+          sqrt( thrust::get<rw2_b_ix>(tpl_wrap.get_rw()))
+        ));
       }
     };
 
@@ -193,8 +223,17 @@ namespace libcloudphxx
       //ctor
       kernel_onishi(thrust_device::pointer<real_t> k_params, real_t r_max) : kernel_geometric<real_t, n_t>(k_params, 2, r_max) {}
 
+      // radius-dependent multiplier: stagnant air collision efficiency times the Wang turbulent enhancement
+      BOOST_GPU_ENABLED
+      real_t factor(const real_t &rwa, const real_t &rwb) const
+      {
+        return 
+          kernel_geometric<real_t, n_t>::interpolated_efficiency(rwa, rwb) *  
+          wang_collision_enhancement(rwa, rwb, kernel_base<real_t, n_t>::k_params[0]); // k_params[0] - epsilon
+      }
+
       BOOST_GPU_ENABLED
-      virtual real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
+      real_t calc_factor(const tpl_calc_wrap<real_t,n_t> &tpl_wrap, const real_t &fctr) const
       {
         enum { n_a_ix, n_b_ix, rw2_a_ix, rw2_b_ix, vt_a_ix, vt_b_ix, rd3_a_ix, rd3_b_ix };
         enum { rhod_ix, eta_ix };
@@ -212,8 +251,7 @@ namespace libcloudphxx
         );
 
         real_t res = 
-          kernel_geometric<real_t, n_t>::interpolated_efficiency(rwa, rwb) *             // stagnant air collision efficiency
-          wang_collision_enhancement(rwa, rwb, kernel_base<real_t, n_t>::k_params[0]) *  // Wang turbulent collision efficiency enhancement, k_params[0] - epsilon
+          fctr *                                                                         // collision efficiency with turbulent enhancement
           sqrt(
             pow(kernel_geometric<real_t, n_t>::calc(tpl_wrap),2) +                       // geometric kernel 
             pow(onishi_nograv,2)
@@ -221,6 +259,41 @@ namespace libcloudphxx
 
         return res;
       }
+
+      BOOST_GPU_ENABLED
+      real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
+      {
+        enum { n_a_ix, n_b_ix, rw2_a_ix, rw2_b_ix, vt_a_ix, vt_b_ix, rd3_a_ix, rd3_b_ix };
+
+#if !defined(__NVCC__)
+        using std::sqrt;
+#endif
+        return calc_factor(tpl_wrap, factor(
+          sqrt( thrust::get<rw2_a_ix>(tpl_wrap.get_rw())),
+          sqrt( thrust::get<rw2_b_ix>(tpl_wrap.get_rw()))
+        ));
+      }
+    };
+
+    // any of the above kernels with the radius-dependent multiplier (efficiency etc.) 
+    // read from a table precomputed at init (opts_init.tab_kernel)
+    template <typename real_t, typename n_t, class kernel_T>
+    struct kernel_tabulated : kernel_T
+    {
+      detail::kernel_tab<real_t> tab;
+
+      //ctor
+      kernel_tabulated(const kernel_T &kernel, const detail::kernel_tab<real_t> &tab) : kernel_T(kernel), tab(tab) {}
+
+      BOOST_GPU_ENABLED
+      real_t calc(const tpl_calc_wrap<real_t,n_t> &tpl_wrap) const
+      {
+        enum { n_a_ix, n_b_ix, rw2_a_ix, rw2_b_ix, vt_a_ix, vt_b_ix, rd3_a_ix, rd3_b_ix };
+        return kernel_T::calc_factor(tpl_wrap, tab(
+          thrust::get<rw2_a_ix>(tpl_wrap.get_rw()),
+          thrust::get<rw2_b_ix>(tpl_wrap.get_rw())
+        ));
+      }
     };
   };
 };
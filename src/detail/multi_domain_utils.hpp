@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cmath>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+
+// helpers shared by the backends decomposing the domain into x-slabs (multi_CUDA, multi_OpenMP)
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {   
+      // number of cells in x in the dev_no-th slab
+      template<class real_t>
+      int get_dev_nx(const opts_init_t<real_t> &opts_init, const int &dev_no)
+      {
+        if(dev_no < opts_init.dev_count-1)
+          return opts_init.nx / opts_init.dev_count + .5;
+        else
+          return opts_init.nx - dev_no * int(opts_init.nx / opts_init.dev_count + .5); 
+      } 
+
+      // x-slab boundary fix-ups of the coordinates of migrating particles
+      template <typename real_t>
+      struct nextafter_fctr
+      {
+        real_t goal;
+        nextafter_fctr(real_t goal): goal(goal) {}
+        BOOST_GPU_ENABLED
+        real_t operator()(real_t x)
+        {
+#if !defined(__NVCC__)
+          using std::nextafter;
+#endif
+          return nextafter(x, goal);
+        }
+      };
+
+      template <typename real_t>
+      struct remote
+      {
+        real_t lcl, rmt;
+
+        remote(real_t lcl, real_t rmt) : lcl(lcl), rmt(rmt) {}
+
+        BOOST_GPU_ENABLED
+        real_t operator()(real_t x)
+        {
+          return rmt + x - lcl;
+        }
+      };
+
+      template <class real_t>
+      std::map<output_t, real_t> empty_out_map()
+      {
+        std::map<output_t, real_t> res;
+        for(int i=0; i < chem_all+2; ++i) 
+          res[static_cast<output_t>(i)] = 0.;
+        return res;
+      }
+
+      template<class real_t>
+      std::map<output_t, real_t> add_puddle(std::map<output_t, real_t> x, std::map<output_t, real_t> y){
+        std::map<output_t, real_t> res;
+        for(int i=0; i < chem_all+2; ++i) 
+          res[static_cast<output_t>(i)] = x[static_cast<output_t>(i)] + y[static_cast<output_t>(i)];
+        return res;
+      }
+
+      // thrown from barrier_t::wait() in the threads waiting for one that failed
+      struct barrier_aborted : std::runtime_error
+      {
+        barrier_aborted() : std::runtime_error("barrier aborted (another slab failed)") {}
+      };
+
+      // cxx_thread barrier
+      // taken from libmpdata++, which in turn is based on boost barrier's code;
+      // abort() releases all threads waiting now or later (with barrier_aborted)
+      class barrier_t
+      {
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+	std::size_t m_generation, m_count;
+        const std::size_t m_threshold;
+        bool m_aborted;
+
+	public:
+
+	explicit barrier_t(const std::size_t count) : 
+          m_count(count), 
+          m_threshold(count),
+          m_generation(0),
+          m_aborted(false)
+        { }
+
+	bool wait()
+	{
+          std::unique_lock<std::mutex> lock(m_mutex);
+          if (m_aborted) throw barrier_aborted();
+          unsigned int gen = m_generation;
+
+          if (--m_count == 0)
+          {
+            m_generation++;
+            m_count = m_threshold;
+            m_cond.notify_all();
+            return true;
+          }
+
+          while (gen == m_generation && !m_aborted)
+            m_cond.wait(lock);
+          if (gen == m_generation) throw barrier_aborted();
+          return false;
+	}
+
+        void abort()
+        {
+          std::unique_lock<std::mutex> lock(m_mutex);
+          m_aborted = true;
+          m_cond.notify_all();
+        }
+      };
+    }
+  }
+}
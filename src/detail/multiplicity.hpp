@@ -0,0 +1,40 @@
+#pragma once
+
+#include <limits>
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      // type of super-droplet multiplicities; 32-bit multiplicities (-DLIBCLOUDPHXX_N_T_32BIT=ON
+      // in CMake) halve the memory traffic of n in coalescence, moments and removal, but
+      // limit multiplicities to 2^32-1 (checked at initialisation and in the aerosol source)
+      // CUDA does not support max(unsigned long, unsigned long) -> using unsigned long long
+#if defined(LIBCLOUDPHXX_N_T_32BIT)
+      typedef unsigned int n_t;
+#else
+      typedef unsigned long long n_t;
+#endif
+
+      // true if a + b does not fit in n_t
+      template <typename n_t>
+      struct n_sum_overflows
+      {
+        BOOST_GPU_ENABLED
+        bool operator()(const n_t &a, const n_t &b) const
+        {
+          return a > n_t(-1) - b;
+        }
+      };
+
+      // true if x (rounded to nearest) does not fit in n_t
+      template <typename n_t, typename real_t>
+      bool n_overflows(const real_t &x)
+      {
+        return x + real_t(.5) >= real_t(std::numeric_limits<n_t>::max());
+      }
+    };
+  };
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      // counter-based random number generator Philox4x32-10 (Salmon et al. 2011, doi:10.1145/2063384.2063405);
+      // the n-th number of a stream is a pure function of (seed, stream, n), hence
+      // it may be evaluated in parallel, in any order and inline within functors
+      template <typename real_t>
+      struct philox
+      {
+        unsigned int key[2], // seed
+                     str[2]; // stream number
+
+        // ctor
+        BOOST_GPU_ENABLED
+        philox(const unsigned int &seed, const unsigned long long &stream)
+        {
+          key[0] = seed;
+          key[1] = 0;
+          str[0] = stream;
+          str[1] = stream >> 32;
+        }
+
+        private:
+
+        BOOST_GPU_ENABLED
+        static void mulhilo(const unsigned int &a, const unsigned int &b, unsigned int &hi, unsigned int &lo)
+        {
+          const unsigned long long prod = (unsigned long long)(a) * b;
+          hi = prod >> 32;
+          lo = prod;
+        }
+
+        // fills out[0:4] with the random bits for the n-th element of the stream
+        BOOST_GPU_ENABLED
+        void bits(const unsigned long long &n, unsigned int out[4]) const
+        {
+          unsigned int 
+            ctr[4] = {(unsigned int)(n), (unsigned int)(n >> 32), str[0], str[1]},
+            k[2] = {key[0], key[1]},
+            hi0, lo0, hi1, lo1;
+
+          for (int r = 0; r < 10; ++r)
+          {
+            if (r > 0)
+            {
+              k[0] += 0x9E3779B9; 
+              k[1] += 0xBB67AE85;
+            }
+            mulhilo(0xD2511F53, ctr[0], hi0, lo0);
+            mulhilo(0xCD9E8D57, ctr[2], hi1, lo1);
+            ctr[0] = hi1 ^ ctr[1] ^ k[0];
+            ctr[1] = lo1;
+            ctr[2] = hi0 ^ ctr[3] ^ k[1];
+            ctr[3] = lo0;
+          }
+
+          for (int i = 0; i < 4; ++i) out[i] = ctr[i];
+        }
+
+        public:
+
+        // uniform natural number from [0, max value of unsigned int]
+        BOOST_GPU_ENABLED
+        unsigned int un(const unsigned long long &n) const
+        {
+          unsigned int out[4];
+          bits(n, out);
+          return out[0];
+        }
+
+        // uniform real number from [0, 1)
+        BOOST_GPU_ENABLED
+        real_t u01(const unsigned long long &n) const
+        {
+          unsigned int out[4];
+          bits(n, out);
+          return sizeof(real_t) == sizeof(float)
+            ? real_t((out[0] >> 8) * (1. / 16777216.))                                // 24-bit mantissa
+            : real_t(((out[0] >> 5) * 67108864. + (out[1] >> 6)) * (1. / 9007199254740992.)); // 53-bit mantissa
+        }
+      };
+
+      // functors for filling vectors with the n-th numbers of a stream
+      template <typename real_t>
+      struct philox_u01
+      {
+        const philox<real_t> gen;
+        philox_u01(const philox<real_t> &gen) : gen(gen) {}
+
+        BOOST_GPU_ENABLED
+        real_t operator()(const thrust_size_t &n) const { return gen.u01(n); }
+      };
+
+      template <typename real_t>
+      struct philox_un
+      {
+        const philox<real_t> gen;
+        philox_un(const philox<real_t> &gen) : gen(gen) {}
+
+        BOOST_GPU_ENABLED
+        unsigned int operator()(const thrust_size_t &n) const { return gen.un(n); }
+      };
+    };
+  };
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "async_worker.hpp"
+
+// append-only files with snapshots of super-droplet attributes:
+//
+//   snap_header_t                    (fixed size, at offset 0)
+//   record 0, record 1, ...          (one per snapshot, each starting at a multiple of snap_align)
+//
+// each record is a snap_record_t followed by a block with the persistent ids of the
+// SDs (n_sd uint64 values, to follow SDs from record to record) and one block per
+// attribute (in the order of snap_header_t::attrs, n_sd values each, n_sd * n_chem
+// for chem, species-major), every block starting at a multiple of snap_align; records
+// are flushed as they are written, so that the file can be read while the simulation
+// is running
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      const char snap_magic[8] = {'L', 'C', 'P', 'P', 'S', 'N', 'A', 'P'};
+      const std::uint32_t snap_version = 2; // 2: SD ids in each record
+      const std::uint32_t snap_endian = 0x01020304;
+      const std::uint64_t snap_align = 64;
+      const int snap_attrs_max = 16;
+
+      inline std::uint64_t snap_aligned(const std::uint64_t &bytes)
+      {
+        return (bytes + snap_align - 1) / snap_align * snap_align;
+      }
+
+      struct snap_header_t
+      {
+        char magic[8];
+        std::uint32_t version, endian, real_size, n_t_size;
+        std::uint32_t n_chem, sd_stride, n_attrs;
+        std::uint32_t attrs[snap_attrs_max]; // snap_attr_t
+      };
+
+      struct snap_record_t
+      {
+        std::uint64_t record, // number of the call to snapshot() (counting from 0)
+                      n_part, // number of SDs
+                      n_sd,   // number of SDs written (every sd_stride-th)
+                      bytes;  // size of the record, including this header
+      };
+
+      // double-buffered writer: the record for the next snapshot is assembled in one
+      // buffer while the previous one is being written to disk by a worker thread
+      class snapshot_writer
+      {
+        std::string path;
+        std::ofstream file;
+        std::vector<char> bfr[2];
+        int cur;
+        async_worker worker; // last, so that it is joined before the buffers are destroyed
+
+        void write(const char *b, const std::size_t &bytes)
+        {
+          file.write(b, bytes);
+          file.flush();
+          if (!file) throw std::runtime_error(detail::formatter() << "error writing snapshot file " << path);
+        }
+
+        public:
+
+        snapshot_writer() : cur(0) {}
+
+        bool is_open() const { return file.is_open(); }
+
+        void open(const std::string &_path, snap_header_t hdr)
+        {
+          if (is_open()) throw std::runtime_error(detail::formatter() << "snapshot file " << path << " is still open, call snapshot_close() first");
+
+          path = _path;
+          file.open(path.c_str(), std::ios::binary | std::ios::trunc);
+          if (!file) throw std::runtime_error(detail::formatter() << "could not open snapshot file " << path);
+
+          std::memcpy(hdr.magic, snap_magic, sizeof(snap_magic));
+          hdr.version = snap_version;
+          hdr.endian = snap_endian;
+
+          std::vector<char> b(snap_aligned(sizeof(hdr)), 0);
+          std::memcpy(b.data(), &hdr, sizeof(hdr));
+          write(b.data(), b.size());
+        }
+
+        // both buffers allocated (and zero-filled) once, for records of up to the given size
+        void reserve(const std::size_t &bytes)
+        {
+          for (int i = 0; i < 2; ++i) bfr[i].resize(bytes);
+        }
+
+        // buffer for the next record of the given size, not accessed by the worker until commit()
+        char *staging(const std::size_t &bytes)
+        {
+          if (bytes > bfr[cur].size()) throw std::runtime_error(detail::formatter() << "snapshot record of " << bytes << " bytes exceeds the " << bfr[cur].size() << " bytes reserved");
+          return bfr[cur].data();
+        }
+
+        // hands the first bytes of the staging buffer over to the worker (waiting for the previous write, if still running)
+        void commit(const std::size_t &bytes)
+        {
+          const int i = cur;
+          worker.submit([this, i, bytes](){ write(bfr[i].data(), bytes); });
+          cur = 1 - cur;
+        }
+
+        // waits for the pending write, rethrowing its exceptions
+        void close()
+        {
+          if (!is_open()) return;
+          try { worker.wait(); }
+          catch (...) { file.close(); throw; }
+          file.close();
+        }
+      };
+    };
+  };
+};
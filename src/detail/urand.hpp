@@ -2,12 +2,14 @@
 
 #include "thrust.hpp"
 
+#include "philox.hpp"
+
+#include <thrust/transform.h>
+#include <thrust/iterator/counting_iterator.h>
+
 #if defined(__NVCC__)
 #  include <curand.h>
 #  include <limits>
-#else
-#  include <random>
-#  include <algorithm>
 #endif
 
 namespace libcloudphxx
@@ -20,47 +22,46 @@ namespace libcloudphxx
       class rng
       {
 #if !defined(__NVCC__)
-	// serial version using C++11's <random>
-	using engine_t = std::mt19937;
-        using dist_u01_t = std::uniform_real_distribution<real_t>;
-        using dist_un_t = std::uniform_int_distribution<unsigned int>;
-	engine_t engine;
-	dist_u01_t dist_u01;
-	dist_un_t dist_un;
-
-	struct fnctr_u01
-	{
-          engine_t &engine;
-          dist_u01_t &dist_u01;
-	  real_t operator()() { return dist_u01(engine); }
-	};
-
-	struct fnctr_un
-	{
-          engine_t &engine;
-          dist_un_t &dist_un;
-	  real_t operator()() { return dist_un(engine); }
-	};
+	// serial/OpenMP version using the counter-based Philox generator:
+        // each call consumes a new stream, numbers within a stream are generated
+        // in parallel and do not depend on the number of threads
+        const unsigned int seed;
+        unsigned long long stream_ctr;
 
 	public:
 
         // ctor
-        rng(int seed) : engine(seed), dist_u01(0,1), dist_un(0, std::numeric_limits<unsigned int>::max()) {}
+        rng(int seed) : seed(seed), stream_ctr(0) {}
+
+        // a fresh stream to be evaluated inline, e.g. within functors
+        philox<real_t> next_stream() { return philox<real_t>(seed, stream_ctr++); }
+
+        // the stream counter fully determines the state (used in checkpoints)
+        unsigned long long get_ctr() const { return stream_ctr; }
+        void set_ctr(const unsigned long long &ctr) { stream_ctr = ctr; }
 
 	void generate_n(
 	  thrust_device::vector<real_t> &u01, 
 	  const thrust_size_t n
 	) {
-          // note: generate_n copies the third argument!!!
-	  std::generate_n(u01.begin(), n, fnctr_u01({.engine = engine, .dist_u01 = dist_u01})); 
+          thrust::transform(
+            thrust::make_counting_iterator<thrust_size_t>(0),
+            thrust::make_counting_iterator<thrust_size_t>(n),
+            u01.begin(),
+            philox_u01<real_t>(next_stream())
+          );
 	}
 
 	void generate_n(
 	  thrust_device::vector<unsigned int> &un, 
 	  const thrust_size_t n
 	) {
-          // note: generate_n copies the third argument!!!
-	  std::generate_n(un.begin(), n, fnctr_un({.engine = engine, .dist_un = dist_un})); 
+          thrust::transform(
+            thrust::make_counting_iterator<thrust_size_t>(0),
+            thrust::make_counting_iterator<thrust_size_t>(n),
+            un.begin(),
+            philox_un<real_t>(next_stream())
+          );
 	}
 #endif
       };
@@ -73,10 +74,14 @@ namespace libcloudphxx
 
 	// private member fields
 	curandGenerator_t gen;
+
+        // for inline generation (see the non-CUDA version above)
+        const unsigned int seed;
+        unsigned long long stream_ctr;
 	
 	public:
 
-	rng(int seed)
+	rng(int seed) : seed(seed), stream_ctr(0)
 	{
           {
 	    int status = curandCreateGenerator(&gen, CURAND_RNG_PSEUDO_MTGP32);
@@ -90,6 +95,20 @@ namespace libcloudphxx
 	  }
         }
 
+        philox<real_t> next_stream() { return philox<real_t>(seed, stream_ctr++); }
+
+        // MTGP32 cannot be fast-forwarded, so after restoring from a checkpoint
+        // it is re-seeded with a value derived from the counter - reproducible,
+        // but not the same sequence as in an uninterrupted run
+        unsigned long long get_ctr() const { return stream_ctr; }
+        void set_ctr(const unsigned long long &ctr)
+        {
+          stream_ctr = ctr;
+	  int status = curandSetPseudoRandomGeneratorSeed(gen, seed + ctr);
+	  assert(status == CURAND_STATUS_SUCCESS /* && "curandSetPseudoRandomGeneratorSeed failed"*/);
+          _unused(status);
+        }
+
 	~rng()
 	{
 	  int status = curandDestroyGenerator(gen); 
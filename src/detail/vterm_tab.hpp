@@ -0,0 +1,66 @@
+#pragma once
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      // ln of the terminal velocity divided by its explicitly computed prefactor (cf. vt_tab_prefactor()), tabulated on a regular (ln r, T, ln rhod) grid
+      template <typename real_t>
+      struct vt_table
+      {
+        thrust_device::pointer<real_t> data; // n_r * n_T * n_rhod values, rhod index varying fastest
+        int n_r, n_T, n_rhod;
+        real_t ln_r_min, dlnr, T_min, dT, ln_rhod_min, dlnrhod;
+
+        BOOST_GPU_ENABLED
+        bool in_range(const real_t &lnr, const real_t &T, const real_t &lnrhod) const
+        {
+          return 
+            lnr    >= ln_r_min    && lnr    <= ln_r_min    + (n_r - 1)    * dlnr &&
+            T      >= T_min       && T      <= T_min       + (n_T - 1)    * dT &&
+            lnrhod >= ln_rhod_min && lnrhod <= ln_rhod_min + (n_rhod - 1) * dlnrhod;
+        }
+
+        // trilinear interpolation, arguments have to be in range
+        BOOST_GPU_ENABLED
+        real_t operator()(const real_t &lnr, const real_t &T, const real_t &lnrhod) const
+        {
+#if !defined(__NVCC__)
+          using std::min;
+          using std::exp;
+#endif
+          const real_t 
+            u_r = (lnr - ln_r_min) / dlnr, 
+            u_T = (T - T_min) / dT, 
+            u_d = (lnrhod - ln_rhod_min) / dlnrhod;
+          const int 
+            i_r = min(int(u_r), n_r - 2), 
+            i_T = min(int(u_T), n_T - 2), 
+            i_d = min(int(u_d), n_rhod - 2);
+          const real_t 
+            w_r = u_r - i_r, 
+            w_T = u_T - i_T, 
+            w_d = u_d - i_d;
+
+          const thrust_size_t 
+            ix = (thrust_size_t(i_r) * n_T + i_T) * n_rhod + i_d,
+            s_r = thrust_size_t(n_T) * n_rhod, 
+            s_T = n_rhod;
+
+          return exp(
+            (1 - w_r) * (
+              (1 - w_T) * ((1 - w_d) * data[ix]             + w_d * data[ix + 1]) + 
+              w_T       * ((1 - w_d) * data[ix + s_T]       + w_d * data[ix + s_T + 1])
+            ) + 
+            w_r * (
+              (1 - w_T) * ((1 - w_d) * data[ix + s_r]       + w_d * data[ix + s_r + 1]) + 
+              w_T       * ((1 - w_d) * data[ix + s_r + s_T] + w_d * data[ix + s_r + s_T + 1])
+            )
+          );
+        }
+      };
+    };
+  };
+};
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <libcloudph++/lgrngn/workspace.hpp>
+
+// temporary storage used within a timestep:
+//
+//   - per-particle temporaries (tmp_device_real_part, ...) are registered once with
+//     the workspace, which reserves them for n_sd_max and resizes them with n_part
+//     (resident: their size is accounted for, not their use)
+//   - scoped temporaries (e.g. the bin bookkeeping in src(), host staging of the
+//     MPI transfers) are leased from pools of device or host vectors reserved at
+//     init(), and returned to the pool at the end of the scope
+//
+// nothing is allocated in the step loop unless a temporary has to grow beyond what
+// was reserved (counted in n_alloc); leased bytes are accounted for when a lease is
+// taken and returned, and the maximum of the resident and leased bytes is recorded
+// per stage of the timestep
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      // memory accounting of a temporary (or of a pool of temporaries)
+      struct ws_member
+      {
+        virtual std::size_t bytes() const = 0;          // in use
+        virtual std::size_t capacity_bytes() const = 0; // allocated
+        virtual ~ws_member() {}
+      };
+
+      class workspace
+      {
+        // a vector registered with the workspace (not owned)
+        template <class vec_t>
+        struct ws_vector : ws_member
+        {
+          vec_t &v;
+
+          ws_vector(vec_t &v) : v(v) {}
+
+          std::size_t bytes() const { return v.size() * sizeof(typename vec_t::value_type); }
+          std::size_t capacity_bytes() const { return v.capacity() * sizeof(typename vec_t::value_type); }
+        };
+
+        // a per-particle vector, follows n_part
+        struct ws_part
+        {
+          virtual void reserve(const std::size_t &) = 0;
+          virtual bool resize(const std::size_t &) = 0; // true if it had to allocate
+          virtual ~ws_part() {}
+        };
+
+        template <class vec_t>
+        struct ws_part_vector : ws_vector<vec_t>, ws_part
+        {
+          ws_part_vector(vec_t &v) : ws_vector<vec_t>(v) {}
+
+          void reserve(const std::size_t &n) { this->v.reserve(n); }
+
+          bool resize(const std::size_t &n)
+          {
+            const bool grow = n > this->v.capacity();
+            this->v.resize(n);
+            return grow;
+          }
+        };
+
+        std::vector<std::unique_ptr<ws_member> > owned;
+        std::vector<const ws_member*> members;
+        std::vector<ws_part*> part;
+
+        std::size_t n_alloc, leased;
+        std::map<std::string, std::size_t> peak;
+        std::string stage;
+
+        friend class ws_stage;
+
+        // updates the peak of the current stage (if any): the resident temporaries
+        // (at the current n_part) and those leased
+        void sample()
+        {
+          if (stage.empty()) return;
+          std::size_t &p = peak[stage];
+          p = std::max(p, resident_bytes() + leased);
+        }
+
+        public:
+
+        workspace() : n_alloc(0), leased(0) {}
+
+        // a temporary with fixed size (e.g. per-cell), accounted for only
+        template <class vec_t>
+        void add(vec_t &v)
+        {
+          owned.emplace_back(new ws_vector<vec_t>(v));
+          members.push_back(owned.back().get());
+        }
+
+        // a per-particle temporary, reserved in reserve_part() and resized in resize_part()
+        template <class vec_t>
+        void add_part(vec_t &v)
+        {
+          ws_part_vector<vec_t> *p = new ws_part_vector<vec_t>(v);
+          owned.emplace_back(p);
+          members.push_back(p);
+          part.push_back(p);
+        }
+
+        // pools register themselves
+        void add(const ws_member *m) { members.push_back(m); }
+
+        void reserve_part(const std::size_t &n)
+        {
+          for (std::size_t i = 0; i < part.size(); ++i) part[i]->reserve(n);
+        }
+
+        void resize_part(const std::size_t &n)
+        {
+          for (std::size_t i = 0; i < part.size(); ++i)
+            if (part[i]->resize(n)) ++n_alloc;
+          sample(); // n_part may grow within a stage (src, SDs from other slabs)
+        }
+
+        // a temporary had to be (re)allocated
+        void grew() { ++n_alloc; }
+
+        // bytes handed out (and returned) by a pool
+        void lease(const std::size_t &bytes)
+        {
+          leased += bytes;
+          sample();
+        }
+
+        void release(const std::size_t &bytes) { leased -= bytes; }
+
+        // size of the registered (per-particle and per-cell) temporaries
+        std::size_t resident_bytes() const
+        {
+          std::size_t res = 0;
+          for (std::size_t i = 0; i < owned.size(); ++i) res += owned[i]->bytes();
+          return res;
+        }
+
+        std::size_t capacity_bytes() const
+        {
+          std::size_t res = 0;
+          for (std::size_t i = 0; i < members.size(); ++i) res += members[i]->capacity_bytes();
+          return res;
+        }
+
+        workspace_info_t info() const
+        {
+          workspace_info_t res;
+          res.reserved_bytes = capacity_bytes();
+          res.resident_bytes = resident_bytes();
+          res.n_alloc = n_alloc;
+          res.peak_bytes = peak;
+          return res;
+        }
+      };
+
+      // marks a stage of the timestep for the peak accounting (stages may be nested,
+      // e.g. sorting within src(), the inner one is accounted for separately, including
+      // what the outer one holds leased); every stage entered is recorded
+      class ws_stage
+      {
+        workspace &ws;
+        const std::string prev;
+
+        public:
+
+        ws_stage(workspace &ws, const std::string &name) : ws(ws), prev(ws.stage)
+        {
+          ws.stage = name;
+          ws.sample();
+        }
+
+        ~ws_stage()
+        {
+          ws.stage = prev;
+        }
+      };
+
+      // a set of vectors handed out for the duration of a scope (device vectors by default,
+      // thrust::host_vector for staging on the host)
+      template <typename T, class vec_t = thrust_device::vector<T> >
+      class tmp_pool : public ws_member
+      {
+        workspace &ws;
+        std::vector<std::unique_ptr<vec_t> > slots;
+        std::vector<bool> busy;
+
+        public:
+
+        // returns the vector to the pool when it goes out of scope (its memory is kept)
+        class lease
+        {
+          tmp_pool *pool;
+          std::size_t s, bytes;
+
+          public:
+
+          lease(tmp_pool *pool, const std::size_t &s, const std::size_t &bytes) : pool(pool), s(s), bytes(bytes)
+          {
+            pool->ws.lease(bytes);
+          }
+          lease(lease &&l) : pool(l.pool), s(l.s), bytes(l.bytes) { l.pool = NULL; }
+          lease(const lease &) = delete;
+          lease &operator=(const lease &) = delete;
+
+          ~lease()
+          {
+            if (pool == NULL) return;
+            pool->busy[s] = false;
+            pool->ws.release(bytes);
+          }
+
+          vec_t &operator*() const { return *pool->slots[s]; }
+        };
+
+        tmp_pool(workspace &ws) : ws(ws) { ws.add(this); }
+
+        // n_slots vectors with capacity for n elements each
+        void reserve(const std::size_t &n_slots, const std::size_t &n)
+        {
+          while (slots.size() < n_slots)
+          {
+            slots.emplace_back(new vec_t());
+            busy.push_back(false);
+          }
+          for (std::size_t s = 0; s < slots.size(); ++s) slots[s]->reserve(n);
+        }
+
+        // a vector of n elements (contents unspecified); a free slot that is large
+        // enough is preferred, the pool grows if needed (counted by the workspace)
+        lease acquire(const std::size_t &n)
+        {
+          std::size_t s = slots.size();
+          for (std::size_t i = 0; i < slots.size(); ++i)
+          {
+            if (busy[i]) continue;
+            if (s == slots.size()) s = i;
+            if (slots[i]->capacity() >= n) { s = i; break; }
+          }
+          if (s == slots.size())
+          {
+            slots.emplace_back(new vec_t());
+            busy.push_back(false);
+          }
+
+          if (n > slots[s]->capacity()) ws.grew();
+          slots[s]->resize(n);
+          busy[s] = true;
+          return lease(this, s, n * sizeof(T));
+        }
+
+        std::size_t bytes() const
+        {
+          std::size_t res = 0;
+          for (std::size_t s = 0; s < slots.size(); ++s)
+            if (busy[s]) res += slots[s]->size() * sizeof(T);
+          return res;
+        }
+
+        std::size_t capacity_bytes() const
+        {
+          std::size_t res = 0;
+          for (std::size_t s = 0; s < slots.size(); ++s) res += slots[s]->capacity() * sizeof(T);
+          return res;
+        }
+      };
+    };
+  };
+};
@@ -13,6 +13,7 @@
 #include <boost/numeric/odeint/external/thrust/thrust_algebra.hpp>
 #include <boost/numeric/odeint/external/thrust/thrust_operations.hpp>
 #include <boost/numeric/odeint/external/thrust/thrust_resize.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include <map>
 
@@ -24,18 +25,43 @@ namespace libcloudphxx
     {   
       enum { invalid = -1 };
 
+      // defined in particles_impl_coal.ipp
+      template <typename real_t> struct collider_attrs;
+      template <typename real_t> struct collider_sstp;
+
     };  
 
     // pimpl stuff 
     template <typename real_t, backend_t device>
     struct particles_t<real_t, device>::impl
     { 
-      // CUDA does not support max(unsigned long, unsigned long) -> using unsigned long long
-      typedef unsigned long long n_t; // thrust_size_t?
+      // multiplicity type, see detail/multiplicity.hpp
+      typedef detail::n_t n_t;
+
+      // type of the persistent SD ids
+      typedef unsigned long long sd_id_t;
+
+      // per-cell sums over particles (moments, changes of rv and th) are accumulated 
+      // in real_t; float runs may accumulate in double instead (-DLIBCLOUDPHXX_ACC_T_DOUBLE=ON
+      // in CMake), which keeps them mass-conserving in cells with many SDs, at the cost
+      // of speed on GPUs with slow FP64 (most consumer cards run it at 1/32 of the FP32 rate)
+#if defined(LIBCLOUDPHXX_ACC_T_DOUBLE)
+      typedef double acc_t;
+#else
+      typedef real_t acc_t;
+#endif
  
       // order of operation flags
       bool init_called, should_now_run_async, selected_before_counting;
 
+      // worker thread running step_async() for step_async_begin()
+      detail::async_worker async;
+
+      // streaming output of SD attributes (snapshot_open()/snapshot())
+      detail::snapshot_writer snap;
+      snapshot_opts_t snap_opts;
+      n_t snap_ctr; // number of calls to snapshot() since snapshot_open()
+
       // member fields
       opts_init_t<real_t> opts_init; // a copy
       const int n_dims;
@@ -46,16 +72,20 @@ namespace libcloudphxx
       detail::rng<real_t, device> rng;
       detail::config<real_t> config;
 
-      // pointer to collision kernel
-      kernel_base<real_t, n_t> *p_kernel;
- 
-      // containters for all kernel types
-      thrust_device::vector<kernel_golovin<real_t, n_t> > k_golovin;
-      thrust_device::vector<kernel_geometric<real_t, n_t> > k_geometric;
-      thrust_device::vector<kernel_long<real_t, n_t> > k_long;
-      thrust_device::vector<kernel_geometric_with_efficiencies<real_t, n_t> > k_geometric_with_efficiencies;
-      thrust_device::vector<kernel_geometric_with_multiplier<real_t, n_t> > k_geometric_with_multiplier;
-      thrust_device::vector<kernel_onishi<real_t, n_t> > k_onishi;
+      // containters for all kernel types (host-side, the selected kernel is passed by value to the collider)
+      std::vector<kernel_golovin<real_t, n_t> > k_golovin;
+      std::vector<kernel_geometric<real_t, n_t> > k_geometric;
+      std::vector<kernel_long<real_t, n_t> > k_long;
+      std::vector<kernel_geometric_with_efficiencies<real_t, n_t> > k_geometric_with_efficiencies;
+      std::vector<kernel_geometric_with_multiplier<real_t, n_t> > k_geometric_with_multiplier;
+      std::vector<kernel_onishi<real_t, n_t> > k_onishi;
+
+      // tabulated variants (opts_init.tab_kernel) and the table itself
+      std::vector<kernel_tabulated<real_t, n_t, kernel_long<real_t, n_t> > > k_long_tab;
+      std::vector<kernel_tabulated<real_t, n_t, kernel_geometric_with_efficiencies<real_t, n_t> > > k_geometric_with_efficiencies_tab;
+      std::vector<kernel_tabulated<real_t, n_t, kernel_onishi<real_t, n_t> > > k_onishi_tab;
+      thrust_device::vector<real_t> kernel_tab_data;
+      kernel_tab_info_t kernel_tab_info;
 
       // device container for kernel parameters, could come from opts_init or a file depending on the kernel
       thrust_device::vector<real_t> kernel_parameters;
@@ -66,6 +96,8 @@ namespace libcloudphxx
       // particle attributes
       thrust_device::vector<n_t>
 	n;   // multiplicity
+      thrust_device::vector<sd_id_t>
+        sd_id; // persistent id, unique in the whole domain, kept when SDs are reordered, removed or moved to other slabs
       thrust_device::vector<real_t> 
 	rd3, // dry radii cubed 
 	rw2, // wet radius square
@@ -77,6 +109,17 @@ namespace libcloudphxx
         sstp_tmp_th, // ditto for theta_d
         sstp_tmp_rh; // ditto for rho
 
+      // rate of change of rw2 [m2/s] in the last condensation step of each SD, the initial guess of
+      // the next one (cond_solver_t::newton only, see cond_advance_rw2(); 0 for new SDs)
+      thrust_device::vector<real_t> cond_drw2_dt;
+
+      // number of substeps (out of sstp_cond) covered by a single condensation step of each SD (adaptive_sstp_cond)
+      thrust_device::vector<unsigned int> sstp_cond_stride;
+      // SD ids ordered by sstp_cond_stride (and by cell within a stride) and the beginning 
+      // of the range of each stride in it, set at the first substep of a timestep
+      thrust_device::vector<thrust_size_t> sstp_cond_ord;
+      std::vector<thrust_size_t> sstp_cond_bucket;
+
       // dry radii distribution characteristics
       real_t log_rd_min, // logarithm of the lower bound of the distr
              log_rd_max, // logarithm of the upper bound of the distr
@@ -85,7 +128,12 @@ namespace libcloudphxx
       // terminal velocity (per particle)
       thrust_device::vector<real_t> vt; 
       // sea level term velocity according to Beard 1977, compute once
-      thrust_device::vector<real_t> vt_0; 
+      thrust_device::vector<real_t> vt_0;
+
+      // tabulated terminal velocities (opts_init.tab_vterm)
+      thrust_device::vector<real_t> vt_tab_data;
+      detail::vt_table<real_t> vt_tab;
+      vt_tab_info_t vt_tab_info; 
 
       // grid-cell volumes (per grid cell)
       thrust_device::vector<real_t> dv;
@@ -104,7 +152,7 @@ namespace libcloudphxx
         count_ijk; // key-value pair for sorting particles by cell index
       thrust_device::vector<n_t>
         count_num; // number of particles in a given grid cell
-      thrust_device::vector<real_t> 
+      thrust_device::vector<acc_t> 
         count_mom; // statistical moment // TODO (perhaps tmp_device_real_cell could be referenced?)
       thrust_size_t count_n;
 
@@ -132,31 +180,60 @@ namespace libcloudphxx
         T,  // temperature [K]
         p,  // pressure [Pa]
         RH, // relative humisity (p_v / p_vs)
-        eta;// dynamic viscosity 
+        eta,// dynamic viscosity 
+        Sc, // Schmidt number
+        Pr, // Prandtl number
+        lambda_D, // mean free path for vapour diffusion [m]
+        lambda_K; // mean free path for heat conduction [m]
 
       // sorting needed only for diagnostics and coalescence
       bool sorted;
 
+      // true if sorted_id and sorted_ijk hold a cell-order permutation of the current
+      // set of particles (possibly outdated if ijk changed), used by the incremental sort
+      bool presorted;
+
+      // true if th, rv or rhod changed since the last hskpng_Tpr(), i.e. T, p, RH, eta,
+      // the condensation coefficients (and dv in parcel set-ups) have to be recomputed
+      bool tpr_dirty;
+
       // true if coalescence timestep has to be reduced, accesible from both device and host code
       bool *increase_sstp_coal;
+
+      // number of coalescence substeps in each cell (adaptive_sstp_coal)
+      thrust_device::vector<unsigned int> sstp_coal_cell;
       // is it a pure const_multi run, i.e. no sd_conc
       bool pure_const_multi;
 
       // timestep counter
       n_t stp_ctr;
 
+      // number of steps since the last reordering of particle attributes
+      int reorder_ctr;
+
+      // condensation solver statistics for the current timestep
+      cond_stats_t cond_stats;
+
       // maps linear Lagrangian component indices into Eulerian component linear indices
-      // the map key is the address of the Thrust vector
-      std::map<
-        const thrust_device::vector<real_t>*, 
-        thrust::host_vector<int> 
-      > l2e; 
+      struct l2e_t
+      {
+        thrust::host_vector<int> idx;
+        bool contiguous; // idx[i] == idx[0] + i, i.e. sync() can do a bulk copy
+        l2e_t() : contiguous(false) {}
+      };
+      // one per synced field, see l2e() for lookup by the address of the Thrust vector
+      l2e_t l2e_th, l2e_rv, l2e_rhod, l2e_courant_x, l2e_courant_y, l2e_courant_z, l2e_chem[chem_gas_n];
+      // true if th, rv and rhod share the same mapping (and can be synced in one pass)
+      bool l2e_scalars_shared;
 
       // chem stuff
       // TODO: consider changing the unit to AMU or alike (very small numbers!)
       std::vector<typename thrust_device::vector<real_t>::iterator >
         chem_bgn, chem_end; // indexed with enum chem_species_t
-      thrust_device::vector<real_t> chem_rhs, chem_ante_rhs, chem_post_rhs;
+      // all species in one chem_all x n_part matrix, species-major (row i starts at chem_bgn[i]),
+      // so that removal, recycling and sorting treat it as one attribute; rows chem_rhs_beg
+      // to chem_rhs_fin-1 are contiguous and integrated in place by odeint (see chem_rhs_range())
+      thrust_device::vector<real_t> chem_mtx;
       /* TODO:
         On May 9, 2012, at 7:44 PM, Karsten Ahnert wrote:
         > ... unfortunately the Rosenbrock method cannot be used with any other state type than ublas.matrix.
@@ -177,7 +254,8 @@ namespace libcloudphxx
       // temporary data
       thrust::host_vector<real_t>
         tmp_host_real_grid,
-        tmp_host_real_cell;
+        tmp_host_real_cell,
+        tmp_host_real_moms; // output of moms_batch (n_cell per moment)
       thrust::host_vector<thrust_size_t>
         tmp_host_size_cell;
       thrust_device::vector<real_t>
@@ -189,12 +267,28 @@ namespace libcloudphxx
         tmp_device_real_cell,
         tmp_device_real_cell1,
 	&u01;  // uniform random numbers between 0 and 1 // TODO: use the tmp array as rand argument?
+      thrust_device::vector<acc_t>
+        tmp_device_acc_cell;
       thrust_device::vector<unsigned int>
         tmp_device_n_part,
         &un; // uniform natural random numbers between 0 and max value of unsigned int
       thrust_device::vector<thrust_size_t>
         tmp_device_size_cell,
-        tmp_device_size_part;
+        tmp_device_size_part,
+        tmp_device_size_part1;
+
+      // registry of the temporaries above (see init_workspace()) and pools of scoped ones
+      detail::workspace ws;
+      detail::tmp_pool<thrust_size_t> tmp_size_pool;
+      detail::tmp_pool<bool> tmp_bool_pool;
+      detail::tmp_pool<real_t> tmp_real_pool; // device-side gathering in snapshot()
+      detail::tmp_pool<n_t> tmp_n_pool;
+      detail::tmp_pool<acc_t> tmp_acc_pool; // moms_batch() output
+      detail::tmp_pool<sd_id_t> tmp_id_pool; // device-side gathering in snapshot()
+      detail::tmp_pool<real_t, thrust::host_vector<real_t> > tmp_host_real_pool;
+      detail::tmp_pool<n_t, thrust::host_vector<n_t> > tmp_host_n_pool;
+      detail::tmp_pool<thrust_size_t, thrust::host_vector<thrust_size_t> > tmp_host_size_pool;
+      detail::tmp_pool<sd_id_t, thrust::host_vector<sd_id_t> > tmp_host_id_pool;
 
       // to simplify foreach calls
       const thrust::counting_iterator<thrust_size_t> zero;
@@ -209,6 +303,17 @@ namespace libcloudphxx
       // number of cells in devices to the left of this one
       thrust_size_t n_cell_bfr;
 
+      // MPI rank and number of ranks (one x-slab of the domain per rank)
+      const int mpi_rank, mpi_size;
+      // ranks of the neighbouring slabs (periodic in x)
+      int lft_rank, rgt_rank;
+      // x1 of the slab to the left and x0 of the slab to the right (to shift x of SDs sent there)
+      real_t lft_x1, rgt_x0;
+
+      // SD ids given out so far by this slab; ids of different slabs and ranks interleave (sd_id_ctr * sd_id_stride + sd_id_offset)
+      sd_id_t sd_id_ctr;
+      const sd_id_t sd_id_stride, sd_id_offset;
+
       const int halo_x, // number of cells in the halo for courant_x before first "real" cell, halo only in x
                 halo_y, // number of cells in the halo for courant_y before first "real" cell, halo only in x
                 halo_z; // number of cells in the halo for courant_z before first "real" cell, halo only in x
@@ -216,9 +321,16 @@ namespace libcloudphxx
 
       // in/out buffers for SDs copied from other GPUs
       thrust_device::vector<n_t> in_n_bfr, out_n_bfr;
+      thrust_device::vector<sd_id_t> in_id_bfr, out_id_bfr;
       // TODO: real buffers could be replaced with tmp_device_real_part1/2 if sstp_cond>1
       thrust_device::vector<real_t> in_real_bfr, out_real_bfr;
 
+#if defined(USE_MPI)
+      // transfers to/from the neighbouring ranks in flight (SDs posted after bcnd() and completed
+      // after the local housekeeping, Courant number halos posted in step_sync() and completed before adve())
+      detail::mpi_xchng_t xchng_sds_req, xchng_courants_req;
+#endif
+
       // fills u01[0:n] with random numbers
       void rand_u01(thrust_size_t n) { rng.generate_n(u01, n); }
 
@@ -229,10 +341,11 @@ namespace libcloudphxx
       int m1(int n) { return n == 0 ? 1 : n; }
 
       // ctor 
-      impl(const opts_init_t<real_t> &_opts_init, const int &n_x_bfr, const int &n_x_tot) : 
+      impl(const opts_init_t<real_t> &_opts_init, const int &n_x_bfr, const int &n_x_tot, const int &mpi_rank, const int &mpi_size) : 
         init_called(false),
         should_now_run_async(false),
         selected_before_counting(false),
+        snap_ctr(0),
 	opts_init(_opts_init),
 	n_dims( // 0, 1, 2 or 3
           opts_init.nx/m1(opts_init.nx) + 
@@ -247,14 +360,35 @@ namespace libcloudphxx
         zero(0),
         n_part(0),
         sorted(false), 
+        presorted(false), 
+        tpr_dirty(true),
+        l2e_scalars_shared(false),
         u01(tmp_device_real_part),
         n_user_params(opts_init.kernel_parameters.size()),
         un(tmp_device_n_part),
+        tmp_size_pool(ws),
+        tmp_bool_pool(ws),
+        tmp_real_pool(ws),
+        tmp_n_pool(ws),
+        tmp_acc_pool(ws),
+        tmp_id_pool(ws),
+        tmp_host_real_pool(ws),
+        tmp_host_n_pool(ws),
+        tmp_host_size_pool(ws),
+        tmp_host_id_pool(ws),
         rng(opts_init.rng_seed),
         stp_ctr(0),
+        reorder_ctr(0),
         n_x_bfr(n_x_bfr),
         n_x_tot(n_x_tot),
         n_cell_bfr(n_x_bfr * m1(opts_init.ny) * m1(opts_init.nz)),
+        mpi_rank(mpi_rank),
+        mpi_size(mpi_size),
+        lft_rank((mpi_rank + mpi_size - 1) % mpi_size),
+        rgt_rank((mpi_rank + 1) % mpi_size),
+        sd_id_ctr(0),
+        sd_id_stride(sd_id_t(opts_init.dev_count > 1 ? n_x_tot : 1) * mpi_size),
+        sd_id_offset(sd_id_t(opts_init.dev_count > 1 ? n_x_bfr : 0) * mpi_size + mpi_rank),
         halo_x( 
           n_dims == 1 ? 1:                 // 1D
             n_dims == 2 ? opts_init.nz:    // 2D
@@ -271,6 +405,7 @@ namespace libcloudphxx
         // initialising device temporary arrays
         tmp_device_real_cell.resize(n_cell);
         tmp_device_real_cell1.resize(n_cell);
+        tmp_device_acc_cell.resize(n_cell);
         tmp_device_size_cell.resize(n_cell);
 
         // if using nvcc, put increase_sstp_coal flag in host memory, but with direct access from device code
@@ -308,6 +443,10 @@ namespace libcloudphxx
             default: assert(false); 
           }
           if (n_dims != 0) assert(n_grid > n_cell);
+#if defined(__NVCC__)
+          // staging area for th, rv and rhod synced in one pass
+          n_grid = std::max(n_grid, thrust_size_t(3 * n_cell));
+#endif
 	  tmp_host_real_grid.resize(n_grid);
         }
         tmp_host_size_cell.resize(n_cell);
@@ -327,6 +466,21 @@ namespace libcloudphxx
         const arrinfo_t<real_t>, const arrinfo_t<real_t>, const arrinfo_t<real_t>,
         const std::map<enum chem_species_t, const arrinfo_t<real_t> >
       );
+      void init_eulerian(
+        const arrinfo_t<real_t>, const arrinfo_t<real_t>, const arrinfo_t<real_t>,
+        const arrinfo_t<real_t>, const arrinfo_t<real_t>, const arrinfo_t<real_t>,
+        const std::map<enum chem_species_t, const arrinfo_t<real_t> >
+      );
+      void init_finalize();
+
+      void checkpoint(const std::string &);
+      void restore(const std::string &);
+
+      void snapshot_open(const std::string &, const snapshot_opts_t &);
+      std::uint64_t snap_attr_bytes(const snap_attr_t::snap_attr_t &, const thrust_size_t &);
+      std::uint64_t snap_bytes(const snapshot_opts_t &, const thrust_size_t &);
+      void snapshot();
+      void snapshot_close();
 
       void init_dry_sd_conc();
       void init_dry_const_multi(
@@ -361,27 +515,38 @@ namespace libcloudphxx
       void init_grid();
       void init_hskpng_ncell();
       void init_hskpng_npart();
+      void init_workspace();
       void init_chem();
       void init_chem_aq();
+      boost::iterator_range<typename thrust_device::vector<real_t>::iterator> chem_rhs_range();
       void init_sstp();
       void init_sstp_chem();
       void init_kernel();
+      template <class kernel_T>
+      detail::kernel_tab<real_t> init_kernel_tab(const kernel_T &, const real_t &);
       void init_vterm();
+      void init_vterm_tab();
 
       void fill_outbuf();
 
            // rename hskpng_ -> step_?
       void hskpng_sort_helper(bool);
+      bool hskpng_sort_incremental();
       void hskpng_sort();
       void hskpng_shuffle_and_sort();
+      void hskpng_reorder();
       void hskpng_count();
       void hskpng_ijk();
       void hskpng_Tpr();
 
       void hskpng_vterm_all();
       void hskpng_vterm_invalid();
+      template <class ix_it_t>
+      void hskpng_vterm_invalid(const ix_it_t &, const thrust_size_t &);
       void hskpng_remove_n0();
       void hskpng_resize_npart();
+      template <class it_t>
+      void sd_id_new(const it_t &, const thrust_size_t &);
 
       void moms_all();
    
@@ -401,6 +566,9 @@ namespace libcloudphxx
         const real_t power,
         const bool specific = true
       );
+      std::vector<real_t> moms_batch_table(const std::vector<moms_req_t<real_t> > &);
+      void moms_batch(const std::vector<moms_req_t<real_t> > &);
+      std::vector<real_t> moms_tot(const std::vector<moms_req_t<real_t> > &);
 
       void mass_dens_estim(
 	const typename thrust_device::vector<real_t>::iterator &vec_bgn,
@@ -415,6 +583,16 @@ namespace libcloudphxx
         const thrust_device::vector<real_t> &, // from
         arrinfo_t<real_t> &// to
       );
+      void sync(
+        const arrinfo_t<real_t> &, // from (th)
+        const arrinfo_t<real_t> &, // from (rv)
+        const arrinfo_t<real_t> &  // from (rhod)
+      );
+      void sync(
+        arrinfo_t<real_t> &, // to (th)
+        arrinfo_t<real_t> &  // to (rv)
+      );
+      l2e_t &l2e(const thrust_device::vector<real_t> *);
 
       void adve();
       template<class adve_t>
@@ -423,12 +601,26 @@ namespace libcloudphxx
 
       void cond_dm3_helper();
       void cond(const real_t &dt, const real_t &RH_max);
-      void cond_sstp(const real_t &dt, const real_t &RH_max);
-      void update_th_rv(thrust_device::vector<real_t> &);
+      void cond_sstp(const real_t &dt, const real_t &RH_max, const int &step);
+      template <class ix_it_t, class state_it_t>
+      void cond_advance_rw2(const ix_it_t &, const thrust_size_t &, const state_it_t &, const real_t &, const real_t &);
+      void cond_stats_add(const thrust_size_t &);
+      template <class ix_it_t>
+      void cond_stats_add(const ix_it_t &, const thrust_size_t &);
+      void update_th_rv(thrust_device::vector<acc_t> &);
       void update_state(thrust_device::vector<real_t> &, thrust_device::vector<real_t> &);
       void update_pstate(thrust_device::vector<real_t> &, thrust_device::vector<real_t> &);
+      template <class ix_it_t>
+      void update_pstate_sum(thrust_device::vector<acc_t> &, thrust_device::vector<real_t> &, const ix_it_t &, const thrust_size_t &);
+      void update_pstate_apply(thrust_device::vector<real_t> &, const thrust_device::vector<acc_t> &);
 
       void coal(const real_t &dt);
+      template <class zip_it_t>
+      void coal_pairs(const zip_it_t &, const thrust_size_t &, const real_t &, const detail::collider_attrs<real_t> &, const detail::collider_sstp<real_t> &);
+      template <class zip_it_t, class kernel_T, class kernel_tab_T>
+      void coal_pairs_kernel(const zip_it_t &, const thrust_size_t &, const real_t &, const detail::collider_attrs<real_t> &, const detail::collider_sstp<real_t> &,
+        const detail::philox<real_t> &, const std::vector<kernel_T> &, const std::vector<kernel_tab_T> &, const bool &);
+      void hskpng_sstp_coal();
 
       void chem_vol_ante();
       void chem_flag_ante();
@@ -440,6 +632,20 @@ namespace libcloudphxx
       thrust_size_t rcyc();
       void bcnd();
 
+      // SDs leaving the domain through x boundaries are moved to other memory
+      bool distmem() const { return opts_init.dev_count > 1 || mpi_size > 1; }
+      bool distmem_mpi() const { return mpi_size > 1; }
+      void xchng_init_mpi();
+      std::vector<thrust_device::vector<real_t>*> xchng_real_vctrs();
+      void xchng_pack_real(const thrust_device::vector<thrust_size_t> &, const thrust_size_t &, thrust_device::vector<real_t> &, const thrust_size_t &);
+      void xchng_unpack_real(const thrust_device::vector<real_t> &, const thrust_size_t &, const thrust_size_t &);
+      void xchng_pack_id(const thrust_device::vector<thrust_size_t> &, const thrust_size_t &, thrust_device::vector<sd_id_t> &, const thrust_size_t &);
+      void xchng_unpack_id(const thrust_device::vector<sd_id_t> &, const thrust_size_t &, const thrust_size_t &);
+      void xchng_sds_mpi_post();
+      void xchng_sds_mpi_wait();
+      void xchng_courants_mpi_post();
+      void xchng_courants_mpi_wait();
+
       void src(const real_t &dt);
 
       void sstp_step(const int &step, const bool &var_rho);
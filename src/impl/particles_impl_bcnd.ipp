@@ -81,7 +81,7 @@ namespace libcloudphxx
         {
           // hardcoded periodic boundary in x! (TODO - as an option)
           // when working on a single GPU simply apply bcond
-          if(opts_init.dev_count < 2)
+          if(!distmem())
           {
             thrust::transform(
               x.begin(), x.end(),
@@ -89,7 +89,7 @@ namespace libcloudphxx
               detail::periodic<real_t>(opts_init.x0, opts_init.x1)
             );
           }
-          // more than one GPU - save ids of particles that need to be copied left/right
+          // more than one GPU or MPI rank - save ids of particles that need to be copied left/right
           else
           {
 	    namespace arg = thrust::placeholders;
@@ -113,8 +113,10 @@ namespace libcloudphxx
               arg::_1 >= opts_init.x1
             ) - rgt_id.begin();
 
-            if(lft_count > in_n_bfr.size() || rgt_count > in_n_bfr.size())
-              throw std::runtime_error(detail::formatter() << "Overflow of the in int buffer, bfr size: " << in_n_bfr.size() << " to be copied left: " << lft_count << " right: " << rgt_count); // TODO: resize buffers?
+            // MPI: half of the buffer for each direction
+            const thrust_size_t bfr_size = in_n_bfr.size() / (distmem_mpi() ? 2 : 1);
+            if(lft_count > bfr_size || rgt_count > bfr_size)
+              throw std::runtime_error(detail::formatter() << "Overflow of the in int buffer, bfr size: " << bfr_size << " to be copied left: " << lft_count << " right: " << rgt_count); // TODO: resize buffers?
           }
 
           // hardcoded periodic boundary in y! (TODO - as an option)
@@ -0,0 +1,142 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  * @brief saving and restoring the complete state of the particles (see detail/checkpoint.hpp for the file layout)
+  */
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::checkpoint(const std::string &path)
+    {
+      detail::ckpt_writer ckpt(path);
+
+      // per-particle attributes and housekeeping data
+      ckpt.write("n",          n);
+      ckpt.write("sd_id",      sd_id);
+      ckpt.write_bytes("sd_id_ctr", &sd_id_ctr, sizeof(sd_id_ctr));
+      ckpt.write("rd3",        rd3);
+      ckpt.write("rw2",        rw2);
+      ckpt.write("kpa",        kpa);
+      ckpt.write("vt",         vt);
+      ckpt.write("ijk",        ijk);
+      ckpt.write("sorted_id",  sorted_id);
+      ckpt.write("sorted_ijk", sorted_ijk);
+      if (opts_init.nx != 0) { ckpt.write("x", x); ckpt.write("i", i); }
+      if (opts_init.ny != 0) { ckpt.write("y", y); ckpt.write("j", j); }
+      if (opts_init.nz != 0) { ckpt.write("z", z); ckpt.write("k", k); }
+
+      // substepping (per particle with exact_sstp_cond, per cell otherwise)
+      ckpt.write("sstp_tmp_rv", sstp_tmp_rv);
+      ckpt.write("sstp_tmp_th", sstp_tmp_th);
+      ckpt.write("sstp_tmp_rh", sstp_tmp_rh);
+      ckpt.write("sstp_coal_cell", sstp_coal_cell);
+      ckpt.write("cond_drw2_dt", cond_drw2_dt); // empty unless cond_solver_t::newton
+
+      if (opts_init.chem_switch)
+      {
+        ckpt.write("chem", chem_mtx);
+        ckpt.write("sstp_tmp_chem_0", sstp_tmp_chem_0);
+        ckpt.write("sstp_tmp_chem_1", sstp_tmp_chem_1);
+        ckpt.write("sstp_tmp_chem_2", sstp_tmp_chem_2);
+        ckpt.write("sstp_tmp_chem_3", sstp_tmp_chem_3);
+        ckpt.write("sstp_tmp_chem_4", sstp_tmp_chem_4);
+        ckpt.write("sstp_tmp_chem_5", sstp_tmp_chem_5);
+      }
+
+      // accumulated outflow, in the order of output_t
+      {
+        std::vector<real_t> puddle(chem_all+2);
+        for(int o=0; o < chem_all+2; ++o)
+          puddle[o] = output_puddle[static_cast<output_t>(o)];
+        ckpt.write("puddle", puddle);
+      }
+
+      detail::ckpt_header_t hdr = detail::ckpt_header_t();
+      hdr.real_size   = sizeof(real_t);
+      hdr.n_t_size    = sizeof(n_t);
+      hdr.nx          = opts_init.nx;
+      hdr.ny          = opts_init.ny;
+      hdr.nz          = opts_init.nz;
+      hdr.n_cell      = n_cell;
+      hdr.n_part      = n_part;
+      hdr.rng_ctr     = rng.get_ctr();
+      hdr.stp_ctr     = stp_ctr;
+      hdr.reorder_ctr = reorder_ctr;
+      hdr.sstp_coal   = opts_init.sstp_coal;
+      hdr.sorted      = sorted;
+      hdr.presorted   = presorted;
+      ckpt.close(hdr);
+    }
+
+    // to be called in place of the SD initialisation, i.e. after init_eulerian()
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::restore(const std::string &path)
+    {
+      detail::ckpt_reader ckpt(path);
+
+      if (ckpt.hdr.real_size != sizeof(real_t) || ckpt.hdr.n_t_size != sizeof(n_t))
+        throw std::runtime_error(detail::formatter() << "checkpoint file " << path << " was written with a different floating-point or multiplicity type");
+      if (ckpt.hdr.nx != opts_init.nx || ckpt.hdr.ny != opts_init.ny || ckpt.hdr.nz != opts_init.nz || ckpt.hdr.n_cell != n_cell)
+        throw std::runtime_error(detail::formatter() << "checkpoint file " << path << " was written for a grid of "
+          << ckpt.hdr.nx << "x" << ckpt.hdr.ny << "x" << ckpt.hdr.nz << " cells, but nx, ny, nz = "
+          << opts_init.nx << ", " << opts_init.ny << ", " << opts_init.nz);
+
+      // allocation (throws if n_part > n_sd_max)
+      n_part = ckpt.hdr.n_part;
+      n_part_old = n_part;
+      hskpng_resize_npart();
+
+      ckpt.read("n",          n,          n_part);
+      ckpt.read("sd_id",      sd_id,      n_part);
+      ckpt.read_bytes("sd_id_ctr", &sd_id_ctr, sizeof(sd_id_ctr)); // after hskpng_resize_npart(), which gave out new ids
+      ckpt.read("rd3",        rd3,        n_part);
+      ckpt.read("rw2",        rw2,        n_part);
+      ckpt.read("kpa",        kpa,        n_part);
+      ckpt.read("vt",         vt,         n_part);
+      ckpt.read("ijk",        ijk,        n_part);
+      ckpt.read("sorted_id",  sorted_id,  n_part);
+      ckpt.read("sorted_ijk", sorted_ijk, n_part);
+      if (opts_init.nx != 0) { ckpt.read("x", x, n_part); ckpt.read("i", i, n_part); }
+      if (opts_init.ny != 0) { ckpt.read("y", y, n_part); ckpt.read("j", j, n_part); }
+      if (opts_init.nz != 0) { ckpt.read("z", z, n_part); ckpt.read("k", k, n_part); }
+
+      ckpt.read("sstp_tmp_rv", sstp_tmp_rv);
+      ckpt.read("sstp_tmp_th", sstp_tmp_th);
+      ckpt.read("sstp_tmp_rh", sstp_tmp_rh);
+      ckpt.read("sstp_coal_cell", sstp_coal_cell, sstp_coal_cell.size()); // n_cell with adaptive_sstp_coal, empty otherwise
+      ckpt.read("cond_drw2_dt", cond_drw2_dt, cond_drw2_dt.size()); // n_part with cond_solver_t::newton (see hskpng_resize_npart()), empty otherwise
+
+      if (opts_init.chem_switch)
+      {
+        // allocation and the per-species iterators
+        init_chem();
+        ckpt.read("chem", chem_mtx, chem_mtx.size());
+        ckpt.read("sstp_tmp_chem_0", sstp_tmp_chem_0);
+        ckpt.read("sstp_tmp_chem_1", sstp_tmp_chem_1);
+        ckpt.read("sstp_tmp_chem_2", sstp_tmp_chem_2);
+        ckpt.read("sstp_tmp_chem_3", sstp_tmp_chem_3);
+        ckpt.read("sstp_tmp_chem_4", sstp_tmp_chem_4);
+        ckpt.read("sstp_tmp_chem_5", sstp_tmp_chem_5);
+      }
+
+      {
+        std::vector<real_t> puddle;
+        ckpt.read("puddle", puddle, chem_all+2);
+        for(int o=0; o < chem_all+2; ++o)
+          output_puddle[static_cast<output_t>(o)] = puddle[o];
+      }
+
+      rng.set_ctr(ckpt.hdr.rng_ctr);
+      stp_ctr = ckpt.hdr.stp_ctr;
+      reorder_ctr = ckpt.hdr.reorder_ctr;
+      opts_init.sstp_coal = ckpt.hdr.sstp_coal;
+      sorted = ckpt.hdr.sorted;
+      presorted = ckpt.hdr.presorted;
+    }
+  };
+};
@@ -144,14 +144,18 @@ namespace libcloudphxx
           dt(dt), V(V), T(T), m_H(m_H), n_part(V.size()), chem_flag(chem_flag)
         {}
 
+        // psi is either the chem_rhs_range() block of chem_mtx or one of the odeint temporaries
+        template <class state_t>
         void operator()(
-          const thrust_device::vector<real_t> &psi, 
+          const state_t &psi, 
           thrust_device::vector<real_t> &dot_psi,
           const real_t /* t */
         )
         {
+          const typename thrust_device::vector<real_t>::const_iterator psi_bgn = boost::begin(psi);
+
           thrust::fill(dot_psi.begin(), dot_psi.end(), real_t(0));
-          assert(dot_psi.size() == psi.size());
+          assert(dot_psi.size() == boost::size(psi));
 
           typedef thrust::zip_iterator<
             thrust::tuple<
@@ -180,10 +184,10 @@ namespace libcloudphxx
                   // input - 2nd arg
 	          zip_it_t(thrust::make_tuple(
                     T,
-                    psi.begin() + (SO2  - chem_rhs_beg) * n_part, 
-                    psi.begin() + (S_VI - chem_rhs_beg) * n_part, 
-                    psi.begin() + (H2O2 - chem_rhs_beg) * n_part, 
-                    psi.begin() + (O3   - chem_rhs_beg) * n_part,
+                    psi_bgn + (SO2  - chem_rhs_beg) * n_part, 
+                    psi_bgn + (S_VI - chem_rhs_beg) * n_part, 
+                    psi_bgn + (H2O2 - chem_rhs_beg) * n_part, 
+                    psi_bgn + (O3   - chem_rhs_beg) * n_part,
                     m_H
                   )), 
                   // chemical reactions are only done for selected droplets 
@@ -282,7 +286,7 @@ namespace libcloudphxx
           chem_bgn[H], 
           chem_flag
         ), // TODO: make it an impl member field
-        chem_rhs, 
+        chem_rhs_range(), 
         real_t(0),
         dt
       );
@@ -5,6 +5,7 @@
   * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
   */
 
+#include <thrust/binary_search.h>
 
 namespace libcloudphxx
 {
@@ -12,57 +13,57 @@ namespace libcloudphxx
   {
     namespace detail
     {
-      enum{na_ge_nb = -2, nb_gt_na = -1};
+      // raw pointers to the optional attributes updated in the same pass as n, rw2, rd3 and vt
+      template <typename real_t>
+      struct collider_attrs
+      {
+        real_t *kpa;               // kappa (used if mixing kappas)
+        real_t *chem;              // dissolved chemical species, chem_all rows of chem_stride (used if chem_switch)
+        thrust_size_t chem_stride;
+      };
+
+      // per-cell coalescence substepping (used if adaptive_sstp_coal)
+      template <typename real_t>
+      struct collider_sstp
+      {
+        const unsigned int *n_sub; // number of substeps in each cell (NULL if not adaptive)
+        const thrust_size_t *ijk;  // cell index of each (sorted) SD, i.e. sorted_ijk
+        real_t *prob;              // output: max over substeps of the collision probability of each pair per whole timestep, indexed with ix_a
+      };
 
-      struct summator
+      // stores the position of the first SD of each cell (off) for SDs grouped by cell in any order of cells
+      struct cell_start
       {
-        template<class tpl_t>
+        const thrust_size_t *ijk;
+        thrust_size_t *off;
+        cell_start(const thrust_size_t *ijk, thrust_size_t *off) : ijk(ijk), off(off) {}
+
         BOOST_GPU_ENABLED
-        void operator()(tpl_t tpl)
+        void operator()(const thrust_size_t &ix) const
         {
-          if(thrust::get<2>(tpl) <= 0) return; // do nothing if no collisions or first one passed was a SD with an uneven number in the cell
-          thrust::get<3>(tpl) == na_ge_nb ?    // does the first SD of the pair have greater multiplicity?
-            thrust::get<1>(tpl) += thrust::get<2>(tpl) * thrust::get<0>(tpl): // add col_no *val(SD with greater multiplicity) to the one with smaller multiplicity
-            thrust::get<0>(tpl) += thrust::get<2>(tpl) * thrust::get<1>(tpl); // add col_no *val(SD with greater multiplicity) to the one with smaller multiplicity
+          if (ix == 0 || ijk[ix - 1] != ijk[ix]) off[ijk[ix]] = ix;
         }
       };
 
-      template<class real_t>
-      struct weighted_summator
+      // per-cell coalescence substep count for the next timestep: increased at once to keep
+      // the pair probabilities below prob_max (up to n_max), decreased to what is needed, but at most halved per timestep
+      template <typename real_t>
+      struct sstp_coal_adjust
       {
-        template<class tpl_t>
+        const real_t prob_max;
+        const unsigned int n_max;
+        sstp_coal_adjust(const real_t &prob_max, const unsigned int &n_max) : prob_max(prob_max), n_max(n_max) {}
+
         BOOST_GPU_ENABLED
-        void operator()(tpl_t tpl)
+        unsigned int operator()(const unsigned int &n_sub, const real_t &prob) const
         {
-          if(thrust::get<4>(tpl) <= 0) return; // do nothing if no collisions or first one passed was a SD with an uneven number in the cell
-
-          // previous value of dry radius of the one with smaller multiplicity, it was allready updated in collide
-          real_t rd3_old = 
-            thrust::get<5>(tpl) == na_ge_nb ?    // does the first SD of the pair have greater multiplicity?
-              thrust::get<3>(tpl) - thrust::get<4>(tpl) * thrust::get<2>(tpl) : // rd3_old = rd3_new - col_no * rd3_old_a
-              thrust::get<2>(tpl) - thrust::get<4>(tpl) * thrust::get<3>(tpl);  // rd3_old = rd3_new - col_no * rd3_old_b
-
-          for(int ci=0; ci<thrust::get<4>(tpl); ++ci) // loop over collisions between the pair
-          {
-            if(thrust::get<5>(tpl) == na_ge_nb)    // first SD of the pair has greater multiplicity
-            {
-              // update kappa_b
-              thrust::get<1>(tpl) =  (thrust::get<0>(tpl) * thrust::get<2>(tpl) + // kappa_a * rd3_a
-                                     thrust::get<1>(tpl) * rd3_old) /             // kappa_b * rd3_b_previous
-                                     (thrust::get<2>(tpl) + rd3_old);             // rd3_a + rd3_b_previous
-              // update rd3_old after collision
-              rd3_old += thrust::get<2>(tpl); // add rd3_a
-            }
-            else    // second SD of the pair has greater multiplicity
-            {
-              // update kappa_a
-              thrust::get<0>(tpl) =  (thrust::get<1>(tpl) * thrust::get<3>(tpl) + // kappa_b * rd3_b
-                                     thrust::get<0>(tpl) * rd3_old) /             // kappa_a * rd3_a_previous
-                                     (thrust::get<3>(tpl) + rd3_old);             // rd3_b + rd3_b_previous
-              // update rd3_old after collision
-              rd3_old += thrust::get<3>(tpl); // add rd3_b
-            }
-          }
+#if !defined(__NVCC__)
+          using std::ceil;
+#endif
+          const real_t need = ceil(prob / prob_max);
+          if (need >= real_t(n_max)) return n_max;
+          if (need >= real_t(n_sub / 2)) return need > 1 ? (unsigned int)(need) : 1;
+          return n_sub / 2;
         }
       };
 
@@ -73,12 +74,14 @@ namespace libcloudphxx
         real_t operator()(const n_t &n)
         {
           // see section 5.1.3 in Shima et al. 2009
-          return n>1 ? (real_t(n*(n-1))/2) / (n/2) : 0; 
+          // (computed in real_t, n*(n-1) would overflow a 32-bit n_t for n > 65536)
+          return n>1 ? (real_t(n) * real_t(n-1) / 2) / (n/2) : 0; 
         }
       };
 
       // assumes _a have higher multiplicities
       template <typename real_t, typename n_t,
+        bool kpa_on, bool chem_on,
         int   n_a, int   n_b,
         int rw2_a, int rw2_b,
         int rd3_a, int rd3_b,
@@ -86,7 +89,10 @@ namespace libcloudphxx
         typename tup_t
       >
       BOOST_GPU_ENABLED
-      void collide(tup_t tpl, const n_t &col_no)
+      void collide(tup_t tpl, const n_t &col_no, 
+        const thrust_size_t &id_a, const thrust_size_t &id_b, 
+        const collider_attrs<real_t> &attrs
+      )
       {
 	// multiplicity change (eq. 12 in Shima et al. 2009)
 	thrust::get<n_a>(tpl) -= col_no * thrust::get<n_b>(tpl);
@@ -99,6 +105,12 @@ namespace libcloudphxx
 	  real_t(2./3)
 	);
 
+        // kappa change - mean weighted by dry volume (needs rd3_b from before the collision)
+        if (kpa_on)
+          attrs.kpa[id_b] = 
+            (col_no * attrs.kpa[id_a] * thrust::get<rd3_a>(tpl) + attrs.kpa[id_b] * thrust::get<rd3_b>(tpl)) /
+            (col_no * thrust::get<rd3_a>(tpl) + thrust::get<rd3_b>(tpl));
+
 	// dry radius change (eq. 13 in Shima et al. 2009)
 	thrust::get<rd3_b>(tpl) 
 	  = col_no *thrust::get<rd3_a>(tpl) + thrust::get<rd3_b>(tpl);
@@ -106,31 +118,39 @@ namespace libcloudphxx
 	// invalidating vt
 	thrust::get<vt_b>(tpl) = detail::invalid;
 
-	// TODO: kappa, chemistry (only if enabled)
+        // chemical species mass change
+        if (chem_on)
+          for (int i = 0; i < chem_all; ++i)
+          {
+            real_t *row = attrs.chem + i * attrs.chem_stride;
+            row[id_b] += col_no * row[id_a];
+          }
       }
 
-      template <typename real_t, typename n_t>
+      // kpa_on and chem_on select at compile time which of the optional attributes
+      // are updated along with n, rw2, rd3 and vt in a single pass over the pairs;
+      // kernel_T is the collision kernel type, its calc() is called directly (no virtual dispatch)
+      template <typename real_t, typename n_t, class kernel_T, bool kpa_on, bool chem_on>
       struct collider
       {
         // read-only parameters
         typedef thrust::tuple<
-          real_t,                       // random number (u01)
           real_t,                       // scaling factor
           thrust_size_t, thrust_size_t, // ix
           thrust_size_t, thrust_size_t, // off (index within cell)
-          real_t                       // dv
+          real_t,                       // dv
+          thrust_size_t, thrust_size_t  // id (sorted_id, i.e. index in the attribute vectors)
         > tpl_ro_t;
-        enum { u01_ix, scl_ix, ix_a_ix, ix_b_ix, off_a_ix, off_b_ix, dv_ix };
+        enum { scl_ix, ix_a_ix, ix_b_ix, off_a_ix, off_b_ix, dv_ix, id_a_ix, id_b_ix };
 
         // read-write parameters = return type
         typedef thrust::tuple<
           n_t,           n_t,           // n   (multiplicity)
           real_t,        real_t,        // rw2 (wet radius squared)
           real_t,        real_t,        // vt  (terminal velocity)
-          real_t,        real_t,        // rd3 (dry radius cubed)
-          real_t,        real_t         // number of collisions (output); same vector as u01!
+          real_t,        real_t         // rd3 (dry radius cubed)
         > tpl_rw_t;
-        enum { n_a_ix, n_b_ix, rw2_a_ix, rw2_b_ix, vt_a_ix, vt_b_ix, rd3_a_ix, rd3_b_ix, col_a_ix, col_b_ix };
+        enum { n_a_ix, n_b_ix, rw2_a_ix, rw2_b_ix, vt_a_ix, vt_b_ix, rd3_a_ix, rd3_b_ix };
 
         // read-only parameters passed to the calc function
         typedef thrust::tuple<
@@ -140,12 +160,15 @@ namespace libcloudphxx
         enum { rhod_ix, eta_ix };
 
         const real_t dt;
-        const kernel_base<real_t, n_t> *p_kernel;
+        const kernel_T kernel;
         const bool pure_const_multi;
         bool *increase_sstp_coal;
+        const collider_attrs<real_t> attrs;
+        const philox<real_t> rnd; // random numbers drawn inline, indexed with the position of the pair
+        const collider_sstp<real_t> sstp;
 
         //ctor
-        collider(const real_t &dt, kernel_base<real_t, n_t> *p_kernel, const bool pure_const_multi, bool *increase_sstp_coal) : dt(dt), p_kernel(p_kernel), pure_const_multi(pure_const_multi), increase_sstp_coal(increase_sstp_coal) {}
+        collider(const real_t &dt, const kernel_T &kernel, const bool pure_const_multi, bool *increase_sstp_coal, const collider_attrs<real_t> &attrs, const philox<real_t> &rnd, const collider_sstp<real_t> &sstp) : dt(dt), kernel(kernel), pure_const_multi(pure_const_multi), increase_sstp_coal(increase_sstp_coal), attrs(attrs), rnd(rnd), sstp(sstp) {}
 
         template <class tup_ro_rw_t>
         BOOST_GPU_ENABLED
@@ -170,36 +193,44 @@ namespace libcloudphxx
             const thrust_size_t &cix_b = thrust::get<ix_b_ix>(tpl_ro) - thrust::get<off_b_ix>(tpl_ro);
 
             // only droplets within the same cell
-            if (cix_a != cix_b - 1)
-            {
-              thrust::get<col_a_ix>(thrust::get<1>(tpl_ro_rw)) = real_t(0.);
-              return;
-            }
+            if (cix_a != cix_b - 1) return;
           }
 
+          // SDs emptied by an earlier (sub)step of this timestep are left alone
+          if (thrust::get<n_a_ix>(tpl_rw) == 0 || thrust::get<n_b_ix>(tpl_rw) == 0) return;
+
+          // per-cell substeps (only pairs in cells with more substeps than the current one are visited)
+          real_t dt_sub = dt;
+          if (sstp.n_sub != NULL)
+            dt_sub = dt / sstp.n_sub[sstp.ijk[thrust::get<ix_a_ix>(tpl_ro)]];
+
           //wrap the tpl_rw and tpl_ro_calc tuples to pass it to kernel
           tpl_calc_wrap<real_t,n_t> tpl_wrap(tpl_rw, tpl_ro_calc);
 
           // computing the probability of collision
-          real_t prob = dt / thrust::get<dv_ix>(tpl_ro)
+          real_t prob = dt_sub / thrust::get<dv_ix>(tpl_ro)
             * thrust::get<scl_ix>(tpl_ro)
-            * p_kernel->calc(tpl_wrap);
+            * kernel.calc(tpl_wrap);
+
+          if (sstp.n_sub != NULL) 
+          {
+            real_t &prob_dt = sstp.prob[thrust::get<ix_a_ix>(tpl_ro)];
+            if (prob * (dt / dt_sub) > prob_dt) prob_dt = prob * (dt / dt_sub);
+          }
   
-          n_t col_no = n_t(prob); //number of collisions between the pair; rint?
+          //number of collisions between the pair; rint?
+          //(saturated at the largest n_t, it is limited by n_a/n_b below anyway)
+          const n_t col_max = n_t(-1);
+          n_t col_no = prob < real_t(col_max) ? n_t(prob) : col_max;
 
-          if(pure_const_multi && col_no >= 1)
+          if(pure_const_multi && col_no >= 1 && sstp.n_sub == NULL)
           {
             *increase_sstp_coal = true;
           }
 
           // comparing the upscaled probability with a random number and returning if unlucky
-          if (thrust::get<u01_ix>(tpl_ro) < prob - col_no) ++col_no;
-          if(col_no == 0) 
-          {
-            thrust::get<col_a_ix>(thrust::get<1>(tpl_ro_rw)) = real_t(0.);
-            thrust::get<col_b_ix>(thrust::get<1>(tpl_ro_rw)) = real_t(0.);
-            return;
-          }
+          if (col_no < col_max && rnd.u01(thrust::get<ix_a_ix>(tpl_ro)) < prob - col_no) ++col_no;
+          if(col_no == 0) return;
 
 #if !defined(__NVCC__)
           using std::min;
@@ -210,31 +241,112 @@ namespace libcloudphxx
           {
             if(thrust::get<n_b_ix>(tpl_rw) > 0) 
               col_no = min( col_no, n_t(thrust::get<n_a_ix>(tpl_rw) / thrust::get<n_b_ix>(tpl_rw)));
-            collide<real_t, n_t,
+            collide<real_t, n_t, kpa_on, chem_on,
                 n_a_ix,   n_b_ix,
               rw2_a_ix, rw2_b_ix,
               rd3_a_ix, rd3_b_ix,
                vt_a_ix,  vt_b_ix
-            >(thrust::get<1>(tpl_ro_rw), col_no);
-            thrust::get<col_b_ix>(thrust::get<1>(tpl_ro_rw)) = real_t(na_ge_nb); // col vector for the second in a pair stores info on which one has greater multiplicity
+            >(thrust::get<1>(tpl_ro_rw), col_no, thrust::get<id_a_ix>(tpl_ro), thrust::get<id_b_ix>(tpl_ro), attrs);
           }
           else
           {
             if(thrust::get<n_a_ix>(tpl_rw) > 0) 
               col_no = min( col_no, n_t(thrust::get<n_b_ix>(tpl_rw) / thrust::get<n_a_ix>(tpl_rw)));
-            collide<real_t, n_t,
+            collide<real_t, n_t, kpa_on, chem_on,
                 n_b_ix,   n_a_ix,
               rw2_b_ix, rw2_a_ix,
               rd3_b_ix, rd3_a_ix,
                vt_b_ix,  vt_a_ix
-            >(thrust::get<1>(tpl_ro_rw), col_no);
-            thrust::get<col_b_ix>(thrust::get<1>(tpl_ro_rw)) = real_t(nb_gt_na); // col vector for the second in a pair stores info on which one has greater multiplicity
+            >(thrust::get<1>(tpl_ro_rw), col_no, thrust::get<id_b_ix>(tpl_ro), thrust::get<id_a_ix>(tpl_ro), attrs);
           }
-          thrust::get<col_a_ix>(thrust::get<1>(tpl_ro_rw)) = real_t(col_no); // col vector for the first in a pair stores info on number of collisions
         }
       };
+
+      // runs the collider over n_pair pairs, choosing the instantiation for the optional attributes
+      template <typename real_t, typename n_t, class kernel_T, class zip_it_t>
+      void coal_for_each(
+        const zip_it_t &zip_it, const thrust_size_t &n_pair, const kernel_T &kernel, 
+        const bool &kpa_on, const bool &chem_on,
+        const real_t &dt, const bool &pure_const_multi, bool *increase_sstp_coal, 
+        const collider_attrs<real_t> &attrs, const philox<real_t> &rnd, const collider_sstp<real_t> &sstp
+      )
+      {
+        if (kpa_on && chem_on)
+          thrust::for_each(zip_it, zip_it + n_pair, 
+            collider<real_t, n_t, kernel_T, true, true>(dt, kernel, pure_const_multi, increase_sstp_coal, attrs, rnd, sstp));
+        else if (kpa_on)
+          thrust::for_each(zip_it, zip_it + n_pair, 
+            collider<real_t, n_t, kernel_T, true, false>(dt, kernel, pure_const_multi, increase_sstp_coal, attrs, rnd, sstp));
+        else if (chem_on)
+          thrust::for_each(zip_it, zip_it + n_pair, 
+            collider<real_t, n_t, kernel_T, false, true>(dt, kernel, pure_const_multi, increase_sstp_coal, attrs, rnd, sstp));
+        else
+          thrust::for_each(zip_it, zip_it + n_pair, 
+            collider<real_t, n_t, kernel_T, false, false>(dt, kernel, pure_const_multi, increase_sstp_coal, attrs, rnd, sstp));
+      }
     };
 
+    template <typename real_t, backend_t device>
+    template <class zip_it_t>
+    void particles_t<real_t, device>::impl::coal_pairs(
+      const zip_it_t &zip_it, const thrust_size_t &n_pair, const real_t &dt, 
+      const detail::collider_attrs<real_t> &attrs, const detail::collider_sstp<real_t> &sstp
+    )
+    {
+      // random numbers for comparing with probability of collisions in a pair of droplets are drawn inline
+      const detail::philox<real_t> rnd(rng.next_stream());
+
+      // n, rw2, rd3, vt, kappa and chemistry updated in one pass, 
+      // with the pair loop instantiated for the kernel selected in opts_init
+      switch(opts_init.kernel)
+      {
+        case(kernel_t::golovin):
+          coal_pairs_kernel(zip_it, n_pair, dt, attrs, sstp, rnd, k_golovin, k_golovin, false);
+          break;
+        case(kernel_t::geometric):
+          if(n_user_params == 1)
+            coal_pairs_kernel(zip_it, n_pair, dt, attrs, sstp, rnd, k_geometric_with_multiplier, k_geometric_with_multiplier, false);
+          else
+            coal_pairs_kernel(zip_it, n_pair, dt, attrs, sstp, rnd, k_geometric, k_geometric, false);
+          break;
+        case(kernel_t::Long):
+          coal_pairs_kernel(zip_it, n_pair, dt, attrs, sstp, rnd, k_long, k_long_tab, opts_init.tab_kernel);
+          break;
+        case(kernel_t::hall):
+        case(kernel_t::hall_davis_no_waals):
+        case(kernel_t::vohl_davis_no_waals):
+        case(kernel_t::hall_pinsky_stratocumulus):
+        case(kernel_t::hall_pinsky_cumulonimbus):
+        case(kernel_t::hall_pinsky_1000mb_grav):
+          coal_pairs_kernel(zip_it, n_pair, dt, attrs, sstp, rnd, k_geometric_with_efficiencies, k_geometric_with_efficiencies_tab, opts_init.tab_kernel);
+          break;
+        case(kernel_t::onishi_hall):
+        case(kernel_t::onishi_hall_davis_no_waals):
+          coal_pairs_kernel(zip_it, n_pair, dt, attrs, sstp, rnd, k_onishi, k_onishi_tab, opts_init.tab_kernel);
+          break;
+        default:
+          throw std::runtime_error("coal(): unsupported kernel");
+      }
+    }
+
+    // the pair loop for a given kernel, exact or tabulated (see init_kernel()); 
+    // kernel_tab_T is kernel_T for the kernels with no tabulated variant
+    template <typename real_t, backend_t device>
+    template <class zip_it_t, class kernel_T, class kernel_tab_T>
+    void particles_t<real_t, device>::impl::coal_pairs_kernel(
+      const zip_it_t &zip_it, const thrust_size_t &n_pair, const real_t &dt, 
+      const detail::collider_attrs<real_t> &attrs, const detail::collider_sstp<real_t> &sstp,
+      const detail::philox<real_t> &rnd, 
+      const std::vector<kernel_T> &kernel, const std::vector<kernel_tab_T> &kernel_tab, const bool &tab
+    )
+    {
+      assert(tab ? !kernel_tab.empty() : !kernel.empty());
+      if(tab)
+        detail::coal_for_each<real_t, n_t>(zip_it, n_pair, kernel_tab[0], attrs.kpa != NULL, attrs.chem != NULL, dt, pure_const_multi, increase_sstp_coal, attrs, rnd, sstp);
+      else
+        detail::coal_for_each<real_t, n_t>(zip_it, n_pair, kernel[0], attrs.kpa != NULL, attrs.chem != NULL, dt, pure_const_multi, increase_sstp_coal, attrs, rnd, sstp);
+    }
+
     template <typename real_t, backend_t device>
     void particles_t<real_t, device>::impl::coal(const real_t &dt)
     {   
@@ -252,9 +364,7 @@ namespace libcloudphxx
 
       // references to tmp data
       thrust_device::vector<real_t> 
-        &scl(tmp_device_real_cell), // scale factor for probablility
-        &col(tmp_device_real_part); // number of collisions, used in chemistry, NOTE: it's the same as u01, so it overwrites already used random numbers
-                                    // 1st one of a pair stores number of collisions, 2nd one stores info on which one has greater multiplicity
+        &scl(tmp_device_real_cell); // scale factor for probablility
       thrust_device::vector<thrust_size_t> 
         &off(tmp_device_size_cell); // offset for getting index of particle within a cell
 
@@ -289,9 +399,6 @@ namespace libcloudphxx
       );
 //      nancheck(off, "off - droplet index within a cell");
 
-      // tossing n_part/2 random numbers for comparing with probability of collisions in a pair of droplets
-      rand_u01(n_part);
-
       // colliding
       typedef thrust::permutation_iterator<
         typename thrust_device::vector<thrust_size_t>::iterator,
@@ -303,7 +410,7 @@ namespace libcloudphxx
         typename thrust_device::vector<thrust_size_t>::iterator
       > pi_real_t;
 
-      typedef  typename thrust_device::vector<real_t>::iterator i_real_t;
+      typedef  typename thrust_device::vector<thrust_size_t>::iterator i_size_t;
 
       typedef thrust::permutation_iterator<
         typename thrust_device::vector<n_t>::iterator,
@@ -312,12 +419,12 @@ namespace libcloudphxx
 
       typedef thrust::zip_iterator<
         thrust::tuple< 
-          i_real_t,                                                // u01
           pi_real_t,                                               // scl
           thrust::counting_iterator<thrust_size_t>,                // ix_a
           thrust::counting_iterator<thrust_size_t>,                // ix_b
           pi_size_t, pi_size_t,                                    // off_a & off_b
-          pi_real_t                                                // dv
+          pi_real_t,                                               // dv
+          i_size_t, i_size_t                                       // id_a & id_b
         >
       > zip_ro_t;
 
@@ -326,8 +433,7 @@ namespace libcloudphxx
           pi_n_t,    pi_n_t,    // n_a,   n_b
           pi_real_t, pi_real_t, // rw2_a, rw2_b
           pi_real_t, pi_real_t, // vt_a,  vt_b
-          pi_real_t, pi_real_t, // vt_a,  vt_b
-          i_real_t, i_real_t    // col_a, col_b 
+          pi_real_t, pi_real_t  // rd3_a, rd3_b
         >
       > zip_rw_t;
 
@@ -340,8 +446,6 @@ namespace libcloudphxx
 
       zip_ro_t zip_ro_it(
         thrust::make_tuple(
-          // u01
-          u01.begin(),
           // scl
           thrust::make_permutation_iterator(scl.begin(), sorted_ijk.begin()), 
           // ix
@@ -351,7 +455,10 @@ namespace libcloudphxx
           thrust::make_permutation_iterator(off.begin(), sorted_ijk.begin()), 
           thrust::make_permutation_iterator(off.begin(), sorted_ijk.begin())+1,
           // dv
-          thrust::make_permutation_iterator(dv.begin(), sorted_ijk.begin())
+          thrust::make_permutation_iterator(dv.begin(), sorted_ijk.begin()),
+          // id
+          sorted_id.begin(),
+          sorted_id.begin()+1
         )
       );
 
@@ -377,71 +484,157 @@ namespace libcloudphxx
           thrust::make_permutation_iterator(vt.begin(),  sorted_id.begin())+1,  
           // dry radius cubed
           thrust::make_permutation_iterator(rd3.begin(), sorted_id.begin()), 
-          thrust::make_permutation_iterator(rd3.begin(), sorted_id.begin())+1,
-          // output
-          col.begin(),  // number of collisions
-          col.begin()+1 // which one has greater multiplicity
+          thrust::make_permutation_iterator(rd3.begin(), sorted_id.begin())+1
         )
       );
 
-      thrust::for_each(
-        thrust::make_zip_iterator(thrust::make_tuple(zip_ro_it, zip_rw_it, zip_ro_calc_it)),
-        thrust::make_zip_iterator(thrust::make_tuple(zip_ro_it, zip_rw_it, zip_ro_calc_it)) + n_part - 1,
-        detail::collider<real_t, n_t>(dt, p_kernel, pure_const_multi, increase_sstp_coal)
-      );
-   //   nancheck(n, "n - post coalescence");
-      nancheck(rw2, "rw2 - post coalescence");
-      nancheck(rd3, "rd3 - post coalescence");
-      nancheck(vt, "vt - post coalescence");
-      nancheck(col, "col - post coalescence");
+      typedef thrust::zip_iterator<
+        thrust::tuple<
+          zip_ro_t, zip_rw_t, zip_ro_calc_t
+        >
+      > zip_t;
+
+      zip_t zip_it(thrust::make_tuple(zip_ro_it, zip_rw_it, zip_ro_calc_it));
+
+      // optional attributes, modified through raw pointers indexed with sorted_id
+      const bool kpa_on = opts_init.dry_distros.size() + opts_init.dry_sizes.size() > 1;
+      const bool chem_on = opts_init.chem_switch;
+
+      detail::collider_attrs<real_t> attrs;
+      attrs.kpa = kpa_on ? thrust::raw_pointer_cast(kpa.data()) : NULL;
+      attrs.chem = chem_on ? thrust::raw_pointer_cast(chem_mtx.data()) : NULL;
+      attrs.chem_stride = n_part;
 
-      // add masses of chemicals
-      if(opts_init.chem_switch)
+      detail::collider_sstp<real_t> sstp;
+      sstp.n_sub = NULL;
+
+      if (!opts_init.adaptive_sstp_coal)
       {
-        for(int i=0; i<chem_all; ++i)
+        // dt is the substep length, all pairs (the collider skips those not within a cell)
+        coal_pairs(zip_it, n_part - 1, dt, attrs, sstp);
+      }
+      else
+      {
+        // per-cell substepping: after the shuffle and sort by cell, the SDs are regrouped (stably,
+        // i.e. still by cell) in the order of decreasing number of substeps in their cell, so that 
+        // the SDs in cells that have substeps left form a prefix of the sorted order; between substeps,
+        // the SDs are reshuffled within these cells (new random pairs, as with the global sstp_coal)
+        // and only their terminal velocities are recomputed
+        sstp.n_sub = thrust::raw_pointer_cast(sstp_coal_cell.data());
+        sstp.ijk = thrust::raw_pointer_cast(sorted_ijk.data());
+        sstp.prob = thrust::raw_pointer_cast(tmp_device_real_part.data());
+        thrust::fill(tmp_device_real_part.begin(), tmp_device_real_part.end(), real_t(0));
+
+        auto sstp_key_tmp = tmp_size_pool.acquire(n_part);
+        auto cell_key_tmp = tmp_size_pool.acquire(n_part);
+        thrust_device::vector<thrust_size_t> 
+          &sstp_key(*sstp_key_tmp), // number of substeps in the cell of each SD (in the sorted order)
+          &cell_key(*cell_key_tmp); // position of the first SD of the cell of each SD (ditto)
+
+        typedef thrust::zip_iterator<
+          thrust::tuple<
+            typename thrust_device::vector<thrust_size_t>::iterator, 
+            typename thrust_device::vector<thrust_size_t>::iterator
+          >
+        > zip_sorted_t;
+        const zip_sorted_t sorted_it(thrust::make_tuple(sorted_id.begin(), sorted_ijk.begin()));
+
+        thrust::copy(
+          thrust::make_permutation_iterator(sstp_coal_cell.begin(), sorted_ijk.begin()),
+          thrust::make_permutation_iterator(sstp_coal_cell.begin(), sorted_ijk.begin()) + n_part,
+          sstp_key.begin()
+        );
+        thrust::stable_sort_by_key(
+          sstp_key.begin(), sstp_key.begin() + n_part,
+          sorted_it,
+          thrust::greater<thrust_size_t>()
+        );
+        thrust::for_each(zero, zero + n_part, 
+          detail::cell_start(thrust::raw_pointer_cast(sorted_ijk.data()), thrust::raw_pointer_cast(off.data()))
+        );
+
+        const unsigned int sstp_max = n_part > 0 ? sstp_key[0] : 0;
+        thrust_size_t n_sd_step = n_part; // SDs in cells with more than step substeps
+        for (unsigned int step = 0; step < sstp_max; ++step) 
         {
-          thrust::for_each(
-            thrust::make_zip_iterator(thrust::make_tuple(
-              thrust::make_permutation_iterator(chem_bgn[i], sorted_id.begin()),
-              thrust::make_permutation_iterator(chem_bgn[i], sorted_id.begin())+1,
-              col.begin(),
-              col.begin()+1
-            )),
-            thrust::make_zip_iterator(thrust::make_tuple(
-              thrust::make_permutation_iterator(chem_bgn[i], sorted_id.begin()),
-              thrust::make_permutation_iterator(chem_bgn[i], sorted_id.begin())+1,
-              col.begin(),
-              col.begin()+1
-            )) + n_part -1,
-            detail::summator()
-          );
-          nancheck_range(chem_bgn[i], chem_bgn[i] + n_part - 1, "chem - post coalescence");
+          // new random pairs: the SDs in random order, then stably back into the positions of their cells
+          if (step > 0)
+          {
+            rand_un(n_sd_step);
+            thrust::sort_by_key(un.begin(), un.begin() + n_sd_step, sorted_it);
+            thrust::copy(
+              thrust::make_permutation_iterator(off.begin(), sorted_ijk.begin()),
+              thrust::make_permutation_iterator(off.begin(), sorted_ijk.begin()) + n_sd_step,
+              cell_key.begin()
+            );
+            thrust::stable_sort_by_key(cell_key.begin(), cell_key.begin() + n_sd_step, sorted_it);
+          }
+
+          // collide (dt is divided by the number of substeps in each cell)
+          coal_pairs(zip_it, n_sd_step - 1, dt, attrs, sstp);
+
+          if (step + 1 == sstp_max) break;
+
+          n_sd_step = thrust::lower_bound(
+            sstp_key.begin(), sstp_key.begin() + n_sd_step, 
+            thrust_size_t(step + 1), thrust::greater<thrust_size_t>()
+          ) - sstp_key.begin();
+
+          // update invalid vterm of the SDs that take part in the next substep
+          hskpng_vterm_invalid(sorted_id.begin(), n_sd_step); 
         }
+
+        // back in the order of cells (sorted_ijk stays valid for the incremental sort)
+        thrust::stable_sort_by_key(sorted_ijk.begin(), sorted_ijk.begin() + n_part, sorted_id.begin());
       }
-      // add kappas
-      if(opts_init.dry_distros.size() + opts_init.dry_sizes.size() > 1)
+
+   //   nancheck(n, "n - post coalescence");
+      nancheck(rw2, "rw2 - post coalescence");
+      nancheck(rd3, "rd3 - post coalescence");
+      nancheck(vt, "vt - post coalescence");
+      if (kpa_on) nancheck(kpa, "kpa - post coalescence");
+      if (chem_on)
+        for(int i=0; i<chem_all; ++i)
+          nancheck_range(chem_bgn[i], chem_bgn[i] + n_part, "chem - post coalescence");
+
+      // per-cell maximum of the pair probabilities (stored in tmp_device_real_cell1 for hskpng_sstp_coal())
+      if (opts_init.adaptive_sstp_coal)
       {
-        thrust::for_each(
-          thrust::make_zip_iterator(thrust::make_tuple(
-            thrust::make_permutation_iterator(kpa.begin(), sorted_id.begin()),    // values to be added
-            thrust::make_permutation_iterator(kpa.begin(), sorted_id.begin())+1,
-            thrust::make_permutation_iterator(rd3.begin(), sorted_id.begin()),    // weighting factors
-            thrust::make_permutation_iterator(rd3.begin(), sorted_id.begin())+1,
-            col.begin(),                                                          // collision information
-            col.begin()+1
-          )),
-          thrust::make_zip_iterator(thrust::make_tuple(
-            thrust::make_permutation_iterator(kpa.begin(), sorted_id.begin()),
-            thrust::make_permutation_iterator(kpa.begin(), sorted_id.begin())+1,
-            thrust::make_permutation_iterator(rd3.begin(), sorted_id.begin()),
-            thrust::make_permutation_iterator(rd3.begin(), sorted_id.begin())+1,
-            col.begin(),
-            col.begin()+1
-          )) + n_part -1,
-          detail::weighted_summator<real_t>()
+        thrust_device::vector<real_t> 
+          &prob_max(tmp_device_real_cell1),
+          &prob_max_cnt(tmp_device_real_cell); // values for the count_n cells with SDs (scl no longer needed)
+        thrust::fill(prob_max.begin(), prob_max.end(), real_t(0));
+
+        thrust::pair<
+          thrust_device::vector<thrust_size_t>::iterator,
+          typename thrust_device::vector<real_t>::iterator
+        > it = thrust::reduce_by_key(
+          sorted_ijk.begin(), sorted_ijk.end(),
+          tmp_device_real_part.begin(),
+          count_ijk.begin(),
+          prob_max_cnt.begin(),
+          thrust::equal_to<thrust_size_t>(),
+          thrust::maximum<real_t>()
+        );
+        count_n = it.first - count_ijk.begin();
+
+        thrust::copy(
+          prob_max_cnt.begin(), prob_max_cnt.begin() + count_n,                   // input
+          thrust::make_permutation_iterator(prob_max.begin(), count_ijk.begin())  // output
         );
-        nancheck(kpa, "kpa - post coalescence");
       }
     }
+
+    // sets the number of coalescence substeps in each cell for the next timestep
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::hskpng_sstp_coal()
+    {   
+      thrust::transform(
+        sstp_coal_cell.begin(), sstp_coal_cell.end(), // input - 1st arg
+        tmp_device_real_cell1.begin(),                // input - 2nd arg: max pair probability per timestep
+        sstp_coal_cell.begin(),                       // output
+        detail::sstp_coal_adjust<real_t>(config.coal_prob_max, opts_init.sstp_coal_max)
+      );
+    }
   };  
 };
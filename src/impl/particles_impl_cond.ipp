@@ -17,7 +17,7 @@ namespace libcloudphxx
 
       // --- calc liquid water content before cond ---
       hskpng_sort(); 
-      thrust_device::vector<real_t> &drv(tmp_device_real_cell);
+      thrust_device::vector<acc_t> &drv(tmp_device_acc_cell);
 
       // calculating the 3rd wet moment before condensation
       moms_all();
@@ -26,32 +26,45 @@ namespace libcloudphxx
 
       // permute-copying the result to -dm_3
       // fill with 0s if not all cells will be updated in the following transform
-      if(count_n!=n_cell)  thrust::fill(drv.begin(), drv.end(), real_t(0.));
+      if(count_n!=n_cell)  thrust::fill(drv.begin(), drv.end(), acc_t(0.));
       thrust::transform(
         count_mom.begin(), count_mom.begin() + count_n,                    // input - 1st arg
         thrust::make_permutation_iterator(drv.begin(), count_ijk.begin()), // output
-        thrust::negate<real_t>()
+        thrust::negate<acc_t>()
       );
 
       // calculating drop growth in a timestep using backward Euler 
-      thrust::transform(
-        rw2.begin(), rw2.end(),         // input - 1st arg (zip not as 1st arg not to write zip.end()
-        thrust::make_zip_iterator(      // input - 2nd arg
+      cond_advance_rw2(
+        zero, n_part,
+        thrust::make_zip_iterator(      // per-particle state
           thrust::make_tuple(
-            thrust::make_permutation_iterator(rhod.begin(), ijk.begin()),
-            thrust::make_permutation_iterator(rv.begin(), ijk.begin()),
-            thrust::make_permutation_iterator(T.begin(), ijk.begin()),
-            thrust::make_permutation_iterator(p.begin(), ijk.begin()),
-            thrust::make_permutation_iterator(RH.begin(), ijk.begin()),
-            thrust::make_permutation_iterator(eta.begin(), ijk.begin()),
-            rd3.begin(),
-            kpa.begin(),
-            vt.begin()
+            thrust::make_zip_iterator(
+              thrust::make_tuple(
+                thrust::make_permutation_iterator(rhod.begin(), ijk.begin()),
+                thrust::make_permutation_iterator(rv.begin(), ijk.begin()),
+                thrust::make_permutation_iterator(T.begin(), ijk.begin()),
+                thrust::make_permutation_iterator(p.begin(), ijk.begin()),
+                thrust::make_permutation_iterator(RH.begin(), ijk.begin()),
+                thrust::make_permutation_iterator(eta.begin(), ijk.begin()),
+                rd3.begin(),
+                kpa.begin(),
+                vt.begin()
+              )
+            ),
+            // per-cell coefficients computed in hskpng_Tpr
+            thrust::make_zip_iterator(
+              thrust::make_tuple(
+                thrust::make_permutation_iterator(Sc.begin(), ijk.begin()),
+                thrust::make_permutation_iterator(Pr.begin(), ijk.begin()),
+                thrust::make_permutation_iterator(lambda_D.begin(), ijk.begin()),
+                thrust::make_permutation_iterator(lambda_K.begin(), ijk.begin())
+              )
+            )
           )
         ), 
-        rw2.begin(),                    // output
-        detail::advance_rw2<real_t>(dt, RH_max)
+        dt, RH_max
       );
+      cond_stats_add(n_part);
       nancheck(rw2, "rw2 after condensation (no sub-steps");
 
       // calculating the 3rd wet moment after condensation
@@ -63,7 +76,7 @@ namespace libcloudphxx
         count_mom.begin(), count_mom.begin() + count_n,                    // input - 1st arg
         thrust::make_permutation_iterator(drv.begin(), count_ijk.begin()), // input - 2nd arg
         thrust::make_permutation_iterator(drv.begin(), count_ijk.begin()), // output
-        thrust::plus<real_t>()
+        thrust::plus<acc_t>()
       );
 
       // update th and rv according to changes in third specific wet moment
@@ -6,6 +6,7 @@
   */
 
 #include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/discard_iterator.h>
 #include <libcloudph++/common/maxwell-mason.hpp>
 #include <libcloudph++/common/kappa_koehler.hpp>
 #include <libcloudph++/common/kelvin_term.hpp>
@@ -48,6 +49,17 @@ namespace libcloudphxx
         }
       };
         
+      // per-particle (or per-cell gathered) state: rhod, rv, T, p, RH, eta, rd3, kpa, vt
+      // and the condensation coefficients computed in hskpng_Tpr: Sc, Pr, lambda_D, lambda_K
+      template <typename real_t>
+      struct advance_rw2_tpl
+      {
+        typedef thrust::tuple<
+          thrust::tuple<real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t>,
+          thrust::tuple<real_t, real_t, real_t, real_t>
+        > type;
+      };
+
       template <typename real_t>
       struct advance_rw2_minfun
       {
@@ -62,6 +74,10 @@ namespace libcloudphxx
         const quantity<si::volume,            real_t> rd3;
         const quantity<si::dimensionless,     real_t> kpa;
         const quantity<si::velocity,          real_t> vt;
+        const quantity<si::dimensionless,     real_t> Sc;
+        const quantity<si::dimensionless,     real_t> Pr;
+        const quantity<si::length,            real_t> lambda_D;
+        const quantity<si::length,            real_t> lambda_K;
         const quantity<si::dimensionless,     real_t> RH_max;
 
         // ctor
@@ -69,20 +85,24 @@ namespace libcloudphxx
         advance_rw2_minfun(
           const real_t &dt,
           const real_t &rw2,
-          const thrust::tuple<real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t> &tpl,
+          const typename advance_rw2_tpl<real_t>::type &tpl,
           const real_t &RH_max
         ) : 
           dt(dt * si::seconds), 
           rw2_old(rw2 * si::square_metres),
-          rhod(    thrust::get<0>(tpl) * si::kilograms / si::cubic_metres),
-          rv(      thrust::get<1>(tpl)),
-          T(       thrust::get<2>(tpl) * si::kelvins),
-          p(       thrust::get<3>(tpl) * si::pascals),
-          RH(      thrust::get<4>(tpl)),
-          eta(     thrust::get<5>(tpl) * si::pascals * si::seconds),
-          rd3(     thrust::get<6>(tpl) * si::cubic_metres),
-          kpa(     thrust::get<7>(tpl)),
-          vt(      thrust::get<8>(tpl) * si::metres_per_second),
+          rhod(    thrust::get<0>(thrust::get<0>(tpl)) * si::kilograms / si::cubic_metres),
+          rv(      thrust::get<1>(thrust::get<0>(tpl))),
+          T(       thrust::get<2>(thrust::get<0>(tpl)) * si::kelvins),
+          p(       thrust::get<3>(thrust::get<0>(tpl)) * si::pascals),
+          RH(      thrust::get<4>(thrust::get<0>(tpl))),
+          eta(     thrust::get<5>(thrust::get<0>(tpl)) * si::pascals * si::seconds),
+          rd3(     thrust::get<6>(thrust::get<0>(tpl)) * si::cubic_metres),
+          kpa(     thrust::get<7>(thrust::get<0>(tpl))),
+          vt(      thrust::get<8>(thrust::get<0>(tpl)) * si::metres_per_second),
+          Sc(      thrust::get<0>(thrust::get<1>(tpl))),
+          Pr(      thrust::get<1>(thrust::get<1>(tpl))),
+          lambda_D(thrust::get<2>(thrust::get<1>(tpl)) * si::metres),
+          lambda_K(thrust::get<3>(thrust::get<1>(tpl)) * si::metres),
           RH_max(RH_max)
         {}
 
@@ -94,10 +114,7 @@ namespace libcloudphxx
           using namespace common::kelvin;
           using common::moist_air::D_0;
           using common::moist_air::K_0;
-          using common::moist_air::c_pd;
           using common::transition_regime::beta;
-          using common::mean_free_path::lambda_D;
-          using common::mean_free_path::lambda_K;
           using common::ventil::Sh;
           using common::ventil::Nu;
           using std::sqrt;
@@ -105,18 +122,16 @@ namespace libcloudphxx
           const quantity<si::length, real_t> rw  = sqrt(real_t(rw2 / si::square_metres)) * si::metres; 
           const quantity<si::volume, real_t> rw3 = rw * rw * rw;;
 
-          // TODO: common::moist_air:: below should not be needed
           // TODO: ventilation as option
+          // Sc, Pr and the mean free paths do not depend on rw - they come precomputed from hskpng_Tpr
           const quantity<si::dimensionless, real_t>
-            Re = common::ventil::Re(vt, rw, rhod, eta), 
-            Sc = common::ventil::Sc(eta, rhod, D_0<real_t>()), // TODO? cache
-            Pr = common::ventil::Pr(eta, c_pd<real_t>(), K_0<real_t>()); // TODO? cache
+            Re = common::ventil::Re(vt, rw, rhod, eta);
 
           const quantity<common::diffusivity, real_t> 
-            D = D_0<real_t>() * beta(lambda_D(T)    / rw) * (Sh(Sc, Re) / 2); // TODO: cache lambdas
+            D = D_0<real_t>() * beta(lambda_D / rw) * (Sh(Sc, Re) / 2);
 
           const quantity<common::thermal_conductivity, real_t> 
-            K = K_0<real_t>() * beta(lambda_K(T, p) / rw) * (Nu(Pr, Re) / 2);
+            K = K_0<real_t>() * beta(lambda_K / rw) * (Nu(Pr, Re) / 2);
 
           return real_t(2) * rdrdt( 
             D,
@@ -130,6 +145,67 @@ namespace libcloudphxx
           );
         }
 
+        // as above, but also returns d(drw2_dt)/d(rw2) [1/s] (for Newton iterations)
+        // the derivative is analytic with respect to the solute and curvature terms (a_w and the Kelvin term),
+        // while the weak dependence of the ventilation and transition-regime corrections on rw is neglected
+        BOOST_GPU_ENABLED
+        quantity<divide_typeof_helper<si::area, si::time>::type, real_t> drw2_dt(
+          const quantity<si::area, real_t> &rw2, 
+          real_t &ddrw2_dt_drw2
+        ) const
+        {
+          using namespace common::maxwell_mason;
+          using namespace common::kappa_koehler;
+          using namespace common::kelvin;
+          using common::moist_air::D_0;
+          using common::moist_air::K_0;
+          using common::transition_regime::beta;
+          using common::ventil::Sh;
+          using common::ventil::Nu;
+          using std::sqrt;
+
+          const quantity<si::length, real_t> rw  = sqrt(real_t(rw2 / si::square_metres)) * si::metres; 
+          const quantity<si::volume, real_t> rw3 = rw * rw * rw;;
+
+          const quantity<si::dimensionless, real_t>
+            Re = common::ventil::Re(vt, rw, rhod, eta);
+
+          const quantity<common::diffusivity, real_t> 
+            D = D_0<real_t>() * beta(lambda_D / rw) * (Sh(Sc, Re) / 2);
+
+          const quantity<common::thermal_conductivity, real_t> 
+            K = K_0<real_t>() * beta(lambda_K / rw) * (Nu(Pr, Re) / 2);
+
+          const quantity<si::dimensionless, real_t> RH_eff = RH > RH_max ? RH_max : RH;
+
+          // drw2_dt = c0 * (1 - a_w * klvntrm / RH), c0 obtained with a_w = 0
+          const quantity<divide_typeof_helper<si::area, si::time>::type, real_t> c0 = real_t(2) * rdrdt( 
+            D,
+            K,
+            rhod * rv, 
+            T, 
+            p, 
+            RH_eff,
+            quantity<si::dimensionless, real_t>(real_t(0)),
+            quantity<si::dimensionless, real_t>(real_t(1))
+          );
+
+          const real_t 
+            r    = rw / si::metres,
+            aw   = a_w(rw3, rd3, kpa),
+            kt   = klvntrm(rw, T),
+            A_   = A<real_t>(T) / si::metres,
+            den  = (rw3 - rd3 * (real_t(1) - kpa)) / si::cubic_metres,
+            // d(a_w)/d(rw2) = d(a_w)/d(rw3) * 3/2 rw
+            daw  = real_t(rd3 / si::cubic_metres) * real_t(kpa) / den / den * real_t(1.5) * r,
+            // d(klvntrm)/d(rw2) = - klvntrm * A / rw^2 * d(rw)/d(rw2)
+            dkt  = - kt * A_ / (real_t(2) * r * r * r);
+
+          ddrw2_dt_drw2 = - real_t(c0 * si::seconds / si::square_metres) / real_t(RH_eff) * (daw * kt + aw * dkt);
+
+          return c0 * (real_t(1) - aw * kt / RH_eff);
+        }
+
         // backward Euler scheme:
   // rw2_new = rw2_old + f_rw2(rw2_new) * dt
   // rw2_new = rw2_old + 2 * rw * f_rw(rw2_new) * dt
@@ -145,14 +221,29 @@ namespace libcloudphxx
       struct advance_rw2
       {
         const real_t dt, RH_max;
+        const bool newton;
         detail::config<real_t> config;
 
-        advance_rw2(const real_t &dt, const real_t &RH_max) : dt(dt), RH_max(RH_max) {}
+        advance_rw2(const real_t &dt, const real_t &RH_max, const cond_solver_t::cond_solver_t &solver) : 
+          dt(dt), RH_max(RH_max), newton(solver == cond_solver_t::newton) {}
 
+        // takes rw2 and its rate of change in the previous step (see cond_advance_rw2(), 0 if unknown);
+        // returns the new rw2, the number of iterations done (see cond_stats_add()) and the new rate
         BOOST_GPU_ENABLED
-        real_t operator()(
+        thrust::tuple<real_t, unsigned int, real_t> operator()(
+          const thrust::tuple<real_t, real_t> &rw2_tpl, 
+          const typename advance_rw2_tpl<real_t>::type &tpl
+        ) const {
+          const real_t &rw2_old = thrust::get<0>(rw2_tpl);
+          const thrust::tuple<real_t, unsigned int> res = solve(rw2_old, dt * thrust::get<1>(rw2_tpl), tpl);
+          return thrust::make_tuple(thrust::get<0>(res), thrust::get<1>(res), (thrust::get<0>(res) - rw2_old) / dt);
+        }
+
+        BOOST_GPU_ENABLED
+        thrust::tuple<real_t, unsigned int> solve(
           const real_t &rw2_old, 
-          const thrust::tuple<real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t, real_t> &tpl
+          const real_t &drw2_prev,
+          const typename advance_rw2_tpl<real_t>::type &tpl
         ) const {
 #if !defined(__NVCC__)
           using std::min;
@@ -171,29 +262,66 @@ namespace libcloudphxx
             printf("rw2_old: %g\n",rw2_old);
             printf("dt: %g\n",dt);
             printf("RH_max: %g\n",RH_max);
-            printf("rhod: %g\n",thrust::get<0>(tpl));
-            printf("rv: %g\n",thrust::get<1>(tpl));
-            printf("T: %g\n",thrust::get<2>(tpl));
-            printf("p: %g\n",thrust::get<3>(tpl));
-            printf("RH: %g\n",thrust::get<4>(tpl));
-            printf("eta: %g\n",thrust::get<5>(tpl));
-            printf("rd3: %g\n",thrust::get<6>(tpl));
-            printf("kpa: %g\n",thrust::get<7>(tpl));
-            printf("vt: %g\n",thrust::get<8>(tpl));
+            printf("rhod: %g\n",thrust::get<0>(thrust::get<0>(tpl)));
+            printf("rv: %g\n",thrust::get<1>(thrust::get<0>(tpl)));
+            printf("T: %g\n",thrust::get<2>(thrust::get<0>(tpl)));
+            printf("p: %g\n",thrust::get<3>(thrust::get<0>(tpl)));
+            printf("RH: %g\n",thrust::get<4>(thrust::get<0>(tpl)));
+            printf("eta: %g\n",thrust::get<5>(thrust::get<0>(tpl)));
+            printf("rd3: %g\n",thrust::get<6>(thrust::get<0>(tpl)));
+            printf("kpa: %g\n",thrust::get<7>(thrust::get<0>(tpl)));
+            printf("vt: %g\n",thrust::get<8>(thrust::get<0>(tpl)));
+            printf("Sc: %g\n",thrust::get<0>(thrust::get<1>(tpl)));
+            printf("Pr: %g\n",thrust::get<1>(thrust::get<1>(tpl)));
+            printf("lambda_D: %g\n",thrust::get<2>(thrust::get<1>(tpl)));
+            printf("lambda_K: %g\n",thrust::get<3>(thrust::get<1>(tpl)));
             assert(0);
           }
 #endif
 
-          if (drw2 == 0) return rw2_old;
+          if (drw2 == 0) return thrust::make_tuple(rw2_old, 0u);
+
+          const real_t rd2 = pow(thrust::get<6>(thrust::get<0>(tpl)), real_t(2./3));
+
+          unsigned int n_stat = 0;
 
-          const real_t rd2 = pow(thrust::get<6>(tpl), real_t(2./3));
+          // Newton iterations on the implicit Euler residual F(x) = rw2_old + dt * drw2_dt(x) - x,
+          // falling back to toms748 if they do not converge; F(rw2_old) = drw2 and F decreases, so
+          // the root lies on the side of drw2: the step is started from the increment of the previous
+          // step if it is on that side (close to it for slowly changing conditions, while the explicit
+          // Euler estimate overshoots for small drops near equilibrium), from explicit Euler otherwise
+          if (newton)
+          {
+            common::detail::eps_tolerance<real_t> tol = config.eps_tolerance;
+            real_t x = max(rd2, rw2_old + (drw2_prev * drw2 > 0 ? drw2_prev : drw2));
+            for (unsigned int it = 1; it <= config.cond_newton_n_iter; ++it)
+            {
+              real_t dfdx;
+              const real_t 
+                F  = rw2_old + dt * (f.drw2_dt(x * si::square_metres, dfdx) * si::seconds / si::square_metres) - x,
+                dF = dt * dfdx - real_t(1);
+              n_stat = it;
+
+              // F not monotonically decreasing (or nan) - Newton not reliable here
+              if (!(dF < 0)) break;
+
+              real_t x_new = x - F / dF;
+              // damping if the step would take us below the dry radius
+              if (x_new < rd2) x_new = (x + rd2) / 2;
+
+              const bool converged = (x_new == x) || tol(x, x_new);
+              x = x_new;
+              if (converged) return thrust::make_tuple(x, n_stat);
+            }
+            n_stat += config.cond_fallback_flag;
+          }
  
           const real_t 
             a = max(rd2, rw2_old + min(real_t(0), config.cond_mlt * drw2)),
             b =          rw2_old + max(real_t(0), config.cond_mlt * drw2);
 
           // numerics (drw2 != 0 but a==b)
-          if (a == b) return rw2_old;
+          if (a == b) return thrust::make_tuple(rw2_old, n_stat);
 
           real_t fa, fb;
 
@@ -207,6 +335,7 @@ namespace libcloudphxx
             fa = f(a);
             fb = drw2; // for implicit Euler its equal to min_fun(x_old) 
           }
+          n_stat += 1;
 
           // to store the result
           real_t rw2_new;
@@ -218,6 +347,7 @@ namespace libcloudphxx
           {
             uintmax_t n_iter = config.n_iter;
             rw2_new = common::detail::toms748_solve(f, a, b, fa, fb, config.eps_tolerance, n_iter);
+            n_stat += n_iter;
           }
           // check if it doesn't evaporate too much
           if(rw2_new < rd2) rw2_new = rd2;
@@ -233,9 +363,159 @@ namespace libcloudphxx
             assert(0);
           }
 #endif
-          return rw2_new;
+          return thrust::make_tuple(rw2_new, n_stat);
+        }
+      };
+
+      // per-particle number of condensation substeps (a divisor of sstp_cond) for adaptive substepping, 
+      // chosen so that the relative change of rw2 within a single substep does not exceed rel_max
+      template <typename real_t>
+      struct sstp_cond_stride
+      {
+        const real_t dt, RH_max, rel_max;
+        const unsigned int sstp;
+
+        sstp_cond_stride(const real_t &dt, const real_t &RH_max, const unsigned int &sstp, const real_t &rel_max) :
+          dt(dt), RH_max(RH_max), sstp(sstp), rel_max(rel_max) {}
+
+        BOOST_GPU_ENABLED
+        unsigned int operator()(
+          const real_t &rw2, 
+          const typename advance_rw2_tpl<real_t>::type &tpl
+        ) const {
+#if !defined(__NVCC__)
+          using std::abs;
+          using std::ceil;
+#endif
+          const advance_rw2_minfun<real_t> f(dt, rw2, tpl, RH_max); 
+
+          // relative change of rw2 over the whole timestep (explicit estimate)
+          const real_t rel = dt * abs(f.drw2_dt(rw2 * si::square_metres) * si::seconds / si::square_metres) / rw2;
+          const real_t n_needed = ceil(rel / rel_max);
+
+          if (!(n_needed < sstp)) return 1; // also for nan
+          unsigned int stride = n_needed < 1 ? sstp : sstp / (unsigned int)(n_needed);
+          while (sstp % stride != 0) --stride;
+          return stride;
+        }
+      };
+
+      // per-particle iteration count (with the fallback flag) -> (n_iter, n_iter, n_fallback)
+      template <typename n_t>
+      struct cond_stats_unpack
+      {
+        const unsigned int flag;
+        cond_stats_unpack(const unsigned int &flag) : flag(flag) {}
+
+        BOOST_GPU_ENABLED
+        thrust::tuple<n_t, n_t, n_t> operator()(const unsigned int &n_stat) const
+        {
+          const n_t n_iter = n_stat % flag;
+          return thrust::make_tuple(n_iter, n_iter, n_t(n_stat / flag));
+        }
+      };
+
+      template <typename n_t>
+      struct cond_stats_combine
+      {
+        BOOST_GPU_ENABLED
+        thrust::tuple<n_t, n_t, n_t> operator()(
+          const thrust::tuple<n_t, n_t, n_t> &a, 
+          const thrust::tuple<n_t, n_t, n_t> &b
+        ) const
+        {
+          return thrust::make_tuple(
+            thrust::get<0>(a) + thrust::get<0>(b),
+            thrust::get<1>(a) > thrust::get<1>(b) ? thrust::get<1>(a) : thrust::get<1>(b),
+            thrust::get<2>(a) + thrust::get<2>(b)
+          );
         }
       };
     };
+
+    // advances rw2 of the n_solve SDs with indices given by id with advance_rw2, state_it being
+    // indexed by SD; the iteration counts are stored in tmp_device_n_part and, for the Newton
+    // solver, the rates of change of rw2 in cond_drw2_dt (the initial guess in the next step)
+    template <typename real_t, backend_t device>
+    template <class ix_it_t, class state_it_t>
+    void particles_t<real_t, device>::impl::cond_advance_rw2(
+      const ix_it_t &id,
+      const thrust_size_t &n_solve,
+      const state_it_t &state_it,
+      const real_t &dt,
+      const real_t &RH_max
+    )
+    {
+      const detail::advance_rw2<real_t> advance(dt, RH_max, opts_init.cond_solver);
+
+      if (opts_init.cond_solver == cond_solver_t::newton)
+      {
+        const auto rw2_it = thrust::make_zip_iterator(thrust::make_tuple(
+          thrust::make_permutation_iterator(rw2.begin(), id),
+          thrust::make_permutation_iterator(cond_drw2_dt.begin(), id)
+        ));
+        thrust::transform(
+          rw2_it, rw2_it + n_solve,                         // input - 1st arg
+          thrust::make_permutation_iterator(state_it, id),  // input - 2nd arg
+          thrust::make_zip_iterator(thrust::make_tuple(     // output
+            thrust::make_permutation_iterator(rw2.begin(), id),
+            thrust::make_permutation_iterator(tmp_device_n_part.begin(), id), // per-particle number of iterations
+            thrust::make_permutation_iterator(cond_drw2_dt.begin(), id)
+          )),
+          advance
+        );
+      }
+      else
+      {
+        const auto rw2_it = thrust::make_zip_iterator(thrust::make_tuple(
+          thrust::make_permutation_iterator(rw2.begin(), id),
+          thrust::make_constant_iterator<real_t>(0)
+        ));
+        thrust::transform(
+          rw2_it, rw2_it + n_solve,
+          thrust::make_permutation_iterator(state_it, id),
+          thrust::make_zip_iterator(thrust::make_tuple(
+            thrust::make_permutation_iterator(rw2.begin(), id),
+            thrust::make_permutation_iterator(tmp_device_n_part.begin(), id),
+            thrust::make_discard_iterator()
+          )),
+          advance
+        );
+      }
+    }
+
+    // accumulates the per-particle iteration counts stored by advance_rw2 in tmp_device_n_part
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::cond_stats_add(
+      const thrust_size_t &n_solve // number of SDs for which advance_rw2 was called
+    )
+    {
+      cond_stats_add(zero, n_solve);
+    }
+
+    // ditto for the n_solve SDs with indices given by id
+    template <typename real_t, backend_t device>
+    template <class ix_it_t>
+    void particles_t<real_t, device>::impl::cond_stats_add(
+      const ix_it_t &id,
+      const thrust_size_t &n_solve
+    )
+    {
+      typedef unsigned long long ull_t;
+      thrust_device::vector<unsigned int> &n_stat(tmp_device_n_part);
+
+      const thrust::tuple<ull_t, ull_t, ull_t> res = thrust::transform_reduce(
+        thrust::make_permutation_iterator(n_stat.begin(), id),
+        thrust::make_permutation_iterator(n_stat.begin(), id) + n_solve,
+        detail::cond_stats_unpack<ull_t>(config.cond_fallback_flag),
+        thrust::make_tuple(ull_t(0), ull_t(0), ull_t(0)),
+        detail::cond_stats_combine<ull_t>()
+      );
+
+      cond_stats.n_solve += n_solve;
+      cond_stats.n_iter += thrust::get<0>(res);
+      if (thrust::get<1>(res) > cond_stats.n_iter_max) cond_stats.n_iter_max = thrust::get<1>(res);
+      cond_stats.n_fallback += thrust::get<2>(res);
+    }
   };  
 };
@@ -5,6 +5,8 @@
   * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
   */
 
+#include <thrust/binary_search.h>
+
 namespace libcloudphxx
 {
   namespace lgrngn
@@ -12,118 +14,279 @@ namespace libcloudphxx
     template <typename real_t, backend_t device>
     void particles_t<real_t, device>::impl::cond_sstp(
       const real_t &dt,
-      const real_t &RH_max
+      const real_t &RH_max,
+      const int &step
     ) {   
       // prerequisite
       hskpng_sort(); 
       // particle's local change in rv
       thrust_device::vector<real_t> &pdrv(tmp_device_real_part4);
-      // -rw3_old
-      thrust::transform(
-        thrust::make_transform_iterator(rw2.begin(), detail::rw2torw3<real_t>()),
-        thrust::make_transform_iterator(rw2.end(), detail::rw2torw3<real_t>()),
-        pdrv.begin(),
-        thrust::negate<real_t>()
-      );
-
       // vector for each particle's T
       thrust_device::vector<real_t> &Tp(tmp_device_real_part3);
 
-      // calc Tp
-      thrust::transform(
-        sstp_tmp_th.begin(), sstp_tmp_th.end(), // input - first arg
-        sstp_tmp_rh.begin(),                    // input - second arg
-        Tp.begin(),                             // output
-        detail::common__theta_dry__T<real_t>() 
-      );  
-
-      // calculating drop growth in a timestep using backward Euler 
-      thrust::transform(
-        rw2.begin(), rw2.end(),         // input - 1st arg (zip not as 1st arg not to write zip.end()
-        thrust::make_zip_iterator(      // input - 2nd arg
+      // particle-specific p
+      typedef thrust::transform_iterator<
+        detail::common__theta_dry__p<real_t>,
+        thrust::zip_iterator<thrust::tuple<
+          typename thrust_device::vector<real_t>::iterator,
+          typename thrust_device::vector<real_t>::iterator,
+          typename thrust_device::vector<real_t>::iterator
+        > >
+      > pp_it_t;
+      pp_it_t pp_it(
+        thrust::make_zip_iterator(
           thrust::make_tuple(
             sstp_tmp_rh.begin(),
             sstp_tmp_rv.begin(),
-            Tp.begin(),
-            // particle-specific p
-            thrust::make_transform_iterator(
-              thrust::make_zip_iterator(
-                thrust::make_tuple(
-                  sstp_tmp_rh.begin(),
-                  sstp_tmp_rv.begin(),
-                  Tp.begin()
-              )),
-              detail::common__theta_dry__p<real_t>()
-            ),
-            // particle-specific RH
-            thrust::make_transform_iterator(
-              thrust::make_zip_iterator(
-                thrust::make_tuple(
-                  sstp_tmp_rh.begin(),
-                  sstp_tmp_rv.begin(),
-                  Tp.begin()
-              )),
-              detail::RH<real_t>()
-            ),
-            // particle-specific eta
-            thrust::make_transform_iterator(
-              Tp.begin(),
-              detail::common__vterm__visc<real_t>()
-            ),
-            rd3.begin(),
-            kpa.begin(),
-            vt.begin()
-          )
-        ), 
-        rw2.begin(),                    // output
-        detail::advance_rw2<real_t>(dt, RH_max)
+            Tp.begin()
+        )),
+        detail::common__theta_dry__p<real_t>()
       );
 
-      // calc rw3_new - rw3_old
-      thrust::transform(
-        thrust::make_transform_iterator(rw2.begin(), detail::rw2torw3<real_t>()),
-        thrust::make_transform_iterator(rw2.end(), detail::rw2torw3<real_t>()),
-        pdrv.begin(),
-        pdrv.begin(),
-        thrust::plus<real_t>()
-      );
+      // particle-specific eta
+      typedef thrust::transform_iterator<
+        detail::common__vterm__visc<real_t>,
+        typename thrust_device::vector<real_t>::iterator
+      > eta_it_t;
+      eta_it_t eta_it(Tp.begin(), detail::common__vterm__visc<real_t>());
 
-      // calc - 4/3 * pi * rho_w * n * (rw3_new - rw3_old) / (dV * rhod)
-      thrust::transform(
-        pdrv.begin(), pdrv.end(),                  // input - 1st arg
-        thrust::make_zip_iterator(thrust::make_tuple(
-          sstp_tmp_rh.begin(),                                        // rhod
-          n.begin(),                                                  // n
-          thrust::make_permutation_iterator(dv.begin(), ijk.begin()) // dv
-        )),
-        pdrv.begin(),                             // output
-        detail::rw3diff2drv<real_t>(
-          - common::moist_air::rho_w<real_t>() / si::kilograms * si::cubic_metres
-          * real_t(4./3) * pi<real_t>(), n_dims
+      // per-particle state seen by the growth equation
+      const auto state_it = thrust::make_zip_iterator(
+        thrust::make_tuple(
+          thrust::make_zip_iterator(
+            thrust::make_tuple(
+              sstp_tmp_rh.begin(),
+              sstp_tmp_rv.begin(),
+              Tp.begin(),
+              pp_it,
+              // particle-specific RH
+              thrust::make_transform_iterator(
+                thrust::make_zip_iterator(
+                  thrust::make_tuple(
+                    sstp_tmp_rh.begin(),
+                    sstp_tmp_rv.begin(),
+                    Tp.begin()
+                )),
+                detail::RH<real_t>()
+              ),
+              eta_it,
+              rd3.begin(),
+              kpa.begin(),
+              vt.begin()
+            )
+          ),
+          // particle-specific condensation coefficients (evaluated once per particle, not per root-finder iteration)
+          thrust::make_transform_iterator(
+            thrust::make_zip_iterator(
+              thrust::make_tuple(
+                sstp_tmp_rh.begin(),
+                Tp.begin(),
+                pp_it,
+                eta_it
+            )),
+            detail::cond_coeffs<real_t>()
+          )
         )
-      );  
-
-      // apply change in rv to sstp_tmp_rv
-      update_pstate(sstp_tmp_rv, pdrv);
-
-      // calc particle-specific change in th based on pdrv
-      thrust::transform(
-        thrust::make_zip_iterator(thrust::make_tuple(  
-          pdrv.begin(),       //  
-          Tp.begin(),         // dth = drv * d_th_d_rv(T, th)
-          sstp_tmp_th.begin() //  
-        )), 
-        thrust::make_zip_iterator(thrust::make_tuple(  
-          pdrv.end(),       //  
-          Tp.end(),         // dth = drv * d_th_d_rv(T, th)
-          sstp_tmp_th.end() //  
-        )), 
-        pdrv.begin(), // in-place
-        detail::dth<real_t>()
       );
 
-      // apply change in th to sstp_tmp_th
-      update_pstate(sstp_tmp_th, pdrv);
+      if (!opts_init.adaptive_sstp_cond)
+      {
+        // -rw3_old
+        thrust::transform(
+          thrust::make_transform_iterator(rw2.begin(), detail::rw2torw3<real_t>()),
+          thrust::make_transform_iterator(rw2.end(), detail::rw2torw3<real_t>()),
+          pdrv.begin(),
+          thrust::negate<real_t>()
+        );
+
+        // calc Tp
+        thrust::transform(
+          sstp_tmp_th.begin(), sstp_tmp_th.end(), // input - first arg
+          sstp_tmp_rh.begin(),                    // input - second arg
+          Tp.begin(),                             // output
+          detail::common__theta_dry__T<real_t>() 
+        );  
+
+        // calculating drop growth in a timestep using backward Euler 
+        cond_advance_rw2(zero, n_part, state_it, dt, RH_max);
+        cond_stats_add(n_part);
+
+        // calc rw3_new - rw3_old
+        thrust::transform(
+          thrust::make_transform_iterator(rw2.begin(), detail::rw2torw3<real_t>()),
+          thrust::make_transform_iterator(rw2.end(), detail::rw2torw3<real_t>()),
+          pdrv.begin(),
+          pdrv.begin(),
+          thrust::plus<real_t>()
+        );
+
+        // calc - 4/3 * pi * rho_w * n * (rw3_new - rw3_old) / (dV * rhod)
+        thrust::transform(
+          pdrv.begin(), pdrv.end(),                  // input - 1st arg
+          thrust::make_zip_iterator(thrust::make_tuple(
+            sstp_tmp_rh.begin(),                                        // rhod
+            n.begin(),                                                  // n
+            thrust::make_permutation_iterator(dv.begin(), ijk.begin()) // dv
+          )),
+          pdrv.begin(),                             // output
+          detail::rw3diff2drv<real_t>(
+            - common::moist_air::rho_w<real_t>() / si::kilograms * si::cubic_metres
+            * real_t(4./3) * pi<real_t>(), n_dims
+          )
+        );  
+
+        // apply change in rv to sstp_tmp_rv
+        update_pstate(sstp_tmp_rv, pdrv);
+
+        // calc particle-specific change in th based on pdrv
+        thrust::transform(
+          thrust::make_zip_iterator(thrust::make_tuple(  
+            pdrv.begin(),       //  
+            Tp.begin(),         // dth = drv * d_th_d_rv(T, th)
+            sstp_tmp_th.begin() //  
+          )), 
+          thrust::make_zip_iterator(thrust::make_tuple(  
+            pdrv.end(),       //  
+            Tp.end(),         // dth = drv * d_th_d_rv(T, th)
+            sstp_tmp_th.end() //  
+          )), 
+          pdrv.begin(), // in-place
+          detail::dth<real_t>()
+        );
+
+        // apply change in th to sstp_tmp_th
+        update_pstate(sstp_tmp_th, pdrv);
+        return;
+      }
+
+      const unsigned int sstp = opts_init.sstp_cond;
+
+      // each SD chooses its own number of substeps at the beginning of the timestep;
+      // the SDs are then ordered by stride (and by cell within a stride, sorted_id being
+      // in the order of cells) and the beginning of each stride's bucket is kept for the next substeps
+      if (step == 0)
+      {
+        thrust::transform(
+          sstp_tmp_th.begin(), sstp_tmp_th.end(), // input - first arg
+          sstp_tmp_rh.begin(),                    // input - second arg
+          Tp.begin(),                             // output
+          detail::common__theta_dry__T<real_t>() 
+        );  
+
+        thrust::transform(
+          rw2.begin(), rw2.end(),     // input - 1st arg
+          state_it,                   // input - 2nd arg
+          sstp_cond_stride.begin(),   // output
+          detail::sstp_cond_stride<real_t>(dt * sstp, RH_max, sstp, config.cond_sstp_rel_drw2)
+        );
+
+        thrust_device::vector<unsigned int> &key(tmp_device_n_part);
+        thrust::copy(
+          thrust::make_permutation_iterator(sstp_cond_stride.begin(), sorted_id.begin()),
+          thrust::make_permutation_iterator(sstp_cond_stride.begin(), sorted_id.begin()) + n_part,
+          key.begin()
+        );
+        thrust::copy(sorted_id.begin(), sorted_id.begin() + n_part, sstp_cond_ord.begin());
+        thrust::stable_sort_by_key(key.begin(), key.begin() + n_part, sstp_cond_ord.begin());
+
+        sstp_cond_bucket.resize(sstp + 2);
+        for (unsigned int stride = 1; stride <= sstp + 1; ++stride)
+          sstp_cond_bucket[stride] = thrust::lower_bound(key.begin(), key.begin() + n_part, stride) - key.begin();
+      }
+
+      // the buckets due at this substep, each advanced by stride * dt
+      std::vector<unsigned int> due;
+      for (unsigned int stride = 1; stride <= sstp; ++stride)
+        if (sstp % stride == 0 && (step + 1) % stride == 0 && sstp_cond_bucket[stride + 1] > sstp_cond_bucket[stride])
+          due.push_back(stride);
+
+      typedef typename thrust_device::vector<thrust_size_t>::iterator id_it_t;
+      for (const unsigned int &stride : due)
+      {
+        const id_it_t id = sstp_cond_ord.begin() + sstp_cond_bucket[stride];
+        const thrust_size_t n_bucket = sstp_cond_bucket[stride + 1] - sstp_cond_bucket[stride];
+
+        // -rw3_old
+        thrust::transform(
+          thrust::make_transform_iterator(thrust::make_permutation_iterator(rw2.begin(), id), detail::rw2torw3<real_t>()),
+          thrust::make_transform_iterator(thrust::make_permutation_iterator(rw2.begin(), id), detail::rw2torw3<real_t>()) + n_bucket,
+          thrust::make_permutation_iterator(pdrv.begin(), id),
+          thrust::negate<real_t>()
+        );
+
+        // calc Tp
+        thrust::transform(
+          thrust::make_permutation_iterator(sstp_tmp_th.begin(), id),
+          thrust::make_permutation_iterator(sstp_tmp_th.begin(), id) + n_bucket,
+          thrust::make_permutation_iterator(sstp_tmp_rh.begin(), id),
+          thrust::make_permutation_iterator(Tp.begin(), id),
+          detail::common__theta_dry__T<real_t>() 
+        );  
+
+        cond_advance_rw2(id, n_bucket, state_it, dt * stride, RH_max);
+        cond_stats_add(id, n_bucket);
+
+        // calc rw3_new - rw3_old
+        thrust::transform(
+          thrust::make_transform_iterator(thrust::make_permutation_iterator(rw2.begin(), id), detail::rw2torw3<real_t>()),
+          thrust::make_transform_iterator(thrust::make_permutation_iterator(rw2.begin(), id), detail::rw2torw3<real_t>()) + n_bucket,
+          thrust::make_permutation_iterator(pdrv.begin(), id),
+          thrust::make_permutation_iterator(pdrv.begin(), id),
+          thrust::plus<real_t>()
+        );
+
+        // calc - 4/3 * pi * rho_w * n * (rw3_new - rw3_old) / (dV * rhod)
+        thrust::transform(
+          thrust::make_permutation_iterator(pdrv.begin(), id),
+          thrust::make_permutation_iterator(pdrv.begin(), id) + n_bucket,
+          thrust::make_zip_iterator(thrust::make_tuple(
+            thrust::make_permutation_iterator(sstp_tmp_rh.begin(), id),                                         // rhod
+            thrust::make_permutation_iterator(n.begin(), id),                                                   // n
+            thrust::make_permutation_iterator(dv.begin(), thrust::make_permutation_iterator(ijk.begin(), id)) // dv
+          )),
+          thrust::make_permutation_iterator(pdrv.begin(), id),
+          detail::rw3diff2drv<real_t>(
+            - common::moist_air::rho_w<real_t>() / si::kilograms * si::cubic_metres
+            * real_t(4./3) * pi<real_t>(), n_dims
+          )
+        );  
+      }
+
+      // apply change in rv to sstp_tmp_rv (the sums over the due SDs in each cell apply to all SDs in it)
+      {
+        thrust_device::vector<acc_t> &dstate(tmp_device_acc_cell);
+        thrust::fill(dstate.begin(), dstate.end(), acc_t(0));
+        for (const unsigned int &stride : due)
+          update_pstate_sum(dstate, pdrv, sstp_cond_ord.begin() + sstp_cond_bucket[stride], sstp_cond_bucket[stride + 1] - sstp_cond_bucket[stride]);
+
+        // calc particle-specific change in th based on pdrv (Tp and sstp_tmp_th not changed by the above)
+        for (const unsigned int &stride : due)
+        {
+          const id_it_t id = sstp_cond_ord.begin() + sstp_cond_bucket[stride];
+          const thrust_size_t n_bucket = sstp_cond_bucket[stride + 1] - sstp_cond_bucket[stride];
+          thrust::transform(
+            thrust::make_zip_iterator(thrust::make_tuple(  
+              thrust::make_permutation_iterator(pdrv.begin(), id),
+              thrust::make_permutation_iterator(Tp.begin(), id),         // dth = drv * d_th_d_rv(T, th)
+              thrust::make_permutation_iterator(sstp_tmp_th.begin(), id)
+            )), 
+            thrust::make_zip_iterator(thrust::make_tuple(  
+              thrust::make_permutation_iterator(pdrv.begin(), id),
+              thrust::make_permutation_iterator(Tp.begin(), id),
+              thrust::make_permutation_iterator(sstp_tmp_th.begin(), id)
+            )) + n_bucket, 
+            thrust::make_permutation_iterator(pdrv.begin(), id), // in-place
+            detail::dth<real_t>()
+          );
+        }
+        update_pstate_apply(sstp_tmp_rv, dstate);
+
+        // apply change in th to sstp_tmp_th
+        thrust::fill(dstate.begin(), dstate.end(), acc_t(0));
+        for (const unsigned int &stride : due)
+          update_pstate_sum(dstate, pdrv, sstp_cond_ord.begin() + sstp_cond_bucket[stride], sstp_cond_bucket[stride + 1] - sstp_cond_bucket[stride]);
+        update_pstate_apply(sstp_tmp_th, dstate);
+      }
     }
   };  
 };
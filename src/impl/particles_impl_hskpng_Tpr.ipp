@@ -7,6 +7,8 @@
 
 #include <libcloudph++/common/theta_dry.hpp>
 #include <libcloudph++/common/vterm.hpp> // TODO: should be viscosity!
+#include <libcloudph++/common/ventil.hpp>
+#include <libcloudph++/common/mean_free_path.hpp>
 
 namespace libcloudphxx
 {
@@ -73,11 +75,45 @@ namespace libcloudphxx
           return common::vterm::visc(T * si::kelvins) / si::pascals / si::seconds;
         }
       };
+
+      // particle-size-independent coefficients used in condensation: Sc, Pr, lambda_D, lambda_K
+      template <typename real_t>
+      struct cond_coeffs : thrust::unary_function<
+        const thrust::tuple<real_t, real_t, real_t, real_t>&,
+        thrust::tuple<real_t, real_t, real_t, real_t>
+      >
+      {
+        BOOST_GPU_ENABLED
+        thrust::tuple<real_t, real_t, real_t, real_t> operator()(
+          const thrust::tuple<real_t, real_t, real_t, real_t> &tpl // rhod, T, p, eta
+        ) const
+        {
+          using common::moist_air::D_0;
+          using common::moist_air::K_0;
+          using common::moist_air::c_pd;
+
+          const quantity<si::mass_density,      real_t> rhod = thrust::get<0>(tpl) * si::kilograms / si::cubic_metres;
+          const quantity<si::temperature,       real_t> T    = thrust::get<1>(tpl) * si::kelvins;
+          const quantity<si::pressure,          real_t> p    = thrust::get<2>(tpl) * si::pascals;
+          const quantity<si::dynamic_viscosity, real_t> eta  = thrust::get<3>(tpl) * si::pascals * si::seconds;
+
+          // TODO: common::moist_air:: below should not be needed
+          return thrust::make_tuple(
+            real_t(common::ventil::Sc(eta, rhod, D_0<real_t>())),
+            real_t(common::ventil::Pr(eta, c_pd<real_t>(), K_0<real_t>())),
+            real_t(common::mean_free_path::lambda_D(T) / si::metres),
+            real_t(common::mean_free_path::lambda_K(T, p) / si::metres)
+          );
+        }
+      };
     };
 
     template <typename real_t, backend_t device>
     void particles_t<real_t, device>::impl::hskpng_Tpr()
     {   
+      // nothing to do if th, rv and rhod did not change since the last call
+      if (!tpr_dirty) return;
+
       // T  = common::theta_dry::T<real_t>(th, rhod);
       thrust::transform(
         th.begin(), th.end(),      // input - first arg
@@ -121,6 +157,14 @@ namespace libcloudphxx
         );
       }
 
+      // coefficients for condensation (computed once here instead of in each root-finder iteration)
+      thrust::transform(
+        thrust::make_zip_iterator(thrust::make_tuple(rhod.begin(), T.begin(), p.begin(), eta.begin())), // input - begin
+        thrust::make_zip_iterator(thrust::make_tuple(rhod.end(),   T.end(),   p.end(),   eta.end()  )), // input - end
+        thrust::make_zip_iterator(thrust::make_tuple(Sc.begin(), Pr.begin(), lambda_D.begin(), lambda_K.begin())), // output
+        detail::cond_coeffs<real_t>()
+      );
+
       // adjusting dv if using a parcel set-up (1kg of dry air)
       if (n_dims == 0)
       {
@@ -131,6 +175,8 @@ namespace libcloudphxx
           real_t(1) / arg::_1
         );
       }
+
+      tpr_dirty = false;
     }
   };  
 };
@@ -6,6 +6,8 @@
   */
 
 #include <thrust/remove.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
 
 namespace libcloudphxx
 {
@@ -32,6 +34,20 @@ namespace libcloudphxx
           return(thrust::get<0>(tup) == 0); 
         }    
       };  
+
+      // SD index of the i-th element of the species-major chem matrix
+      struct chem_col
+      {
+        const thrust_size_t n_part;
+
+        chem_col(const thrust_size_t &n_part) : n_part(n_part) {}
+
+        BOOST_GPU_ENABLED
+        thrust_size_t operator()(const thrust_size_t &i) const
+        {
+          return i % n_part;
+        }
+      };
     };
 
     // remove SDs with n=0
@@ -41,35 +57,28 @@ namespace libcloudphxx
       typedef thrust::detail::normal_iterator<thrust_device::pointer<real_t> > it_real_t;
       typedef thrust::detail::normal_iterator<thrust_device::pointer<n_t> > it_n_t;
       typedef thrust::detail::normal_iterator<thrust_device::pointer<thrust_size_t> > it_thrust_size_t;
-      typedef thrust::tuple<it_n_t, it_real_t, it_real_t, it_real_t, it_real_t, it_thrust_size_t> tup_params_t;
+      typedef thrust::detail::normal_iterator<thrust_device::pointer<sd_id_t> > it_sd_id_t;
+      typedef thrust::tuple<it_n_t, it_real_t, it_real_t, it_real_t, it_real_t, it_thrust_size_t, it_sd_id_t> tup_params_t;
       typedef thrust::tuple<it_real_t, it_real_t, it_real_t> tup_sstp_tmp_t;
  
-      tup_params_t tup_params = thrust::make_tuple(n.begin(), rw2.begin(), rd3.begin(), kpa.begin(), vt.begin(), ijk.begin());
+      tup_params_t tup_params = thrust::make_tuple(n.begin(), rw2.begin(), rd3.begin(), kpa.begin(), vt.begin(), ijk.begin(), sd_id.begin());
 
+      // chem_all x n_part matrix compacted in one pass: as remove_if is stable, each row
+      // shrinks to the new n_part and the rows end up packed one after another
       if(opts_init.chem_switch)
       {
-        // TODO: remove all chem in one remove_if call
-        for (int i = chem_all-1; i >= 0; --i)
-        {
-          namespace arg = thrust::placeholders;
+        namespace arg = thrust::placeholders;
+        assert(chem_mtx.size() == chem_all * n_part);
 
-          typename thrust_device::vector<real_t>::iterator new_last = thrust::remove_if(
-            chem_bgn[i],
-            chem_end[i],
+        thrust::remove_if(
+          chem_mtx.begin(),
+          chem_mtx.end(),
+          thrust::make_permutation_iterator(
             n.begin(),
-            arg::_1 == 0
-          );
-          
-          thrust_device::vector<real_t> &vec(
-            i < chem_rhs_beg 
-              ? chem_ante_rhs
-              : i < chem_rhs_fin
-                ? chem_rhs
-                : chem_post_rhs
-          );
- 
-          vec.erase(new_last, chem_end[i]);
-        }
+            thrust::make_transform_iterator(thrust::make_counting_iterator<thrust_size_t>(0), detail::chem_col(n_part))
+          ),
+          arg::_1 == 0
+        );
       }
 
       // remove per-particle old th,rv,rhod
@@ -86,6 +95,18 @@ namespace libcloudphxx
         );
       }
 
+      // Newton initial guesses
+      if(opts_init.cond_solver == cond_solver_t::newton)
+      {
+        namespace arg = thrust::placeholders;
+        thrust::remove_if(
+          cond_drw2_dt.begin(),
+          cond_drw2_dt.begin() + n_part,
+          n.begin(),
+          arg::_1 == 0
+        );
+      }
+
       if(n_dims == 3)
       {
         typedef thrust::zip_iterator<
@@ -189,7 +210,7 @@ namespace libcloudphxx
       // resize vectors
       hskpng_resize_npart();
 
-      // resize chem vectors and update chem iterators
+      // shrink the chem matrix and update chem iterators
       if(opts_init.chem_switch)
         init_chem();
     }
@@ -0,0 +1,103 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  */
+
+#include <thrust/gather.h>
+#include <thrust/inner_product.h>
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      // permutes a per-particle property into the order given by sorted_id
+      template <typename val_t, typename it_t>
+      void reorder_prop(
+        const it_t &prop_bgn,
+        thrust_device::vector<val_t> &tmp,
+        const thrust_device::vector<thrust_size_t> &sorted_id
+      )
+      {
+        thrust::gather(
+          sorted_id.begin(), sorted_id.end(), // map
+          prop_bgn,                           // input
+          tmp.begin()                         // output
+        );
+        thrust::copy(tmp.begin(), tmp.begin() + sorted_id.size(), prop_bgn);
+      }
+    };
+
+    // physically reorders all per-particle vectors into cell order, so that
+    // after the next sort sorted_id is (nearly) an identity permutation
+    // and access through it is (nearly) contiguous
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::hskpng_reorder()
+    {
+      if (opts_init.reorder_freq == 0 && opts_init.reorder_threshold == 0) return;
+
+      bool due = opts_init.reorder_freq > 0 && ++reorder_ctr >= opts_init.reorder_freq;
+
+      // note: sorting here is not wasted - particles stay sorted until next hskpng_ijk()
+      hskpng_sort();
+
+      // fraction of super-droplets not at their position in cell order
+      if (!due && opts_init.reorder_threshold > 0 && n_part > 0)
+      {
+        thrust_size_t n_moved = thrust::inner_product(
+          sorted_id.begin(), sorted_id.end(), // 1st input
+          zero,                               // 2nd input
+          thrust_size_t(0),                   // init
+          thrust::plus<thrust_size_t>(),      // reduction
+          thrust::not_equal_to<thrust_size_t>()
+        );
+        due = real_t(n_moved) / n_part > opts_init.reorder_threshold;
+      }
+
+      if (!due) return;
+      reorder_ctr = 0;
+
+      // for each property...
+      detail::reorder_prop(n.begin(), tmp_device_size_part, sorted_id); // note: tmp_device_n_part is too narrow for n
+      detail::reorder_prop(sd_id.begin(), tmp_device_size_part, sorted_id);
+
+      detail::reorder_prop(rd3.begin(), tmp_device_real_part, sorted_id);
+      detail::reorder_prop(rw2.begin(), tmp_device_real_part, sorted_id);
+      detail::reorder_prop(kpa.begin(), tmp_device_real_part, sorted_id);
+      detail::reorder_prop(vt.begin(),  tmp_device_real_part, sorted_id);
+
+      if (opts_init.nx > 0) detail::reorder_prop(x.begin(), tmp_device_real_part, sorted_id);
+      if (opts_init.ny > 0) detail::reorder_prop(y.begin(), tmp_device_real_part, sorted_id);
+      if (opts_init.nz > 0) detail::reorder_prop(z.begin(), tmp_device_real_part, sorted_id);
+
+      if (opts_init.nx > 0) detail::reorder_prop(i.begin(), tmp_device_size_part, sorted_id);
+      if (opts_init.ny > 0) detail::reorder_prop(j.begin(), tmp_device_size_part, sorted_id);
+      if (opts_init.nz > 0) detail::reorder_prop(k.begin(), tmp_device_size_part, sorted_id);
+
+      if(opts_init.cond_solver == cond_solver_t::newton) detail::reorder_prop(cond_drw2_dt.begin(), tmp_device_real_part, sorted_id);
+
+      if(opts_init.sstp_cond > 1 && opts_init.exact_sstp_cond)
+      {
+        detail::reorder_prop(sstp_tmp_rv.begin(), tmp_device_real_part, sorted_id);
+        detail::reorder_prop(sstp_tmp_th.begin(), tmp_device_real_part, sorted_id);
+        detail::reorder_prop(sstp_tmp_rh.begin(), tmp_device_real_part, sorted_id);
+      }
+
+      // ... chemical properties only if chem enabled
+      if (opts_init.chem_switch)
+      {
+        for (int i = 0; i < chem_all; ++i)
+          detail::reorder_prop(chem_bgn[i], tmp_device_real_part, sorted_id);
+      }
+
+      // ijk in cell order is already there in sorted_ijk
+      thrust::copy(sorted_ijk.begin(), sorted_ijk.end(), ijk.begin());
+
+      // particles are now sorted with an identity permutation
+      thrust::sequence(sorted_id.begin(), sorted_id.end());
+    }
+  };
+};
@@ -2,14 +2,45 @@ namespace libcloudphxx
 {
   namespace lgrngn
   {
+    namespace detail
+    {
+      template <typename id_t>
+      struct sd_id_fctr
+      {
+        const id_t stride, offset;
+
+        sd_id_fctr(const id_t &stride, const id_t &offset) : stride(stride), offset(offset) {}
+
+        BOOST_GPU_ENABLED
+        id_t operator()(const id_t &ctr) const
+        {
+          return ctr * stride + offset;
+        }
+      };
+    };
+
+    // n new SD ids stored at out
+    template <typename real_t, backend_t device>
+    template <class it_t>
+    void particles_t<real_t, device>::impl::sd_id_new(const it_t &out, const thrust_size_t &n)
+    {
+      thrust::transform(
+        thrust::make_counting_iterator<sd_id_t>(sd_id_ctr),
+        thrust::make_counting_iterator<sd_id_t>(sd_id_ctr) + n,
+        out,
+        detail::sd_id_fctr<sd_id_t>(sd_id_stride, sd_id_offset)
+      );
+      sd_id_ctr += n;
+    }
+
     // resize vectors to n_part
     template <typename real_t, backend_t device>
     void particles_t<real_t, device>::impl::hskpng_resize_npart()
     {
       if(n_part > opts_init.n_sd_max) throw std::runtime_error(detail::formatter() << "n_sd_max (" << opts_init.n_sd_max << ") < n_part (" << n_part << ")");
       {
-        thrust_device::vector<real_t> *vec[] = {&rw2, &rd3, &kpa, &vt, &tmp_device_real_part};
-        for(int i=0; i<5; ++i)
+        thrust_device::vector<real_t> *vec[] = {&rw2, &rd3, &kpa, &vt};
+        for(int i=0; i<4; ++i)
         {
           vec[i]->resize(n_part);
         }
@@ -22,8 +53,20 @@ namespace libcloudphxx
         }
       }
       n.resize(n_part);
-      tmp_device_n_part.resize(n_part);
-      tmp_device_size_part.resize(n_part);
+
+      // SDs added since the last call (in init() or src()) get new ids,
+      // those moved from other slabs come with their own (see xchng_unpack_id())
+      {
+        const thrust_size_t n_id_old = sd_id.size();
+        sd_id.resize(n_part);
+        if(n_part > n_id_old) sd_id_new(sd_id.begin() + n_id_old, n_part - n_id_old);
+      }
+
+      // temporaries registered in init_workspace()
+      ws.resize_part(n_part);
+
+      // particle ids changed
+      presorted = false;
 
       if (opts_init.nx != 0) i.resize(n_part); 
       if (opts_init.ny != 0) j.resize(n_part); 
@@ -33,22 +76,18 @@ namespace libcloudphxx
       if (opts_init.ny != 0) y.resize(n_part); 
       if (opts_init.nz != 0) z.resize(n_part); 
 
-      if(opts_init.chem_switch || opts_init.sstp_cond > 1 || n_dims >= 2)
-      {
-        tmp_device_real_part1.resize(n_part);
-      }
-      if((opts_init.sstp_cond>1 && opts_init.exact_sstp_cond) || n_dims==3)
-      {
-        tmp_device_real_part2.resize(n_part);
-      }
+      if(opts_init.cond_solver == cond_solver_t::newton) cond_drw2_dt.resize(n_part, real_t(0));
 
       if(opts_init.sstp_cond>1 && opts_init.exact_sstp_cond)
       {
-        tmp_device_real_part3.resize(n_part);
-        tmp_device_real_part4.resize(n_part);  
         sstp_tmp_rv.resize(n_part);
         sstp_tmp_th.resize(n_part);
         sstp_tmp_rh.resize(n_part);
+        if(opts_init.adaptive_sstp_cond)
+        {
+          sstp_cond_stride.resize(n_part);
+          sstp_cond_ord.resize(n_part);
+        }
       }
     }
   };
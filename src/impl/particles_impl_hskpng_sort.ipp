@@ -6,14 +6,114 @@
   */
 
 #include <thrust/sequence.h>
+#include <thrust/partition.h>
+#include <thrust/merge.h>
 
 namespace libcloudphxx
 {
   namespace lgrngn
   {
+    namespace detail
+    {
+      struct cell_changed
+      {
+        BOOST_GPU_ENABLED
+        thrust_size_t operator()(const thrust_size_t &ijk_new, const thrust_size_t &ijk_old)
+        {
+          return ijk_new != ijk_old;
+        }
+      };
+
+      enum { shuffle_key_bits = 32 }; // random part of the shuffle key (un is unsigned int)
+
+      struct shuffle_key
+      {
+        BOOST_GPU_ENABLED
+        thrust_size_t operator()(const thrust_size_t &ijk, const unsigned int &rnd)
+        {
+          return (ijk << shuffle_key_bits) | rnd;
+        }
+      };
+    };
+
+    // updates sorted_id and sorted_ijk from a previous sort, only the particles
+    // that changed cell are sorted and then merged with the (still sorted) rest;
+    // returns false if there was no previous sort or too many particles moved
+    template <typename real_t, backend_t device>
+    bool particles_t<real_t, device>::impl::hskpng_sort_incremental()
+    {   
+      if (!presorted) return false;
+
+      thrust_device::vector<thrust_size_t> 
+        &ijk_new(tmp_device_size_part),    // current cell indices in the previous sort order
+        &moved(sorted_ijk),                // flag: has the particle changed cell?
+        &merged_id(tmp_device_size_part1); // output of the merge
+
+      thrust::copy(
+        thrust::make_permutation_iterator(ijk.begin(), sorted_id.begin()), // input - begin
+        thrust::make_permutation_iterator(ijk.begin(), sorted_id.end()),   // input - end
+        ijk_new.begin()                                                    // output
+      );
+
+      thrust::transform(
+        ijk_new.begin(), ijk_new.end(), // 1st arg
+        sorted_ijk.begin(),             // 2nd arg
+        moved.begin(),                  // output (overwrites sorted_ijk)
+        detail::cell_changed()
+      );
+
+      thrust_size_t n_moved = thrust::reduce(moved.begin(), moved.end());
+
+      if (n_moved > config.sort_incremental_max * n_part) return false;
+
+      // particles that did not change cell first, keeping their order
+      typedef thrust::zip_iterator<
+        thrust::tuple<
+          typename thrust_device::vector<thrust_size_t>::iterator,
+          typename thrust_device::vector<thrust_size_t>::iterator
+        >
+      > zip_it_t;
+      zip_it_t zip_it(thrust::make_tuple(ijk_new.begin(), sorted_id.begin()));
+
+      {
+        namespace arg = thrust::placeholders;
+        thrust::stable_partition(
+          zip_it, zip_it + n_part, // data
+          moved.begin(),           // stencil
+          arg::_1 == 0             // predicate
+        );
+      }
+      const thrust_size_t n_stayed = n_part - n_moved;
+
+      // sorting those that changed cell
+      thrust::sort_by_key(
+        ijk_new.begin() + n_stayed, ijk_new.end(), // keys
+        sorted_id.begin() + n_stayed               // values
+      );
+
+      // merging the two sorted sequences
+      thrust::merge_by_key(
+        ijk_new.begin(), ijk_new.begin() + n_stayed, // keys 1
+        ijk_new.begin() + n_stayed, ijk_new.end(),   // keys 2
+        sorted_id.begin(),                           // values 1
+        sorted_id.begin() + n_stayed,                // values 2
+        sorted_ijk.begin(),                          // keys output
+        merged_id.begin()                            // values output
+      );
+      sorted_id.swap(merged_id);
+
+      return true;
+    }
+
     template <typename real_t, backend_t device>
     void particles_t<real_t, device>::impl::hskpng_sort_helper(bool shuffle)
     {   
+      if (!shuffle && opts_init.sort_engine == sort_t::incremental && hskpng_sort_incremental())
+      {
+        sorted = true;
+        return;
+      }
+
       // filling-in sorted_id with a sequence
       thrust::sequence(sorted_id.begin(), sorted_id.end());
 
@@ -24,34 +124,54 @@ namespace libcloudphxx
 	  ijk.begin(), ijk.end(), // from
 	  sorted_ijk.begin()      // to
 	);
+
+        // sorting sorted_ijk and sorted_id
+        thrust::sort_by_key(
+	  sorted_ijk.begin(), sorted_ijk.end(), // keys
+	  sorted_id.begin()                     // values
+        );
       }
       else
       {
+#if defined(__NVCC__) 
+        assert(sizeof(thrust_size_t) >= 8);
+#else
+        static_assert(sizeof(thrust_size_t) >= 8, "");
+#endif
+        assert(n_cell <= (thrust_size_t(1) << detail::shuffle_key_bits));
+
         // generating a random sorting key
         rand_un(n_part);
 
-        // sorting the sequence with the random key
-        thrust::sort_by_key(
-          un.begin(), un.end(),
-          sorted_id.begin()
+        // combining cell index (high bits) with the random key (low bits) so that
+        // a single sort groups particles by cell and shuffles them within each cell
+        thrust_device::vector<thrust_size_t> &key(tmp_device_size_part);
+        thrust::transform(
+          ijk.begin(), ijk.end(), // 1st arg
+          un.begin(),             // 2nd arg
+          key.begin(),            // output
+          detail::shuffle_key()
         );
 
-        // permuting sorted_ijk accordingly
-        thrust::copy(
-          thrust::make_permutation_iterator(ijk.begin(), sorted_id.begin()), // input - begin
-          thrust::make_permutation_iterator(ijk.end(),   sorted_id.end()  ), // input - end
-          sorted_ijk.begin()                                                 // output
+        thrust::sort_by_key(
+          key.begin(), key.end(), // keys
+          sorted_id.begin()       // values
         );
-      }
 
-      // sorting sorted_ijk and sorted_id
-      thrust::sort_by_key(
-	sorted_ijk.begin(), sorted_ijk.end(), // keys
-	sorted_id.begin()                     // values
-      );
+        // recovering cell indices from the sorted keys
+        {
+          namespace arg = thrust::placeholders;
+          thrust::transform(
+            key.begin(), key.end(), // input
+            sorted_ijk.begin(),     // output
+            arg::_1 >> detail::shuffle_key_bits
+          );
+        }
+      }
 
       // flagging that particles are now sorted
       sorted = true;
+      presorted = true;
     }   
 
     template <typename real_t, backend_t device>
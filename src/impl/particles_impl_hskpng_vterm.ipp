@@ -125,42 +125,129 @@ namespace libcloudphxx
           }
         }   
       }; 
+
+      // the cheap, explicitly computed part of the velocity (the rest is tabulated with opts_init.tab_vterm)
+      template <typename real_t>
+      BOOST_GPU_ENABLED 
+      real_t vt_tab_prefactor(const vt_t::vt_t &vt_eq, const real_t &r, const real_t &T, const real_t &p, const real_t &rhod, const real_t &eta)
+      {
+        switch(vt_eq)
+        {
+          case(vt_t::beard76):
+            return r > real_t(5.035e-4) ? real_t(1) : real_t(common::vterm::vt_beard76_C_ac(
+              r   * si::metres,
+              T   * si::kelvins,
+              p   * si::pascals,
+              eta * si::pascals * si::seconds
+            ));
+          case(vt_t::beard77):
+          case(vt_t::beard77fast):
+            return common::vterm::vt_beard77_fact(
+              r    * si::metres,
+              p    * si::pascals,
+              rhod * si::kilograms / si::cubic_metres,
+              eta  * si::pascals * si::seconds
+            );
+          default:
+            return 1;
+        }
+      }
+
+      // tabulated velocity, exact formula outside of the table
+      template <typename real_t>
+      struct common__vterm__vt__tab
+      {
+        vt_t::vt_t vt_eq; //type of terminal velocity formula to use 
+        vt_table<real_t> tab;
+
+        //ctor
+        common__vterm__vt__tab(const vt_t::vt_t &vt_eq, const vt_table<real_t> &tab): vt_eq(vt_eq), tab(tab) {}
+
+        BOOST_GPU_ENABLED 
+        real_t operator()(
+          const real_t &rw2, 
+          const thrust::tuple<real_t, real_t, real_t, real_t> &tpl // T, p, rhod, eta
+        ) {   
+#if !defined(__NVCC__)
+          using std::sqrt;
+          using std::log;
+#endif
+          const real_t lnr = real_t(.5) * log(rw2), lnrhod = log(thrust::get<2>(tpl));
+
+          if(!tab.in_range(lnr, thrust::get<0>(tpl), lnrhod))
+            return common__vterm__vt<real_t>(vt_eq == vt_t::beard77fast ? vt_t::beard77 : vt_eq)(rw2, tpl);
+
+          return vt_tab_prefactor<real_t>(vt_eq, sqrt(rw2), thrust::get<0>(tpl), thrust::get<1>(tpl), thrust::get<2>(tpl), thrust::get<3>(tpl))
+            * tab(lnr, thrust::get<0>(tpl), lnrhod);
+        }
+      };
    };
 
 
     template <typename real_t, backend_t device>
     void particles_t<real_t, device>::impl::hskpng_vterm_invalid()
+    {   
+      hskpng_vterm_invalid(zero, n_part);
+    }
+
+    // the same for the n SDs with indices given by id
+    template <typename real_t, backend_t device>
+    template <class ix_it_t>
+    void particles_t<real_t, device>::impl::hskpng_vterm_invalid(const ix_it_t &id, const thrust_size_t &n)
     {   
+      typedef thrust::permutation_iterator<
+        typename thrust_device::vector<thrust_size_t>::iterator,
+        ix_it_t
+      > pi_size_t;
       typedef thrust::permutation_iterator<
         typename thrust_device::vector<real_t>::iterator,
-        typename thrust_device::vector<thrust_size_t>::iterator
+        pi_size_t
       > pi_t;
       typedef thrust::zip_iterator<thrust::tuple<pi_t, pi_t, pi_t, pi_t> > zip_it_t;
 
       namespace arg = thrust::placeholders;
 
-      if(opts_init.terminal_velocity == vt_t::beard77fast) //use cached vt at sea level
+      const pi_size_t ijk_it(ijk.begin(), id);
+      const thrust::permutation_iterator<typename thrust_device::vector<real_t>::iterator, ix_it_t>
+        rw2_it(rw2.begin(), id),
+        vt_it(vt.begin(), id);
+
+      if(opts_init.tab_vterm) // tabulated vt
+        thrust::transform_if(
+          rw2_it, rw2_it + n,                                     // input - 1st arg
+          zip_it_t(thrust::make_tuple(
+            pi_t(T.begin(),    ijk_it),
+            pi_t(p.begin(),    ijk_it),
+            pi_t(rhod.begin(), ijk_it),
+            pi_t(eta.begin(),  ijk_it)
+          )),                                                     // input - 2nd arg   
+          vt_it,                                                  // condition argument
+          vt_it,                                                  // output
+          detail::common__vterm__vt__tab<real_t>(opts_init.terminal_velocity, vt_tab),
+          arg::_1 == real_t(detail::invalid)
+        );
+      else if(opts_init.terminal_velocity == vt_t::beard77fast) //use cached vt at sea level
       {
-        thrust_device::vector<thrust_size_t> &vt0_bin(tmp_device_size_part);
+        const pi_size_t vt0_bin_it(tmp_device_size_part.begin(), id);
         // get cached bin number
         thrust::transform_if(
-          rw2.begin(), rw2.end(),
-          vt.begin(),
-          vt0_bin.begin(),
+          rw2_it, rw2_it + n,
+          vt_it,
+          vt0_bin_it,
           detail::get_vt0_bin<real_t>(config.vt0_ln_r_min, config.vt0_ln_r_max, config.vt0_n_bin),
           arg::_1 == real_t(detail::invalid)
         );
         // calc the vt
         thrust::transform_if(
-          rw2.begin(), rw2.end(),                                 // input - 1st arg
+          rw2_it, rw2_it + n,                                     // input - 1st arg
           zip_it_t(thrust::make_tuple(
-            thrust::make_permutation_iterator(vt_0.begin(), vt0_bin.begin()),
-            thrust::make_permutation_iterator(p.begin(),    ijk.begin()),
-            thrust::make_permutation_iterator(rhod.begin(), ijk.begin()),
-            thrust::make_permutation_iterator(eta.begin(),  ijk.begin())
+            pi_t(vt_0.begin(), vt0_bin_it),
+            pi_t(p.begin(),    ijk_it),
+            pi_t(rhod.begin(), ijk_it),
+            pi_t(eta.begin(),  ijk_it)
           )),                                                     // input - 2nd arg   
-          vt.begin(),                                             // condition argument
-          vt.begin(),                                             // output
+          vt_it,                                                  // condition argument
+          vt_it,                                                  // output
           detail::common__vterm__vt__cached<real_t>(opts_init.terminal_velocity),
           arg::_1 == real_t(detail::invalid)
         );
@@ -168,15 +255,15 @@ namespace libcloudphxx
       // non-cached vt
       else
         thrust::transform_if(
-          rw2.begin(), rw2.end(),                                 // input - 1st arg
+          rw2_it, rw2_it + n,                                     // input - 1st arg
           zip_it_t(thrust::make_tuple(
-            thrust::make_permutation_iterator(T.begin(),    ijk.begin()),
-            thrust::make_permutation_iterator(p.begin(),    ijk.begin()),
-            thrust::make_permutation_iterator(rhod.begin(), ijk.begin()),
-            thrust::make_permutation_iterator(eta.begin(),  ijk.begin())
+            pi_t(T.begin(),    ijk_it),
+            pi_t(p.begin(),    ijk_it),
+            pi_t(rhod.begin(), ijk_it),
+            pi_t(eta.begin(),  ijk_it)
           )),                                                     // input - 2nd arg   
-          vt.begin(),                                             // condition argument
-          vt.begin(),                                             // output
+          vt_it,                                                  // condition argument
+          vt_it,                                                  // output
           detail::common__vterm__vt<real_t>(opts_init.terminal_velocity),
           arg::_1 == real_t(detail::invalid)
         );
@@ -191,7 +278,19 @@ namespace libcloudphxx
       > pi_t;
       typedef thrust::zip_iterator<thrust::tuple<pi_t, pi_t, pi_t, pi_t> > zip_it_t;
 
-      if(opts_init.terminal_velocity == vt_t::beard77fast) //use cached vt at sea level
+      if(opts_init.tab_vterm) // tabulated vt
+        thrust::transform(
+          rw2.begin(), rw2.end(),                                 // input - 1st arg
+          zip_it_t(thrust::make_tuple(
+            thrust::make_permutation_iterator(T.begin(),    ijk.begin()),
+            thrust::make_permutation_iterator(p.begin(),    ijk.begin()),
+            thrust::make_permutation_iterator(rhod.begin(), ijk.begin()),
+            thrust::make_permutation_iterator(eta.begin(),  ijk.begin())
+          )),                                                     // input - 2nd arg
+          vt.begin(),                                             // output
+          detail::common__vterm__vt__tab<real_t>(opts_init.terminal_velocity, vt_tab)
+        );
+      else if(opts_init.terminal_velocity == vt_t::beard77fast) //use cached vt at sea level
       {
         thrust_device::vector<thrust_size_t> &vt0_bin(tmp_device_size_part);
         // get cached bin number
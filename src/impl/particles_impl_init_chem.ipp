@@ -138,36 +138,29 @@ namespace libcloudphxx
       // don't do it if not using chem...
       if (opts_init.chem_switch == false) throw std::runtime_error("all chemistry was switched off in opts_init");
 
-      // memory allocation
-      chem_bgn.resize(chem_all);
-      chem_end.resize(chem_all);
-      chem_rhs.resize(     (chem_rhs_fin - chem_rhs_beg) * n_part);
-      chem_ante_rhs.resize((chem_rhs_beg - 0           ) * n_part);
-      chem_post_rhs.resize((chem_all     - chem_rhs_fin) * n_part);
-      chem_stepper.adjust_size(chem_rhs);
+      // memory allocation (also called after the number of SDs changed, with the
+      // rows already compacted to the new n_part at the front of chem_mtx)
+      chem_mtx.reserve(chem_all * opts_init.n_sd_max);
+      chem_mtx.resize(chem_all * n_part);
 
       // helper iterators
+      chem_bgn.resize(chem_all);
+      chem_end.resize(chem_all);
       for (int i = 0; i < chem_all; ++i)
       {
-        thrust_device::vector<real_t> &vec(
-          i < chem_rhs_beg 
-            ? chem_ante_rhs
-            : i < chem_rhs_fin
-	      ? chem_rhs
-	      : chem_post_rhs
-        );
-        const int offset = 
-          i < chem_rhs_beg
-            ? 0
-            : i < chem_rhs_fin
-              ? chem_rhs_beg
-              : chem_rhs_fin;
-        chem_bgn[i] = vec.begin() + (i   - offset) * n_part;
-        chem_end[i] = vec.begin() + (i+1 - offset) * n_part;
+        chem_bgn[i] = chem_mtx.begin() + i * n_part;
+        chem_end[i] = chem_bgn[i] + n_part;
       }
-      assert(chem_end[chem_rhs_beg-1] == chem_ante_rhs.end());
-      assert(chem_end[chem_rhs_fin-1] == chem_rhs.end());
-      assert(chem_end[chem_all-1] == chem_post_rhs.end());
+      assert(chem_end[chem_all-1] == chem_mtx.end());
+
+      chem_stepper.adjust_size(chem_rhs_range());
+    }
+
+    // the species integrated with odeint (SO2 ... S_VI), a contiguous block of chem_mtx
+    template <typename real_t, backend_t device>
+    boost::iterator_range<typename thrust_device::vector<real_t>::iterator> particles_t<real_t, device>::impl::chem_rhs_range()
+    {
+      return boost::make_iterator_range(chem_bgn[chem_rhs_beg], chem_end[chem_rhs_fin-1]);
     }
 
     template <typename real_t, backend_t device>
@@ -37,7 +37,8 @@ namespace libcloudphxx
     )
     {
       // allocating and filling in l2e with values
-      l2e[key].resize(key->size());
+      l2e_t &map = l2e(key);
+      map.idx.resize(key->size());
 
       long int shift =    // index of element of arr copied to 0-th position in key
         + n_cell_bfr // cells in other memory
@@ -48,16 +49,16 @@ namespace libcloudphxx
       {
 	namespace arg = thrust::placeholders;
 	case 0:  
-	  l2e[key][0] = 0;  
+	  map.idx[0] = 0;  
 	  break;
 	case 1:
           assert(arr.strides[0] == 1);
 	  thrust::transform(
             // input
             thrust::make_counting_iterator<int>(0) + shift,                   // long int didnt work
-            thrust::make_counting_iterator<int>(0) + shift + l2e[key].size(), 
+            thrust::make_counting_iterator<int>(0) + shift + map.idx.size(), 
             // output
-            l2e[key].begin(), 
+            map.idx.begin(), 
             // op
             arg::_1
 	  );
@@ -68,9 +69,9 @@ namespace libcloudphxx
 	  thrust::transform(
             // input
             thrust::make_counting_iterator<int>(0) + shift,
-            thrust::make_counting_iterator<int>(0) + shift + l2e[key].size(), 
+            thrust::make_counting_iterator<int>(0) + shift + map.idx.size(), 
             // output
-            l2e[key].begin(), 
+            map.idx.begin(), 
             // op
 	    arr.strides[0] * /* i = */ (arg::_1 / (opts_init.nz + ext_z)) +
 	    arr.strides[1] * /* j = */ (arg::_1 % (opts_init.nz + ext_z))     // module of negative value might not work in 2003 standard?
@@ -81,9 +82,9 @@ namespace libcloudphxx
           thrust::transform(
             // input
             thrust::make_counting_iterator<int>(0) + shift,
-            thrust::make_counting_iterator<int>(0) + shift + l2e[key].size(), 
+            thrust::make_counting_iterator<int>(0) + shift + map.idx.size(), 
             // output
-            l2e[key].begin(),
+            map.idx.begin(),
             // op
 	    arr.strides[0] * /* i = */ (arg::_1 / ((opts_init.nz + ext_z) * (opts_init.ny + ext_y))) +  
             arr.strides[1] * /* j = */ ((arg::_1 / (opts_init.nz + ext_z)) % (opts_init.ny + ext_y)) + 
@@ -95,10 +96,21 @@ namespace libcloudphxx
 
       // apply bcnd for halo
       thrust::transform(
-        l2e[key].begin(), l2e[key].begin() + l2e[key].size(),
-        l2e[key].begin(), // in place 
+        map.idx.begin(), map.idx.begin() + map.idx.size(),
+        map.idx.begin(), // in place 
         detail::periodic_cellno((n_x_tot + ext_x) * arr.strides[0])
       );
+
+      // consecutive indices (e.g. C-ordered arrays without halo) allow bulk copies in sync()
+      map.contiguous = true;
+      for (thrust_size_t i = 1; i < map.idx.size(); ++i)
+      {
+        if (map.idx[i] != map.idx[0] + int(i))
+        {
+          map.contiguous = false;
+          break;
+        }
+      }
     }
   };
 };
@@ -0,0 +1,100 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  * @brief initialisation steps common to init() and restore()
+  */
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    // everything that precedes creating the SDs
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::init_eulerian(
+      const arrinfo_t<real_t> th,
+      const arrinfo_t<real_t> rv,
+      const arrinfo_t<real_t> rhod,
+      const arrinfo_t<real_t> courant_x, // might be NULL
+      const arrinfo_t<real_t> courant_y, // might be NULL
+      const arrinfo_t<real_t> courant_z, // might be NULL
+      const std::map<enum chem_species_t, const arrinfo_t<real_t> > ambient_chem
+    )
+    {
+      init_sanity_check(th, rv, rhod, courant_x, courant_y, courant_z, ambient_chem);
+
+      // initialising Eulerian-Lagrangian coupling
+      init_sync();  // also, init of ambient_chem vectors
+      init_e2l(th,   &th);
+      init_e2l(rv,   &rv);
+      init_e2l(rhod, &rhod);
+      l2e_scalars_shared = 
+        thrust::equal(l2e_rv.idx.begin(),   l2e_rv.idx.end(),   l2e_th.idx.begin()) &&
+        thrust::equal(l2e_rhod.idx.begin(), l2e_rhod.idx.end(), l2e_th.idx.begin());
+
+#if !defined(__NVCC__)
+      using std::max;
+#endif
+      if (!courant_x.is_null())  init_e2l(courant_x, &courant_x, 1, 0, 0, - halo_x );
+      if (!courant_y.is_null())  init_e2l(courant_y, &courant_y, 0, 1, 0, n_x_bfr * opts_init.nz - halo_y);
+      if (!courant_z.is_null())  init_e2l(courant_z, &courant_z, 0, 0, 1, n_x_bfr * max(1, opts_init.ny) - halo_z);
+
+      if (opts_init.chem_switch)
+	for (int i = 0; i < chem_gas_n; ++i)
+	  init_e2l(ambient_chem.at((chem_species_t)i), &ambient_chem[(chem_species_t)i]);
+
+      // feeding in Eulerian fields
+      sync(th, rv, rhod);
+
+      if (!courant_x.is_null()) sync(courant_x, courant_x);
+      if (!courant_y.is_null()) sync(courant_y, courant_y);
+      if (!courant_z.is_null()) sync(courant_z, courant_z);
+
+      // x halo from the neighbouring ranks
+      if (distmem_mpi())
+      {
+        xchng_courants_mpi_post();
+        xchng_courants_mpi_wait();
+      }
+
+      // check if courants arent greater than 1 since it would break the predictor-corrector (halo of size 1 in the x direction) 
+      assert(opts_init.adve_scheme != as_t::pred_corr || (courant_x.is_null() || ((*(thrust::min_element(courant_x.begin(), courant_x.end()))) >= real_t(-1.) )) );
+      assert(opts_init.adve_scheme != as_t::pred_corr || (courant_x.is_null() || ((*(thrust::max_element(courant_x.begin(), courant_x.end()))) <= real_t( 1.) )) );
+
+      if (opts_init.chem_switch)
+	for (int i = 0; i < chem_gas_n; ++i)
+	  sync(
+            ambient_chem.at((chem_species_t)i), 
+            ambient_chem[(chem_species_t)i]
+          );
+
+      // initialising housekeeping data of the size ncell
+      init_hskpng_ncell(); 
+
+      // initialising helper data for advection (Arakawa-C grid neighbours' indices)
+      // and cell volumes
+      init_grid();
+
+      // initialising Tpr
+      hskpng_Tpr(); 
+
+      // reserve memory for data of the size of the max number of SDs
+      init_hskpng_npart();
+    }
+
+    // everything that follows creating the SDs
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::init_finalize()
+    {
+      //initialising collision kernel
+      if(opts_init.coal_switch) init_kernel();
+
+      //initialising vterm
+      if(opts_init.coal_switch || opts_init.sedi_switch) init_vterm();
+
+      // init count_num and count_ijk
+      hskpng_count();
+    }
+  };
+};
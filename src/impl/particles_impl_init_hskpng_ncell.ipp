@@ -17,12 +17,22 @@ namespace libcloudphxx
       p.resize(n_cell);
       RH.resize(n_cell); 
       eta.resize(n_cell); 
+      Sc.resize(n_cell); 
+      Pr.resize(n_cell); 
+      lambda_D.resize(n_cell); 
+      lambda_K.resize(n_cell); 
 
       count_ijk.resize(n_cell);
       count_num.resize(n_cell);
       count_mom.resize(n_cell);
       count_n = 0;
 
+      if(opts_init.adaptive_sstp_coal)
+      {
+        sstp_coal_cell.resize(n_cell);
+        thrust::fill(sstp_coal_cell.begin(), sstp_coal_cell.end(), opts_init.sstp_coal);
+      }
+
       if(opts_init.sstp_cond > 1 && !opts_init.exact_sstp_cond)
       {
         sstp_tmp_rv.resize(n_cell);
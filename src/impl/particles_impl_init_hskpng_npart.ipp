@@ -28,40 +28,52 @@ namespace libcloudphxx
 
       sorted_id.reserve(opts_init.n_sd_max);
       sorted_ijk.reserve(opts_init.n_sd_max);
+      sd_id.reserve(opts_init.n_sd_max);
       
-      tmp_device_real_part.reserve(opts_init.n_sd_max);
-      tmp_device_n_part.reserve(opts_init.n_sd_max);
-      tmp_device_size_part.reserve(opts_init.n_sd_max);
+      // temporaries
+      init_workspace();
 
       rd3.reserve(opts_init.n_sd_max);
       rw2.reserve(opts_init.n_sd_max);
       n.reserve(opts_init.n_sd_max);
       kpa.reserve(opts_init.n_sd_max);
+      if(opts_init.cond_solver == cond_solver_t::newton) cond_drw2_dt.reserve(opts_init.n_sd_max);
 
-      if(opts_init.chem_switch || opts_init.sstp_cond > 1 || n_dims >= 2)
-      {
-        tmp_device_real_part1.reserve(opts_init.n_sd_max); 
-      }
-      if((opts_init.sstp_cond>1 && opts_init.exact_sstp_cond) || n_dims==3)
-      {
-        tmp_device_real_part2.reserve(opts_init.n_sd_max); 
-      }
       if(opts_init.sstp_cond>1 && opts_init.exact_sstp_cond)
       {
-        tmp_device_real_part3.reserve(opts_init.n_sd_max); 
-        tmp_device_real_part4.reserve(opts_init.n_sd_max);  
         sstp_tmp_rv.resize(opts_init.n_sd_max);
         sstp_tmp_th.resize(opts_init.n_sd_max);
         sstp_tmp_rh.resize(opts_init.n_sd_max);
+        if(opts_init.adaptive_sstp_cond)
+        {
+          sstp_cond_stride.reserve(opts_init.n_sd_max);
+          sstp_cond_ord.reserve(opts_init.n_sd_max);
+        }
       }
       // reserve memory for in/out buffers
-      if(opts_init.dev_count > 1)
+      if(distmem())
       {
-        in_n_bfr.resize(opts_init.n_sd_max / opts_init.nx / config.bfr_fraction);     // for n
-        out_n_bfr.resize(opts_init.n_sd_max / opts_init.nx / config.bfr_fraction);
+        // MPI transfers to the left and to the right are in flight at once, each using one half
+        const int n_dirs = distmem_mpi() ? 2 : 1;
+
+        in_n_bfr.resize(n_dirs * opts_init.n_sd_max / opts_init.nx / config.bfr_fraction);     // for n
+        out_n_bfr.resize(n_dirs * opts_init.n_sd_max / opts_init.nx / config.bfr_fraction);
+
+        in_id_bfr.resize(in_n_bfr.size());     // for sd_id
+        out_id_bfr.resize(out_n_bfr.size());
+
+        in_real_bfr.resize(n_dirs * 11 * opts_init.n_sd_max / opts_init.nx / config.bfr_fraction);     // for rd3 rw2 kpa vt x y z  sstp_tmp_th/rv/rh cond_drw2_dt
+        out_real_bfr.resize(n_dirs * 11 * opts_init.n_sd_max / opts_init.nx / config.bfr_fraction);
 
-        in_real_bfr.resize(10 * opts_init.n_sd_max / opts_init.nx / config.bfr_fraction);     // for rd3 rw2 kpa vt x y z  sstp_tmp_th/rv/rh
-        out_real_bfr.resize(10 * opts_init.n_sd_max / opts_init.nx / config.bfr_fraction);
+#if defined(USE_MPI) && defined(__NVCC__)
+        // host staging of the MPI transfers (send and receive in both directions), see detail::mpi_xchng_t
+        if(distmem_mpi())
+        {
+          tmp_host_n_pool.reserve(4, in_n_bfr.size() / 2);
+          tmp_host_id_pool.reserve(4, in_id_bfr.size() / 2);
+          tmp_host_real_pool.reserve(4, in_real_bfr.size() / 2);
+        }
+#endif
       }
     }
   };
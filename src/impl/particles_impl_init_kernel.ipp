@@ -22,7 +22,6 @@ namespace libcloudphxx
 
           // init kernel
           k_golovin.resize(1, kernel_golovin<real_t, n_t> (kernel_parameters.data()));
-          p_kernel = (&(k_golovin[0])).get();
           break;
 
         case(kernel_t::geometric):
@@ -38,13 +37,11 @@ namespace libcloudphxx
 
             // init kernel
             k_geometric_with_multiplier.resize(1, kernel_geometric_with_multiplier<real_t, n_t> (kernel_parameters.data()));
-            p_kernel = (&(k_geometric_with_multiplier[0])).get();
           }
           else //without multiplier
           {
             // init kernel
             k_geometric.resize(1, kernel_geometric<real_t, n_t> ());
-            p_kernel = (&(k_geometric[0])).get();
           }
           break;
 
@@ -56,7 +53,6 @@ namespace libcloudphxx
           }
             // init kernel
             k_long.resize(1, kernel_long<real_t, n_t> ());
-            p_kernel = (&(k_long[0])).get();
           break;
   
         //Hall kernel
@@ -65,8 +61,8 @@ namespace libcloudphxx
           {
             throw std::runtime_error("Hall kernel doesn't accept parameters.");
           }
-          //read in kernel efficiencies to a temporary container
-          detail::hall_efficiencies<real_t> (tmp_kernel_eff);
+          //read in kernel efficiencies (built-in or from opts_init.kernel_eff_file) to a temporary container
+          detail::efficiencies<real_t>(opts_init, tmp_kernel_eff);
          
           //reserve device memory for kernel parameters vector
           kernel_parameters.resize(opts_init.kernel_parameters.size() + tmp_kernel_eff.size());
@@ -75,8 +71,7 @@ namespace libcloudphxx
           thrust::copy(tmp_kernel_eff.begin(), tmp_kernel_eff.end(), kernel_parameters.begin()+n_user_params);
 
           // init kernel
-          k_geometric_with_efficiencies.resize(1, kernel_geometric_with_efficiencies<real_t, n_t> (kernel_parameters.data(), detail::hall_r_max<real_t>()));
-          p_kernel = (&(k_geometric_with_efficiencies[0])).get();
+          k_geometric_with_efficiencies.resize(1, kernel_geometric_with_efficiencies<real_t, n_t> (kernel_parameters.data(), detail::efficiencies_r_max<real_t>(tmp_kernel_eff.size())));
           break;
 
 
@@ -86,8 +81,8 @@ namespace libcloudphxx
           {
             throw std::runtime_error("Hall + Davis kernel doesn't accept parameters.");
           }
-          //read in kernel efficiencies to a temporary container
-          detail::hall_davis_no_waals_efficiencies<real_t> (tmp_kernel_eff);
+          //read in kernel efficiencies (built-in or from opts_init.kernel_eff_file) to a temporary container
+          detail::efficiencies<real_t>(opts_init, tmp_kernel_eff);
          
           //reserve device memory for kernel parameters vector
           kernel_parameters.resize(opts_init.kernel_parameters.size() + tmp_kernel_eff.size());
@@ -96,8 +91,7 @@ namespace libcloudphxx
           thrust::copy(tmp_kernel_eff.begin(), tmp_kernel_eff.end(), kernel_parameters.begin()+n_user_params);
 
           // init kernel
-          k_geometric_with_efficiencies.resize(1, kernel_geometric_with_efficiencies<real_t, n_t> (kernel_parameters.data(), detail::hall_davis_no_waals_r_max<real_t>()));
-          p_kernel = (&(k_geometric_with_efficiencies[0])).get();
+          k_geometric_with_efficiencies.resize(1, kernel_geometric_with_efficiencies<real_t, n_t> (kernel_parameters.data(), detail::efficiencies_r_max<real_t>(tmp_kernel_eff.size())));
           break;
 
         //Vohl kernel with Davis and Jones (no van der Waals) efficiencies for small molecules
@@ -106,8 +100,8 @@ namespace libcloudphxx
           {
             throw std::runtime_error("Vohl + Davis kernel doesn't accept parameters.");
           }
-          //read in kernel efficiencies to a temporary container
-          detail::vohl_davis_no_waals_efficiencies<real_t> (tmp_kernel_eff);
+          //read in kernel efficiencies (built-in or from opts_init.kernel_eff_file) to a temporary container
+          detail::efficiencies<real_t>(opts_init, tmp_kernel_eff);
          
           //reserve device memory for kernel parameters vector
           kernel_parameters.resize(opts_init.kernel_parameters.size() + tmp_kernel_eff.size());
@@ -116,8 +110,7 @@ namespace libcloudphxx
           thrust::copy(tmp_kernel_eff.begin(), tmp_kernel_eff.end(), kernel_parameters.begin()+n_user_params);
 
           // init kernel
-          k_geometric_with_efficiencies.resize(1, kernel_geometric_with_efficiencies<real_t, n_t> (kernel_parameters.data(), detail::vohl_davis_no_waals_r_max<real_t>()));
-          p_kernel = (&(k_geometric_with_efficiencies[0])).get();
+          k_geometric_with_efficiencies.resize(1, kernel_geometric_with_efficiencies<real_t, n_t> (kernel_parameters.data(), detail::efficiencies_r_max<real_t>(tmp_kernel_eff.size())));
           break;
 
         //Hall efficiencies plus turbulent efficiencies from Pinsky (2008) for stratocumuli (r<=21 um)
@@ -126,8 +119,8 @@ namespace libcloudphxx
           {
             throw std::runtime_error("Hall + Pinsky (stratocumulus) kernel doesn't accept parameters.");
           }
-          //read in kernel efficiencies to a temporary container
-          detail::hall_pinsky_stratocumulus_efficiencies<real_t> (tmp_kernel_eff);
+          //read in kernel efficiencies (built-in or from opts_init.kernel_eff_file) to a temporary container
+          detail::efficiencies<real_t>(opts_init, tmp_kernel_eff);
          
           //reserve device memory for kernel parameters vector
           kernel_parameters.resize(opts_init.kernel_parameters.size() + tmp_kernel_eff.size());
@@ -136,8 +129,7 @@ namespace libcloudphxx
           thrust::copy(tmp_kernel_eff.begin(), tmp_kernel_eff.end(), kernel_parameters.begin()+n_user_params);
 
           // init kernel
-          k_geometric_with_efficiencies.resize(1, kernel_geometric_with_efficiencies<real_t, n_t> (kernel_parameters.data(), detail::hall_pinsky_stratocumulus_r_max<real_t>()));
-          p_kernel = (&(k_geometric_with_efficiencies[0])).get();
+          k_geometric_with_efficiencies.resize(1, kernel_geometric_with_efficiencies<real_t, n_t> (kernel_parameters.data(), detail::efficiencies_r_max<real_t>(tmp_kernel_eff.size())));
           break;
 
         //Hall kernel with Pinsky gravitational (stagnant) efficiencies for small molecules at p=1000mb
@@ -146,8 +138,8 @@ namespace libcloudphxx
           {
             throw std::runtime_error("Hall + Pinsky (gravitational 1000mb) kernel doesn't accept parameters.");
           }
-          //read in kernel efficiencies to a temporary container
-          detail::hall_pinsky_1000mb_grav_efficiencies<real_t> (tmp_kernel_eff);
+          //read in kernel efficiencies (built-in or from opts_init.kernel_eff_file) to a temporary container
+          detail::efficiencies<real_t>(opts_init, tmp_kernel_eff);
          
           //reserve device memory for kernel parameters vector
           kernel_parameters.resize(opts_init.kernel_parameters.size() + tmp_kernel_eff.size());
@@ -156,8 +148,7 @@ namespace libcloudphxx
           thrust::copy(tmp_kernel_eff.begin(), tmp_kernel_eff.end(), kernel_parameters.begin()+n_user_params);
 
           // init kernel
-          k_geometric_with_efficiencies.resize(1, kernel_geometric_with_efficiencies<real_t, n_t> (kernel_parameters.data(), detail::hall_pinsky_1000mb_grav_r_max<real_t>()));
-          p_kernel = (&(k_geometric_with_efficiencies[0])).get();
+          k_geometric_with_efficiencies.resize(1, kernel_geometric_with_efficiencies<real_t, n_t> (kernel_parameters.data(), detail::efficiencies_r_max<real_t>(tmp_kernel_eff.size())));
           break;
 
         //Hall efficiencies plus turbulent efficiencies from Pinsky (2008) for cumulonimbus (r<=21 um)
@@ -166,8 +157,8 @@ namespace libcloudphxx
           {
             throw std::runtime_error("Hall + Pinsky (cumulonimbus) kernel doesn't accept parameters.");
           }
-          //read in kernel efficiencies to a temporary container
-          detail::hall_pinsky_cumulonimbus_efficiencies<real_t> (tmp_kernel_eff);
+          //read in kernel efficiencies (built-in or from opts_init.kernel_eff_file) to a temporary container
+          detail::efficiencies<real_t>(opts_init, tmp_kernel_eff);
          
           //reserve device memory for kernel parameters vector
           kernel_parameters.resize(opts_init.kernel_parameters.size() + tmp_kernel_eff.size());
@@ -176,8 +167,7 @@ namespace libcloudphxx
           thrust::copy(tmp_kernel_eff.begin(), tmp_kernel_eff.end(), kernel_parameters.begin()+n_user_params);
 
           // init kernel
-          k_geometric_with_efficiencies.resize(1, kernel_geometric_with_efficiencies<real_t, n_t> (kernel_parameters.data(), detail::hall_pinsky_cumulonimbus_r_max<real_t>()));
-          p_kernel = (&(k_geometric_with_efficiencies[0])).get();
+          k_geometric_with_efficiencies.resize(1, kernel_geometric_with_efficiencies<real_t, n_t> (kernel_parameters.data(), detail::efficiencies_r_max<real_t>(tmp_kernel_eff.size())));
           break;
 
         //Onishi turbulent kernel (Onishi 2015 JAS) with Hall, Davis and Jones (no van der Waals) efficiencies 
@@ -186,8 +176,8 @@ namespace libcloudphxx
           {
             throw std::runtime_error("Please supply two kernel parameters: rate of dissipation epsilon [m^2/s^3] and Taylor microscale Reynolds number.");
           }
-          //read in kernel efficiencies to a temporary container
-          detail::hall_davis_no_waals_efficiencies<real_t> (tmp_kernel_eff);
+          //read in kernel efficiencies (built-in or from opts_init.kernel_eff_file) to a temporary container
+          detail::efficiencies<real_t>(opts_init, tmp_kernel_eff);
          
           //reserve device memory for kernel parameters vector
           kernel_parameters.resize(opts_init.kernel_parameters.size() + tmp_kernel_eff.size());
@@ -199,8 +189,7 @@ namespace libcloudphxx
           thrust::copy(tmp_kernel_eff.begin(), tmp_kernel_eff.end(), kernel_parameters.begin()+n_user_params);
 
           // init kernel
-          k_onishi.resize(1, kernel_onishi<real_t, n_t> (kernel_parameters.data(), detail::hall_davis_no_waals_r_max<real_t>()));
-          p_kernel = (&(k_onishi[0])).get();
+          k_onishi.resize(1, kernel_onishi<real_t, n_t> (kernel_parameters.data(), detail::efficiencies_r_max<real_t>(tmp_kernel_eff.size())));
           break;
 
         //Onishi turbulent kernel (Onishi 2015 JAS) with Hall  efficiencies 
@@ -209,8 +198,8 @@ namespace libcloudphxx
           {
             throw std::runtime_error("Please supply two kernel parameters: rate of dissipation epsilon [m^2/s^3] and Taylor microscale Reynolds number.");
           }
-          //read in kernel efficiencies to a temporary container
-          detail::hall_efficiencies<real_t> (tmp_kernel_eff);
+          //read in kernel efficiencies (built-in or from opts_init.kernel_eff_file) to a temporary container
+          detail::efficiencies<real_t>(opts_init, tmp_kernel_eff);
          
           //reserve device memory for kernel parameters vector
           kernel_parameters.resize(opts_init.kernel_parameters.size() + tmp_kernel_eff.size());
@@ -222,13 +211,46 @@ namespace libcloudphxx
           thrust::copy(tmp_kernel_eff.begin(), tmp_kernel_eff.end(), kernel_parameters.begin()+n_user_params);
 
           // init kernel
-          k_onishi.resize(1, kernel_onishi<real_t, n_t> (kernel_parameters.data(), detail::hall_r_max<real_t>()));
-          p_kernel = (&(k_onishi[0])).get();
+          k_onishi.resize(1, kernel_onishi<real_t, n_t> (kernel_parameters.data(), detail::efficiencies_r_max<real_t>(tmp_kernel_eff.size())));
           break;
 
         default:
           ;
       }
+
+      // optional tabulation of the radius-dependent part of the kernel
+      if(opts_init.tab_kernel)
+      {
+        switch(opts_init.kernel)
+        {
+          case(kernel_t::Long):
+            k_long_tab.resize(1, kernel_tabulated<real_t, n_t, kernel_long<real_t, n_t> > (
+              k_long[0], init_kernel_tab(k_long[0], config.kernel_tab_long_r_max)
+            ));
+            break;
+
+          case(kernel_t::hall):
+          case(kernel_t::hall_davis_no_waals):
+          case(kernel_t::vohl_davis_no_waals):
+          case(kernel_t::hall_pinsky_stratocumulus):
+          case(kernel_t::hall_pinsky_cumulonimbus):
+          case(kernel_t::hall_pinsky_1000mb_grav):
+            k_geometric_with_efficiencies_tab.resize(1, kernel_tabulated<real_t, n_t, kernel_geometric_with_efficiencies<real_t, n_t> > (
+              k_geometric_with_efficiencies[0], init_kernel_tab(k_geometric_with_efficiencies[0], k_geometric_with_efficiencies[0].r_max * real_t(1e-6)) // r_max in um
+            ));
+            break;
+
+          case(kernel_t::onishi_hall):
+          case(kernel_t::onishi_hall_davis_no_waals):
+            k_onishi_tab.resize(1, kernel_tabulated<real_t, n_t, kernel_onishi<real_t, n_t> > (
+              k_onishi[0], init_kernel_tab(k_onishi[0], k_onishi[0].r_max * real_t(1e-6)) // r_max in um
+            ));
+            break;
+
+          default:
+            throw std::runtime_error("opts_init.tab_kernel is available only for the Long, Hall-like and Onishi kernels");
+        }
+      }
     }
   }
 }
@@ -0,0 +1,63 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  */
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    // tabulates the radius-dependent multiplier of the kernel on a log-spaced grid 
+    // from opts_init.tab_kernel_r_min to r_max and estimates the interpolation error
+    template <typename real_t, backend_t device>
+    template <class kernel_T>
+    detail::kernel_tab<real_t> particles_t<real_t, device>::impl::init_kernel_tab(const kernel_T &kernel, const real_t &r_max)
+    {
+      if (!(r_max > opts_init.tab_kernel_r_min)) throw std::runtime_error("opts_init.tab_kernel_r_min exceeds the upper limit of the kernel table");
+
+      const int n = opts_init.tab_kernel_n_r;
+
+      kernel_tab_data.resize(thrust_size_t(n) * n);
+
+      detail::kernel_tab<real_t> tab;
+      tab.data = kernel_tab_data.data();
+      tab.n = n;
+      tab.ln_r_min = log(opts_init.tab_kernel_r_min);
+      tab.dlnr = (log(r_max) - tab.ln_r_min) / (n - 1);
+
+      thrust::transform(
+        zero, zero + kernel_tab_data.size(), 
+        kernel_tab_data.begin(),
+        detail::kernel_tab_fill<real_t, kernel_T>(kernel, tab)
+      );
+      nancheck(kernel_tab_data, "kernel_tab_data after tabulation");
+
+      // error estimate over the whole range of the table, on a grid config.kernel_tab_err_sub times finer
+      const detail::kernel_tab_err<real_t, kernel_T> err(kernel, tab, config.kernel_tab_err_sub);
+      const real_t err_max = thrust::reduce(
+        thrust::make_transform_iterator(zero, err),
+        thrust::make_transform_iterator(zero, err) + err.m * err.m,
+        real_t(0),
+        thrust::maximum<real_t>()
+      );
+      const real_t f_max = thrust::reduce(
+        kernel_tab_data.begin(), kernel_tab_data.end(),
+        real_t(0),
+        thrust::maximum<real_t>()
+      );
+
+      kernel_tab_info.n_r = n;
+      kernel_tab_info.r_min = opts_init.tab_kernel_r_min;
+      kernel_tab_info.r_max = r_max;
+      kernel_tab_info.err_max = err_max;
+      kernel_tab_info.err_rel = f_max > 0 ? err_max / f_max : 0;
+
+      return tab;
+    }
+  };
+};
@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <limits>
 
 #include <thrust/host_vector.h>
 #include <thrust/sort.h>
@@ -49,9 +50,11 @@ namespace libcloudphxx
       const common::unary_function<real_t> &n_of_lnrd_stp 
     )
     {
-      // temporary space on the host 
-      thrust::host_vector<real_t> tmp_real(n_part_to_init);
-      thrust::host_vector<thrust_size_t> tmp_ijk(n_part_to_init);
+      // temporary space on the host (reserved in init_workspace())
+      auto tmp_real_lease = tmp_host_real_pool.acquire(n_part_to_init);
+      auto tmp_ijk_lease = tmp_host_size_pool.acquire(n_part_to_init);
+      thrust::host_vector<real_t> &tmp_real(*tmp_real_lease);
+      thrust::host_vector<thrust_size_t> &tmp_ijk(*tmp_ijk_lease);
       thrust::host_vector<real_t> &tmp_rhod(tmp_host_real_cell);
 
       thrust::copy(
@@ -111,6 +114,10 @@ namespace libcloudphxx
           );
         }
 
+        // detecting possible overflows of n type
+        if (tmp_real.size() > 0 && detail::n_overflows<n_t>(*thrust::max_element(tmp_real.begin(), tmp_real.end())))
+          throw std::runtime_error(detail::formatter() << "multiplicity overflow at initialisation (n_t is " << 8 * sizeof(n_t) << "-bit), increase sd_conc");
+
 	// host -> device (includes casting from real_t to uint! and rounding)
 	thrust::copy(
           thrust::make_transform_iterator(tmp_real.begin(), arg::_1 + real_t(0.5)),
@@ -118,15 +125,13 @@ namespace libcloudphxx
           n.begin() + n_part_old
         ); 
       }
-        
-      // detecting possible overflows of n type
-      thrust_size_t ix = thrust::max_element(n.begin() + n_part_old, n.end()) - (n.begin() + n_part_old);
-      assert(n[ix] < (typename impl::n_t)(-1) / 10000);
     }
 
     template <typename real_t, backend_t device>
     void particles_t<real_t, device>::impl::init_n_const_multi(const thrust_size_t &const_multi)
     {
+      if (const_multi > std::numeric_limits<n_t>::max())
+        throw std::runtime_error(detail::formatter() << "multiplicity overflow at initialisation (n_t is " << 8 * sizeof(n_t) << "-bit), decrease sd_const_multi");
       thrust::fill(n.begin() + n_part_old, n.end(), const_multi);
     }
   };
@@ -114,6 +114,15 @@ namespace libcloudphxx
         }
         if (opts_init.sedi_switch)
           if(opts_init.terminal_velocity == vt_t::undefined) throw std::runtime_error("please specify opts_init.terminal_velocity or turn off opts_init.sedi_switch");
+        if (opts_init.sstp_coal < 1) throw std::runtime_error("opts_init.sstp_coal < 1");
+        if (opts_init.adaptive_sstp_coal && opts_init.sstp_coal_max < opts_init.sstp_coal) throw std::runtime_error("opts_init.sstp_coal_max < opts_init.sstp_coal");
+        if (!opts_init.kernel_eff_file.empty() && (opts_init.kernel == kernel_t::golovin || opts_init.kernel == kernel_t::geometric || opts_init.kernel == kernel_t::Long))
+          throw std::runtime_error("opts_init.kernel_eff_file can only be used with kernels based on collision efficiencies");
+        if (opts_init.tab_kernel && opts_init.tab_kernel_n_r < 2) throw std::runtime_error("opts_init.tab_kernel_n_r < 2");
+        if (opts_init.tab_kernel && !(opts_init.tab_kernel_r_min > 0)) throw std::runtime_error("!(opts_init.tab_kernel_r_min > 0)");
+        if (opts_init.adaptive_sstp_cond && !opts_init.exact_sstp_cond) throw std::runtime_error("opts_init.adaptive_sstp_cond requires opts_init.exact_sstp_cond");
+        if (opts_init.reorder_freq < 0) throw std::runtime_error("opts_init.reorder_freq < 0");
+        if (!(opts_init.reorder_threshold >= 0 && opts_init.reorder_threshold <= 1)) throw std::runtime_error("!(opts_init.reorder_threshold >= 0 & opts_init.reorder_threshold <= 1)");
     }
   };
 };
@@ -35,7 +35,9 @@ namespace libcloudphxx
     template <typename real_t, backend_t device>
     void particles_t<real_t, device>::impl::init_vterm()
     {
-      if(opts_init.terminal_velocity != vt_t::beard77fast) return; // it's the only term velocity formula using cached velocities
+      if(opts_init.tab_vterm) init_vterm_tab(); // any formula, interpolated in (ln r, T, ln rhod)
+
+      if(opts_init.terminal_velocity != vt_t::beard77fast) return; // it's the only term velocity formula using cached velocities at sea level
 
       vt_0.resize(config.vt0_n_bin);
       
@@ -0,0 +1,131 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  */
+
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/iterator/transform_iterator.h>
+#include <libcloudph++/common/moist_air.hpp>
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      // exact velocity and its prefactor at a given point of the table;
+      // pressure is taken as that of dry air, it does not affect the tabulated part
+      template <typename real_t>
+      BOOST_GPU_ENABLED 
+      real_t vt_tab_exact(const vt_t::vt_t &vt_eq, const real_t &r, const real_t &T, const real_t &rhod, real_t &prefactor)
+      {
+        const real_t 
+          p = rhod * T * (common::moist_air::R_d<real_t>() / si::joules * si::kilograms * si::kelvins),
+          eta = common::vterm::visc(T * si::kelvins) / si::pascals / si::seconds;
+
+        prefactor = vt_tab_prefactor<real_t>(vt_eq, r, T, p, rhod, eta);
+        return common__vterm__vt<real_t>(vt_eq == vt_t::beard77fast ? vt_t::beard77 : vt_eq)(r * r, thrust::make_tuple(T, p, rhod, eta));
+      }
+
+      template <typename real_t>
+      struct vt_tab_fill
+      {
+        const vt_t::vt_t vt_eq;
+        const vt_table<real_t> tab;
+
+        vt_tab_fill(const vt_t::vt_t &vt_eq, const vt_table<real_t> &tab) : vt_eq(vt_eq), tab(tab) {}
+
+        BOOST_GPU_ENABLED
+        real_t operator()(const thrust_size_t &ix) const
+        {
+#if !defined(__NVCC__)
+          using std::exp;
+          using std::log;
+#endif
+          const int 
+            i_d = ix % tab.n_rhod,
+            i_T = (ix / tab.n_rhod) % tab.n_T,
+            i_r = ix / (thrust_size_t(tab.n_rhod) * tab.n_T);
+
+          real_t prefactor;
+          const real_t vt = vt_tab_exact<real_t>(vt_eq, 
+            exp(tab.ln_r_min + i_r * tab.dlnr), 
+            tab.T_min + i_T * tab.dT, 
+            exp(tab.ln_rhod_min + i_d * tab.dlnrhod), 
+            prefactor
+          );
+          return log(vt / prefactor);
+        }
+      };
+
+      // relative error of the tabulated velocity in the centre of a table cell
+      template <typename real_t>
+      struct vt_tab_err
+      {
+        const vt_t::vt_t vt_eq;
+        const vt_table<real_t> tab;
+
+        vt_tab_err(const vt_t::vt_t &vt_eq, const vt_table<real_t> &tab) : vt_eq(vt_eq), tab(tab) {}
+
+        BOOST_GPU_ENABLED
+        real_t operator()(const thrust_size_t &ix) const
+        {
+#if !defined(__NVCC__)
+          using std::exp;
+          using std::abs;
+#endif
+          const int 
+            i_d = ix % (tab.n_rhod - 1),
+            i_T = (ix / (tab.n_rhod - 1)) % (tab.n_T - 1),
+            i_r = ix / (thrust_size_t(tab.n_rhod - 1) * (tab.n_T - 1));
+          const real_t
+            lnr    = tab.ln_r_min    + (i_r + real_t(.5)) * tab.dlnr,
+            T      = tab.T_min       + (i_T + real_t(.5)) * tab.dT,
+            lnrhod = tab.ln_rhod_min + (i_d + real_t(.5)) * tab.dlnrhod;
+
+          real_t prefactor;
+          const real_t vt = vt_tab_exact<real_t>(vt_eq, exp(lnr), T, exp(lnrhod), prefactor);
+          return abs(prefactor * tab(lnr, T, lnrhod) / vt - 1);
+        }
+      };
+    };
+
+    // tabulates the terminal velocity formula over (ln r, T, ln rhod) and estimates the interpolation error
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::init_vterm_tab()
+    {
+      vt_tab.n_r    = config.vt_tab_n_r;
+      vt_tab.n_T    = config.vt_tab_n_T;
+      vt_tab.n_rhod = config.vt_tab_n_rhod;
+      vt_tab.ln_r_min    = config.vt0_ln_r_min;
+      vt_tab.dlnr        = (config.vt0_ln_r_max - config.vt0_ln_r_min) / (vt_tab.n_r - 1);
+      vt_tab.T_min       = config.vt_tab_T_min;
+      vt_tab.dT          = (config.vt_tab_T_max - config.vt_tab_T_min) / (vt_tab.n_T - 1);
+      vt_tab.ln_rhod_min = log(config.vt_tab_rhod_min);
+      vt_tab.dlnrhod     = (log(config.vt_tab_rhod_max) - log(config.vt_tab_rhod_min)) / (vt_tab.n_rhod - 1);
+
+      vt_tab_data.resize(thrust_size_t(vt_tab.n_r) * vt_tab.n_T * vt_tab.n_rhod);
+      vt_tab.data = vt_tab_data.data();
+
+      thrust::transform(
+        zero, zero + vt_tab_data.size(),
+        vt_tab_data.begin(),
+        detail::vt_tab_fill<real_t>(opts_init.terminal_velocity, vt_tab)
+      );
+      nancheck(vt_tab_data, "vt_tab_data after tabulation");
+
+      vt_tab_info.n_r    = vt_tab.n_r;
+      vt_tab_info.n_T    = vt_tab.n_T;
+      vt_tab_info.n_rhod = vt_tab.n_rhod;
+      vt_tab_info.err_rel = thrust::reduce(
+        thrust::make_transform_iterator(zero, detail::vt_tab_err<real_t>(opts_init.terminal_velocity, vt_tab)),
+        thrust::make_transform_iterator(zero, detail::vt_tab_err<real_t>(opts_init.terminal_velocity, vt_tab)) 
+          + thrust_size_t(vt_tab.n_r - 1) * (vt_tab.n_T - 1) * (vt_tab.n_rhod - 1),
+        real_t(0),
+        thrust::maximum<real_t>()
+      );
+    }
+  };
+};
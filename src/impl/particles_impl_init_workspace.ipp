@@ -0,0 +1,53 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  * @brief registering temporaries with the workspace and reserving them for n_sd_max
+  */
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::init_workspace()
+    {
+      // per-cell temporaries, allocated in the ctor
+      ws.add(tmp_device_real_cell);
+      ws.add(tmp_device_real_cell1);
+      ws.add(tmp_device_acc_cell);
+      ws.add(tmp_device_size_cell);
+
+      // per-particle temporaries, only those used with the given opts_init
+      ws.add_part(tmp_device_real_part);
+      ws.add_part(tmp_device_n_part);
+      ws.add_part(tmp_device_size_part);
+      if(opts_init.sort_engine == sort_t::incremental) ws.add_part(tmp_device_size_part1);
+      if(opts_init.chem_switch || opts_init.sstp_cond > 1 || n_dims >= 2) ws.add_part(tmp_device_real_part1);
+      if((opts_init.sstp_cond>1 && opts_init.exact_sstp_cond) || n_dims==3) ws.add_part(tmp_device_real_part2);
+      if(opts_init.sstp_cond>1 && opts_init.exact_sstp_cond)
+      {
+        ws.add_part(tmp_device_real_part3);
+        ws.add_part(tmp_device_real_part4);
+      }
+      ws.reserve_part(opts_init.n_sd_max);
+
+      // host copies of the multiplicities and cell indices in init_n_sd_conc() (at init() and in src())
+      tmp_host_real_pool.reserve(1, opts_init.n_sd_max);
+      tmp_host_size_pool.reserve(1, opts_init.n_sd_max);
+
+      // sort keys of coal() with per-cell substepping
+      if(opts_init.adaptive_sstp_coal)
+        tmp_size_pool.reserve(2, opts_init.n_sd_max);
+
+      // scoped temporaries of src(): bin numbers of the old and new SDs and
+      // SD counts per bin and cell (with out_of_bins), and the matches of new SDs
+      if(opts_init.src_switch)
+      {
+        tmp_size_pool.reserve(4, opts_init.n_sd_max + n_cell + 1);
+        tmp_bool_pool.reserve(1, opts_init.n_sd_max);
+      }
+    }
+  };
+};
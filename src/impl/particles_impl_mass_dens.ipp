@@ -61,7 +61,7 @@ namespace libcloudphxx
 
       thrust::pair<
         thrust_device::vector<thrust_size_t>::iterator,
-        typename thrust_device::vector<real_t>::iterator
+        typename thrust_device::vector<acc_t>::iterator
       > n = thrust::reduce_by_key(
         // input - keys
         sorted_ijk.begin(), sorted_ijk.end(),
@@ -130,27 +130,28 @@ namespace libcloudphxx
 
     namespace detail
     {
-      template <typename real_t>
-      struct moment_counter : thrust::unary_function<const thrust::tuple<real_t, real_t>&, real_t>
+      // returns acc_t so that the sums in reduce_by_key are done in acc_t
+      template <typename real_t, typename acc_t>
+      struct moment_counter : thrust::unary_function<const thrust::tuple<real_t, real_t>&, acc_t>
       {
         real_t xp;
 
         moment_counter(real_t xp) : xp(xp) {}
 
         BOOST_GPU_ENABLED
-        real_t operator()(const thrust::tuple<real_t, real_t> &tpl)
+        acc_t operator()(const thrust::tuple<real_t, real_t> &tpl)
         {
           const real_t n = thrust::get<0>(tpl);
           const real_t x = thrust::get<1>(tpl);
 #if !defined(NDEBUG)
-          real_t res = n * pow(x, xp); // TODO: check if xp=0 is optimised
+          acc_t res = acc_t(n) * pow(x, xp); // TODO: check if xp=0 is optimised
           if(isnaninf()(res))
           {
             printf("nan/inf res in moment counter, n = %g x = %g res = %g xp = %g\n", n, x, res, xp);
           }
           return res;
 #else
-          return n * pow(x, xp); // TODO: check if xp=0 is optimised
+          return acc_t(n) * pow(x, xp); // TODO: check if xp=0 is optimised
 #endif
         }
       };
@@ -176,7 +177,7 @@ namespace libcloudphxx
 
       thrust::pair<
         thrust_device::vector<thrust_size_t>::iterator,
-        typename thrust_device::vector<real_t>::iterator
+        typename thrust_device::vector<acc_t>::iterator
       > n = thrust::reduce_by_key(
         // input - keys
         sorted_ijk.begin(), sorted_ijk.end(),  
@@ -186,12 +187,16 @@ namespace libcloudphxx
             pi_t(n_filtered.begin(),   sorted_id.begin()),
             pi_t(vec_bgn,              sorted_id.begin())
           )),
-          detail::moment_counter<real_t>(power)
+          detail::moment_counter<real_t, acc_t>(power)
         ),
         // output - keys
         count_ijk.begin(),
         // output - values
-        count_mom.begin()
+        count_mom.begin(),
+        // key comparison
+        thrust::equal_to<thrust_size_t>(),
+        // reduction type
+        thrust::plus<acc_t>()
       );  
 
 
@@ -216,7 +221,7 @@ namespace libcloudphxx
             count_ijk.begin()
           ),
           count_mom.begin(),                                  // output (in place)
-          thrust::divides<real_t>()
+          thrust::divides<acc_t>()
         );
 #if !defined(NDEBUG)
         {
@@ -236,7 +241,7 @@ namespace libcloudphxx
             count_ijk.begin()
           ),
           count_mom.begin(),                                  // output (in place)
-          thrust::divides<real_t>()
+          thrust::divides<acc_t>()
         );
 #if !defined(NDEBUG)
         {
@@ -275,5 +280,173 @@ namespace libcloudphxx
       }
 #endif
     }
+
+    namespace detail
+    {
+      // n times the attribute to the given power if the range attribute is within [min, max), 0 otherwise;
+      // returns acc_t so that the sums in reduce_by_key are done in acc_t
+      template <typename real_t, typename n_t, typename acc_t>
+      struct moms_batch_counter : thrust::unary_function<const thrust::tuple<n_t, real_t, real_t>&, acc_t>
+      {
+        const real_t min, max, xp;
+
+        moms_batch_counter(const real_t &min, const real_t &max, const real_t &xp) : min(min), max(max), xp(xp) {}
+
+        BOOST_GPU_ENABLED
+        acc_t operator()(const thrust::tuple<n_t, real_t, real_t> &tpl) const // n, range attribute, moment attribute
+        {
+#if !defined(__NVCC__)
+          using std::pow;
+#endif
+          const real_t x = thrust::get<1>(tpl);
+          return x >= min && x < max ? acc_t(thrust::get<0>(tpl)) * pow(thrust::get<2>(tpl), xp) : acc_t(0);
+        }
+      };
+
+      // per-cell sum divided by dv and rhod (specific moments, as in moms_calc)
+      template <typename real_t, typename acc_t>
+      struct moms_batch_specific
+      {
+        BOOST_GPU_ENABLED
+        acc_t operator()(const acc_t &sum, const thrust::tuple<real_t, real_t> &dv_rhod) const
+        {
+          return sum / thrust::get<0>(dv_rhod) / thrust::get<1>(dv_rhod);
+        }
+      };
+    };
+
+    // per-moment range limits and power of the requests, the attributes
+    // being stored as rd^3 and rw^2 (rng_attr, rng_min, rng_max, mom_attr, power)
+    template <typename real_t, backend_t device>
+    std::vector<real_t> particles_t<real_t, device>::impl::moms_batch_table(
+      const std::vector<moms_req_t<real_t> > &reqs
+    )
+    {
+      std::vector<real_t> table;
+      for (typename std::vector<moms_req_t<real_t> >::const_iterator it = reqs.begin(); it != reqs.end(); ++it)
+      {
+        const real_t pwr[3] = {3, 2, 1};
+        const real_t rp = pwr[it->rng_attr], mp = pwr[it->mom_attr];
+
+        for (std::vector<int>::const_iterator k = it->moms.begin(); k != it->moms.end(); ++k)
+        {
+          table.push_back(it->rng_attr);
+          table.push_back(pow(it->rng_min, rp));
+          table.push_back(pow(it->rng_max, rp));
+          table.push_back(it->mom_attr);
+          table.push_back(*k / mp);
+        }
+      }
+      return table;
+    }
+
+    // computes all requested moments, each with one reduce_by_key over the particles 
+    // sorted by cell (as in moms_calc), results are stored in tmp_host_real_moms 
+    // (n_cell values per moment)
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::moms_batch(
+      const std::vector<moms_req_t<real_t> > &reqs
+    )
+    {
+      const std::vector<real_t> table = moms_batch_table(reqs);
+      const int n_mom = table.size() / 5;
+
+      tmp_host_real_moms.resize(n_mom * n_cell);
+      if (n_mom == 0) return;
+
+      // leased, the pool grows only for more moments than requested before
+      auto out_lease = tmp_acc_pool.acquire(n_mom * n_cell);
+      thrust_device::vector<acc_t> &out(*out_lease);
+      thrust::fill(out.begin(), out.end(), acc_t(0)); // cells with no particles
+
+      hskpng_sort();
+
+      typedef thrust::permutation_iterator<
+        typename thrust_device::vector<real_t>::const_iterator,
+        typename thrust_device::vector<thrust_size_t>::iterator
+      > pi_t;
+      typedef thrust::permutation_iterator<
+        typename thrust_device::vector<n_t>::const_iterator,
+        typename thrust_device::vector<thrust_size_t>::iterator
+      > pi_n_t;
+      typedef thrust::zip_iterator<thrust::tuple<pi_n_t, pi_t, pi_t> > zip_it_t;
+
+      const thrust_device::vector<real_t> *attr[3];
+      attr[attr_t::rd] = &rd3;
+      attr[attr_t::rw] = &rw2;
+      attr[attr_t::kappa] = &kpa;
+
+      for (int m = 0; m < n_mom; ++m)
+      {
+        const real_t *r = &table[5 * m];
+
+        thrust::pair<
+          thrust_device::vector<thrust_size_t>::iterator,
+          typename thrust_device::vector<acc_t>::iterator
+        > it = thrust::reduce_by_key(
+          // input - keys
+          sorted_ijk.begin(), sorted_ijk.end(),
+          // input - values
+          thrust::make_transform_iterator(
+            zip_it_t(thrust::make_tuple(
+              pi_n_t(n.begin(),                   sorted_id.begin()),
+              pi_t(attr[int(r[0])]->begin(),      sorted_id.begin()),
+              pi_t(attr[int(r[3])]->begin(),      sorted_id.begin())
+            )),
+            detail::moms_batch_counter<real_t, n_t, acc_t>(r[1], r[2], r[4])
+          ),
+          // output - keys
+          count_ijk.begin(),
+          // output - values
+          count_mom.begin()
+        );
+        count_n = it.first - count_ijk.begin();
+
+        // dividing by dv and rhod and storing in the rows of the non-empty cells
+        thrust::transform(
+          count_mom.begin(), count_mom.begin() + count_n,      // input - first arg
+          thrust::make_zip_iterator(thrust::make_tuple(        // input - second arg
+            thrust::make_permutation_iterator(dv.begin(), count_ijk.begin()),
+            thrust::make_permutation_iterator(rhod.begin(), count_ijk.begin())
+          )),
+          thrust::make_permutation_iterator(out.begin() + m * n_cell, count_ijk.begin()), // output
+          detail::moms_batch_specific<real_t, acc_t>()
+        );
+      }
+      nancheck(out, "moms_batch output");
+
+      thrust::copy(out.begin(), out.end(), tmp_host_real_moms.begin());
+    }
+
+    // totals over the domain of the moments requested as in moms_batch(),
+    // i.e. sums over all SDs of n times the attribute to the given power
+    // (summed directly, in double as the totals of many cells)
+    template <typename real_t, backend_t device>
+    std::vector<real_t> particles_t<real_t, device>::impl::moms_tot(
+      const std::vector<moms_req_t<real_t> > &reqs
+    )
+    {
+      const std::vector<real_t> table = moms_batch_table(reqs);
+      const int n_mom = table.size() / 5;
+
+      const thrust_device::vector<real_t> *attr[3];
+      attr[attr_t::rd] = &rd3;
+      attr[attr_t::rw] = &rw2;
+      attr[attr_t::kappa] = &kpa;
+
+      std::vector<real_t> res(n_mom);
+      for (int m = 0; m < n_mom; ++m)
+      {
+        const real_t *r = &table[5 * m];
+        res[m] = thrust::transform_reduce(
+          thrust::make_zip_iterator(thrust::make_tuple(n.begin(), attr[int(r[0])]->begin(), attr[int(r[3])]->begin())),
+          thrust::make_zip_iterator(thrust::make_tuple(n.begin(), attr[int(r[0])]->begin(), attr[int(r[3])]->begin())) + n_part,
+          detail::moms_batch_counter<real_t, n_t, double>(r[1], r[2], r[4]),
+          double(0),
+          thrust::plus<double>()
+        );
+      }
+      return res;
+    }
   };  
 };
@@ -6,6 +6,7 @@
   */
 
 #include <thrust/count.h>
+#include <thrust/iterator/transform_iterator.h>
 
 namespace libcloudphxx
 {
@@ -29,6 +30,26 @@ namespace libcloudphxx
           thrust::make_permutation_iterator(prop_bgn, sorted_id.begin())
 	);
       }
+
+      // for the i-th element of the n_flagged columns of the chem matrix being overwritten, the index
+      // within the species-major chem_all x n_part matrix of either the source or the recycled SD
+      struct chem_rcyc_idx
+      {
+        const thrust_size_t *sorted_id;
+        const thrust_size_t n_part, n_flagged;
+        const bool src;
+
+        chem_rcyc_idx(const thrust_size_t *sorted_id, const thrust_size_t &n_part, const thrust_size_t &n_flagged, const bool &src) :
+          sorted_id(sorted_id), n_part(n_part), n_flagged(n_flagged), src(src)
+        {}
+
+        BOOST_GPU_ENABLED
+        thrust_size_t operator()(const thrust_size_t &i) const
+        {
+          const thrust_size_t row = i / n_flagged, col = i % n_flagged;
+          return row * n_part + sorted_id[src ? n_part - 1 - col : col];
+        }
+      };
     };
 
     template <typename real_t, backend_t device>
@@ -57,13 +78,10 @@ namespace libcloudphxx
 
       // using sorted_id and sorted_ijk as temporary space - anyhow, after recycling these are not valid anymore!
       sorted = false;
+      presorted = false;
       thrust::sequence(sorted_id.begin(), sorted_id.end()); 
       {
-#if defined(__NVCC__) 
-        assert(sizeof(thrust_size_t) == sizeof(n_t));
-#else
-        static_assert(sizeof(thrust_size_t) == sizeof(n_t), "");
-#endif
+        // multiplicities copied to thrust_size_t (at least as wide as n_t)
 	thrust_device::vector<thrust_size_t> &tmp(sorted_ijk);
 	thrust::copy(n.begin(), n.end(), tmp.begin());
 
@@ -98,6 +116,7 @@ namespace libcloudphxx
       detail::copy_prop<real_t>(rd3.begin(), sorted_id, n_flagged);
       detail::copy_prop<real_t>(rw2.begin(), sorted_id, n_flagged);
       detail::copy_prop<real_t>(kpa.begin(), sorted_id, n_flagged);
+      if(opts_init.cond_solver == cond_solver_t::newton) detail::copy_prop<real_t>(cond_drw2_dt.begin(), sorted_id, n_flagged);
       if(opts_init.sstp_cond > 1 && opts_init.exact_sstp_cond)
       {
         detail::copy_prop<real_t>(sstp_tmp_rv.begin(), sorted_id, n_flagged);
@@ -105,12 +124,21 @@ namespace libcloudphxx
         detail::copy_prop<real_t>(sstp_tmp_rh.begin(), sorted_id, n_flagged);
       }
 
-      // ... chemical properties only if chem enabled
-      if (opts_init.chem_switch){
-        for (int i = 0; i < chem_all; ++i)
-          detail::copy_prop<real_t>(chem_bgn[i], sorted_id, n_flagged);
+      // ... chemical properties only if chem enabled, all species in one pass
+      if (opts_init.chem_switch)
+      {
+        const thrust_size_t *sorted_id_ptr = thrust::raw_pointer_cast(sorted_id.data());
+        thrust::counting_iterator<thrust_size_t> zero(0);
+        thrust::copy_n(
+          thrust::make_permutation_iterator(chem_mtx.begin(), thrust::make_transform_iterator(zero, detail::chem_rcyc_idx(sorted_id_ptr, n_part, n_flagged, true))),
+          chem_all * n_flagged,
+          thrust::make_permutation_iterator(chem_mtx.begin(), thrust::make_transform_iterator(zero, detail::chem_rcyc_idx(sorted_id_ptr, n_part, n_flagged, false)))
+        );
       }
 
+      // the recycled particles are new SDs
+      sd_id_new(thrust::make_permutation_iterator(sd_id.begin(), sorted_id.begin()), n_flagged);
+
       {
         namespace arg = thrust::placeholders;
 
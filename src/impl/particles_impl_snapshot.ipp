@@ -0,0 +1,194 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  * @brief streaming output of super-droplet attributes (see detail/snapshot.hpp for the file layout)
+  */
+
+#include <thrust/iterator/transform_iterator.h>
+#include <thrust/iterator/permutation_iterator.h>
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      struct snap_stride
+      {
+        const thrust_size_t stride;
+
+        snap_stride(const thrust_size_t &stride) : stride(stride) {}
+
+        BOOST_GPU_ENABLED
+        thrust_size_t operator()(const thrust_size_t &i) const
+        {
+          return i * stride;
+        }
+      };
+
+      // copies every stride-th element of the n * stride elements starting at bgn to host memory at out
+      template <typename T, class it_t>
+      void snap_gather(const it_t &bgn, const thrust_size_t &n, const thrust_size_t &stride, char *out, tmp_pool<T> &pool)
+      {
+        T *out_t = reinterpret_cast<T*>(out);
+        auto src = thrust::make_permutation_iterator(
+          bgn,
+          thrust::make_transform_iterator(thrust::make_counting_iterator<thrust_size_t>(0), snap_stride(stride))
+        );
+#if defined(__NVCC__)
+        // gathered on the device first (in a buffer reserved in snapshot_open()),
+        // so that only n elements cross the bus in one contiguous copy
+        if (stride == 1)
+          thrust::copy(bgn, bgn + n, out_t);
+        else
+        {
+          auto tmp = pool.acquire(n);
+          thrust::copy(src, src + n, (*tmp).begin());
+          thrust::copy((*tmp).begin(), (*tmp).end(), out_t);
+        }
+#else
+        thrust::copy(src, src + n, out_t);
+#endif
+      }
+    };
+
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::snapshot_open(const std::string &path, const snapshot_opts_t &opts)
+    {
+      if (opts.sd_stride < 1) throw std::runtime_error("snapshot_opts_t::sd_stride < 1");
+      if (opts.stp_stride < 1) throw std::runtime_error("snapshot_opts_t::stp_stride < 1");
+      if (opts.attrs.size() == 0) throw std::runtime_error("no attributes selected in snapshot_opts_t::attrs");
+      if (opts.attrs.size() > detail::snap_attrs_max) throw std::runtime_error(detail::formatter() << "at most " << detail::snap_attrs_max << " attributes can be written to a snapshot file");
+
+      detail::snap_header_t hdr = detail::snap_header_t();
+      hdr.real_size = sizeof(real_t);
+      hdr.n_t_size = sizeof(n_t);
+      hdr.n_chem = 0;
+      hdr.sd_stride = opts.sd_stride;
+      hdr.n_attrs = opts.attrs.size();
+
+      for (int a = 0; a < opts.attrs.size(); ++a)
+      {
+        switch (opts.attrs[a])
+        {
+          case snap_attr_t::x: if (opts_init.nx == 0) throw std::runtime_error("snapshot of x requested, but nx == 0"); break;
+          case snap_attr_t::y: if (opts_init.ny == 0) throw std::runtime_error("snapshot of y requested, but ny == 0"); break;
+          case snap_attr_t::z: if (opts_init.nz == 0) throw std::runtime_error("snapshot of z requested, but nz == 0"); break;
+          case snap_attr_t::chem:
+            if (!opts_init.chem_switch) throw std::runtime_error("snapshot of chem requested, but all chemistry was switched off in opts_init");
+            hdr.n_chem = chem_all;
+            break;
+          default: break;
+        }
+        hdr.attrs[a] = opts.attrs[a];
+      }
+
+      // buffers for the largest records: host staging and device gathering
+      const thrust_size_t n_sd = (opts_init.n_sd_max + opts.sd_stride - 1) / opts.sd_stride;
+#if defined(__NVCC__)
+      if (opts.sd_stride > 1)
+      {
+        const int n_attrs_n = std::count(opts.attrs.begin(), opts.attrs.end(), snap_attr_t::n);
+        if (n_attrs_n > 0) tmp_n_pool.reserve(1, n_sd);
+        if (n_attrs_n < opts.attrs.size()) tmp_real_pool.reserve(1, n_sd);
+        tmp_id_pool.reserve(1, n_sd);
+      }
+#endif
+
+      snap.open(path, hdr);
+      snap.reserve(snap_bytes(opts, n_sd));
+      snap_opts = opts;
+      snap_ctr = 0;
+    }
+
+    // size of the block of an attribute with n_sd SDs, without the alignment padding
+    template <typename real_t, backend_t device>
+    std::uint64_t particles_t<real_t, device>::impl::snap_attr_bytes(const snap_attr_t::snap_attr_t &attr, const thrust_size_t &n_sd)
+    {
+      switch (attr)
+      {
+        case snap_attr_t::n:    return n_sd * sizeof(n_t);
+        case snap_attr_t::chem: return n_sd * chem_all * sizeof(real_t);
+        default:                return n_sd * sizeof(real_t);
+      }
+    }
+
+    // size of a record with n_sd SDs
+    template <typename real_t, backend_t device>
+    std::uint64_t particles_t<real_t, device>::impl::snap_bytes(const snapshot_opts_t &opts, const thrust_size_t &n_sd)
+    {
+      std::uint64_t bytes = detail::snap_aligned(sizeof(detail::snap_record_t)) + detail::snap_aligned(n_sd * sizeof(sd_id_t));
+      for (int a = 0; a < opts.attrs.size(); ++a)
+        bytes += detail::snap_aligned(snap_attr_bytes(opts.attrs[a], n_sd));
+      return bytes;
+    }
+
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::snapshot()
+    {
+      if (!snap.is_open()) throw std::runtime_error("please call snapshot_open() before snapshot()");
+      if (snap_ctr++ % snap_opts.stp_stride != 0) return;
+
+      const thrust_size_t stride = snap_opts.sd_stride,
+                          n_sd = (n_part + stride - 1) / stride;
+      const std::uint64_t bytes = snap_bytes(snap_opts, n_sd);
+
+      // assembling the record in the buffer not being written to disk; allocated in snapshot_open()
+      // for the largest record, every byte of this one (alignment padding included) is written below
+      char *bfr = snap.staging(bytes);
+
+      detail::snap_record_t rec;
+      rec.record = snap_ctr - 1;
+      rec.n_part = n_part;
+      rec.n_sd = n_sd;
+      rec.bytes = bytes;
+      std::memcpy(bfr, &rec, sizeof(rec));
+      std::uint64_t offset = detail::snap_aligned(sizeof(rec));
+      std::memset(bfr + sizeof(rec), 0, offset - sizeof(rec));
+
+      // SD ids
+      {
+        char *out = bfr + offset;
+        detail::snap_gather(sd_id.begin(), n_sd, stride, out, tmp_id_pool);
+        const std::uint64_t used = n_sd * sizeof(sd_id_t);
+        offset += detail::snap_aligned(used);
+        std::memset(out + used, 0, bfr + offset - out - used);
+      }
+
+      for (int a = 0; a < snap_opts.attrs.size(); ++a)
+      {
+        char *out = bfr + offset;
+        switch (snap_opts.attrs[a])
+        {
+          case snap_attr_t::x:    detail::snap_gather(x.begin(),   n_sd, stride, out, tmp_real_pool); break;
+          case snap_attr_t::y:    detail::snap_gather(y.begin(),   n_sd, stride, out, tmp_real_pool); break;
+          case snap_attr_t::z:    detail::snap_gather(z.begin(),   n_sd, stride, out, tmp_real_pool); break;
+          case snap_attr_t::rd3:  detail::snap_gather(rd3.begin(), n_sd, stride, out, tmp_real_pool); break;
+          case snap_attr_t::rw2:  detail::snap_gather(rw2.begin(), n_sd, stride, out, tmp_real_pool); break;
+          case snap_attr_t::kpa:  detail::snap_gather(kpa.begin(), n_sd, stride, out, tmp_real_pool); break;
+          case snap_attr_t::n:    detail::snap_gather(n.begin(),   n_sd, stride, out, tmp_n_pool); break;
+          case snap_attr_t::chem:
+            for (int i = 0; i < chem_all; ++i)
+              detail::snap_gather(chem_bgn[i], n_sd, stride, out + i * n_sd * sizeof(real_t), tmp_real_pool);
+            break;
+          default: assert(false);
+        }
+        const std::uint64_t used = snap_attr_bytes(snap_opts.attrs[a], n_sd);
+        offset += detail::snap_aligned(used);
+        std::memset(out + used, 0, bfr + offset - out - used);
+      }
+      assert(offset == bytes);
+
+      // written to disk by the worker thread while the simulation continues
+      snap.commit(bytes);
+    }
+
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::snapshot_close()
+    {
+      snap.close();
+    }
+  };
+};
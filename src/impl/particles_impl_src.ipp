@@ -7,6 +7,7 @@
 #include <limits>
 #include <thrust/unique.h>
 #include <thrust/binary_search.h>
+#include <thrust/inner_product.h>
 
 namespace libcloudphxx
 {
@@ -55,8 +56,8 @@ namespace libcloudphxx
 
       // --- calc liquid water content before src ---
       hskpng_sort(); 
-      thrust_device::vector<real_t> &drv(tmp_device_real_cell);
-      thrust::fill(drv.begin(), drv.end(), real_t(0.));
+      thrust_device::vector<acc_t> &drv(tmp_device_acc_cell);
+      thrust::fill(drv.begin(), drv.end(), acc_t(0.));
 
       moms_all();
       moms_calc(rw2.begin(), real_t(3./2.));
@@ -65,7 +66,7 @@ namespace libcloudphxx
       thrust::transform(
         count_mom.begin(), count_mom.begin() + count_n,                    // input - 1st arg
         thrust::make_permutation_iterator(drv.begin(), count_ijk.begin()), // output
-        thrust::negate<real_t>()
+        thrust::negate<acc_t>()
       );
 
       // drv = -tot_vol_bfr + dry_vol_bfr
@@ -156,7 +157,8 @@ namespace libcloudphxx
                       n_part_tot_in_src = n_part_to_init;
 
         // tmp vector with bin number of existing SDs
-        thrust_device::vector<thrust_size_t> bin_no(n_part);
+        auto bin_no_tmp = tmp_size_pool.acquire(n_part);
+        thrust_device::vector<thrust_size_t> &bin_no(*bin_no_tmp);
 
         const thrust_size_t out_of_bins = 4444444444; // would cause an error for src_sd_conc > out_of_bins
         // calc bin no
@@ -183,7 +185,8 @@ namespace libcloudphxx
 
         // -- init new SDs that didnt have a match -- 
         {
-          thrust_device::vector<thrust_size_t> tmp_bin_no(n_part_old);
+          auto tmp_bin_no_tmp = tmp_size_pool.acquire(n_part_old);
+          thrust_device::vector<thrust_size_t> &tmp_bin_no(*tmp_bin_no_tmp);
           thrust::copy(bin_no.begin(), bin_no.begin() + n_part_old, tmp_bin_no.begin());
 
           thrust_size_t n_out_of_bins = thrust::count(tmp_bin_no.begin(), tmp_bin_no.end(), out_of_bins);
@@ -213,7 +216,8 @@ namespace libcloudphxx
           }
 
           // --- remove rd3 and ijk of newly added SDs that have counterparts ---
-          thrust_device::vector<bool> have_match(n_part_to_init);
+          auto have_match_tmp = tmp_bool_pool.acquire(n_part_to_init);
+          thrust_device::vector<bool> &have_match(*have_match_tmp);
           // find those with a match
           thrust::binary_search(
             thrust::make_zip_iterator(thrust::make_tuple(
@@ -297,9 +301,11 @@ namespace libcloudphxx
         }
 
         // tmp vector to hold number of particles in a given size bin in a given cell
-        thrust_device::vector<thrust_size_t> bin_cell_count(n_part_tot_in_src +  n_cell + 1); // needs space for out_of_bins
+        auto bin_cell_count_tmp = tmp_size_pool.acquire(n_part_tot_in_src +  n_cell + 1); // needs space for out_of_bins
+        thrust_device::vector<thrust_size_t> &bin_cell_count(*bin_cell_count_tmp);
         // tmp vector for number of particles in bins up to this one
-        thrust_device::vector<thrust_size_t> bin_cell_count_ptr(n_part_tot_in_src +  n_cell + 1);
+        auto bin_cell_count_ptr_tmp = tmp_size_pool.acquire(n_part_tot_in_src +  n_cell + 1);
+        thrust_device::vector<thrust_size_t> &bin_cell_count_ptr(*bin_cell_count_ptr_tmp);
 
         thrust_size_t count_bins;
         {
@@ -411,6 +417,20 @@ namespace libcloudphxx
           *(opts_init.src_dry_distros.begin()->second)
         ); // TODO: document that n_of_lnrd_stp is expected!
 
+        // detecting overflows of n_t in the addition below
+        if (thrust::inner_product(
+          n.begin() + n_part_old,
+          n.end(),
+          thrust::make_permutation_iterator(
+            n.begin(), thrust::make_permutation_iterator(
+              sorted_id.begin(), bin_cell_count.begin()
+            )
+          ),
+          false,
+          thrust::logical_or<bool>(),
+          detail::n_sum_overflows<n_t>()
+        )) throw std::runtime_error(detail::formatter() << "multiplicity overflow in the aerosol source (n_t is " << 8 * sizeof(n_t) << "-bit)");
+
         // add the just-initialized multiplicities to the old ones
         thrust::transform(
           n.begin() + n_part_old,
@@ -427,7 +447,6 @@ namespace libcloudphxx
           ), //in-place
           thrust::plus<n_t>()
         );
-        // TODO: check for overflows of na after addition
 
         // --- properly reduce size of the vectors back to no before src + no w/o match ---
         n_part = n_part_old;
@@ -436,6 +455,7 @@ namespace libcloudphxx
  
       // --- after source particles are no longer sorted ---
       sorted = false;
+      presorted = false;
 
       // --- calc liquid water content after src ---
       hskpng_sort(); 
@@ -447,7 +467,7 @@ namespace libcloudphxx
         count_mom.begin(), count_mom.begin() + count_n,                    // input - 1st arg
         thrust::make_permutation_iterator(drv.begin(), count_ijk.begin()), // 2nd arg
         thrust::make_permutation_iterator(drv.begin(), count_ijk.begin()), // output
-        thrust::plus<real_t>()
+        thrust::plus<acc_t>()
       );
 
       // drv = tot_vol_after - dry_vol_after - tot_vol_bfr + dry_vol_bfr
@@ -90,6 +90,7 @@ namespace libcloudphxx
           );
         }
       }
+      tpr_dirty = true;
     }
 
     template <typename real_t, backend_t device>
@@ -19,16 +19,34 @@ namespace libcloudphxx
     {
       // recycling out-of-domain/invalidated particles 
       if(opts.rcyc)
+      {
+        detail::ws_stage stg(ws, "rcyc");
         rcyc();
+      }
       // if we do not recycle, we should remove them
       else
+      {
+        detail::ws_stage stg(ws, "remove");
         hskpng_remove_n0();  
+      }
+
+      // SDs from the neighbouring ranks, received while the local ones were removed
+      if(distmem_mpi())
+      {
+        detail::ws_stage stg(ws, "xchng");
+        xchng_sds_mpi_wait();
+      }
+
+      detail::ws_stage stg(ws, "hskpng");
 
       // updating particle->cell look-up table
       hskpng_ijk();
 
       // updating count_ijk and count_num
       hskpng_count();
+
+      // placing particle attributes in cell order (if requested)
+      hskpng_reorder();
     }
   };
 };
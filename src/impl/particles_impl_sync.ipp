@@ -11,53 +11,181 @@ namespace libcloudphxx
 {
   namespace lgrngn
   {
+    template <typename real_t, backend_t device>
+    typename particles_t<real_t, device>::impl::l2e_t &particles_t<real_t, device>::impl::l2e(
+      const thrust_device::vector<real_t> *key
+    )
+    {
+      if (key == &th)        return l2e_th;
+      if (key == &rv)        return l2e_rv;
+      if (key == &rhod)      return l2e_rhod;
+      if (key == &courant_x) return l2e_courant_x;
+      if (key == &courant_y) return l2e_courant_y;
+      if (key == &courant_z) return l2e_courant_z;
+      for (int i = 0; i < chem_gas_n; ++i)
+      {
+        typename std::map<enum chem_species_t, thrust_device::vector<real_t> >::const_iterator 
+          it = ambient_chem.find((chem_species_t)i);
+        if (it != ambient_chem.end() && key == &it->second) return l2e_chem[i];
+      }
+      throw std::runtime_error("l2e(): not a synced field");
+    }
+
     template <typename real_t, backend_t device>
     void particles_t<real_t, device>::impl::sync(
       const arrinfo_t<real_t> &from,
       thrust_device::vector<real_t> &to
     )
-    {   
+    {
       if (from.is_null()) return;
 
-      thrust::transform(
-        l2e[&to].begin(), l2e[&to].end(),
+      const l2e_t &map = l2e(&to);
+
+      if (map.contiguous)
+      {
+        // bulk copy (a single host-to-device transfer with CUDA)
+        thrust::copy(from.dataZero + map.idx[0], from.dataZero + map.idx[0] + map.idx.size(), to.begin());
+      }
+      else
+      {
+        thrust::transform(
+          map.idx.begin(), map.idx.end(),
 #if defined(__NVCC__) // TODO: better condition (same addressing space)
-        tmp_host_real_grid.begin(), 
+          tmp_host_real_grid.begin(),
 #else
-        to.begin(),
+          to.begin(),
 #endif
-        detail::c_arr_get<real_t>(from.dataZero)
-      );
+          detail::c_arr_get<real_t>(from.dataZero)
+        );
 
 #if defined(__NVCC__)
-      assert(to.size() >= l2e[&to].size());
-      thrust::copy(tmp_host_real_grid.begin(), tmp_host_real_grid.begin() + l2e[&to].size(), to.begin());
+        assert(to.size() >= map.idx.size());
+        thrust::copy(tmp_host_real_grid.begin(), tmp_host_real_grid.begin() + map.idx.size(), to.begin());
 #endif
-    }   
+      }
+
+      if (&to == &th || &to == &rv || &to == &rhod) tpr_dirty = true;
+    }
 
     template <typename real_t, backend_t device>
     void particles_t<real_t, device>::impl::sync(
       const thrust_device::vector<real_t> &from,
       arrinfo_t<real_t> &to
     )
-    {   
+    {
       if (to.is_null()) return;
 
+      const l2e_t &map = l2e(&from);
+
+      if (map.contiguous)
+      {
+        // bulk copy (a single device-to-host transfer with CUDA)
+        thrust::copy(from.begin(), from.begin() + map.idx.size(), to.dataZero + map.idx[0]);
+        return;
+      }
+
 #if defined(__NVCC__)
       assert(from.size() <= tmp_host_real_grid.size());
       thrust::copy(from.begin(), from.end(), tmp_host_real_grid.begin());
 #endif
 
       thrust::transform(
-        l2e[&from].begin(), l2e[&from].end(), 
+        map.idx.begin(), map.idx.end(),
 #if defined(__NVCC__) // TODO: better condition (same addressing space)
-        tmp_host_real_grid.begin(), 
+        tmp_host_real_grid.begin(),
 #else
         from.begin(),
 #endif
         thrust::make_discard_iterator(),
         detail::c_arr_set<real_t>(to.dataZero)
       );
-    }   
-  };  
+    }
+
+    // syncing in th, rv and rhod in one pass over the index mapping
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::sync(
+      const arrinfo_t<real_t> &from_th,
+      const arrinfo_t<real_t> &from_rv,
+      const arrinfo_t<real_t> &from_rhod
+    )
+    {
+      // bulk copies are already as good as it gets, different layouts cannot be fused
+      if (from_th.is_null() || from_rv.is_null() || from_rhod.is_null() || !l2e_scalars_shared || l2e_th.contiguous)
+      {
+        sync(from_th,   th);
+        sync(from_rv,   rv);
+        sync(from_rhod, rhod);
+        return;
+      }
+
+      const thrust_size_t n = l2e_th.idx.size();
+
+      thrust::transform(
+        l2e_th.idx.begin(), l2e_th.idx.end(),
+#if defined(__NVCC__) // TODO: better condition (same addressing space)
+        thrust::make_zip_iterator(thrust::make_tuple(
+          tmp_host_real_grid.begin(),
+          tmp_host_real_grid.begin() + n,
+          tmp_host_real_grid.begin() + 2 * n
+        )),
+#else
+        thrust::make_zip_iterator(thrust::make_tuple(
+          th.begin(),
+          rv.begin(),
+          rhod.begin()
+        )),
+#endif
+        detail::c_arr_get3<real_t>(from_th.dataZero, from_rv.dataZero, from_rhod.dataZero)
+      );
+
+#if defined(__NVCC__)
+      assert(tmp_host_real_grid.size() >= 3 * n);
+      thrust::copy(tmp_host_real_grid.begin(),         tmp_host_real_grid.begin() + n,     th.begin());
+      thrust::copy(tmp_host_real_grid.begin() + n,     tmp_host_real_grid.begin() + 2 * n, rv.begin());
+      thrust::copy(tmp_host_real_grid.begin() + 2 * n, tmp_host_real_grid.begin() + 3 * n, rhod.begin());
+#endif
+
+      tpr_dirty = true;
+    }
+
+    // syncing out th and rv in one pass over the index mapping
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::sync(
+      arrinfo_t<real_t> &to_th,
+      arrinfo_t<real_t> &to_rv
+    )
+    {
+      if (to_th.is_null() || to_rv.is_null() || !l2e_scalars_shared || l2e_th.contiguous)
+      {
+        sync(th, to_th);
+        sync(rv, to_rv);
+        return;
+      }
+
+      const thrust_size_t n = l2e_th.idx.size();
+
+#if defined(__NVCC__)
+      assert(tmp_host_real_grid.size() >= 2 * n);
+      thrust::copy(th.begin(), th.begin() + n, tmp_host_real_grid.begin());
+      thrust::copy(rv.begin(), rv.begin() + n, tmp_host_real_grid.begin() + n);
+#endif
+
+      thrust::transform(
+        l2e_th.idx.begin(), l2e_th.idx.end(),
+#if defined(__NVCC__) // TODO: better condition (same addressing space)
+        thrust::make_zip_iterator(thrust::make_tuple(
+          tmp_host_real_grid.begin(),
+          tmp_host_real_grid.begin() + n
+        )),
+#else
+        thrust::make_zip_iterator(thrust::make_tuple(
+          th.begin(),
+          rv.begin()
+        )),
+#endif
+        thrust::make_discard_iterator(),
+        detail::c_arr_set2<real_t>(to_th.dataZero, to_rv.dataZero)
+      );
+    }
+  };
 };
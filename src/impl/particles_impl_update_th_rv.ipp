@@ -13,29 +13,39 @@ namespace libcloudphxx
   {
     namespace detail
     {
-      template <typename real_t>
-      struct dth : thrust::unary_function<const thrust::tuple<real_t, real_t, real_t>&, real_t>
+      // drv and the result in acc_t, d_th_d_rv in real_t
+      template <typename real_t, typename acc_t>
+      struct dth : thrust::unary_function<const thrust::tuple<acc_t, real_t, real_t>&, acc_t>
       {
         BOOST_GPU_ENABLED
-        real_t operator()(const thrust::tuple<real_t, real_t, real_t> &tpl) const
+        acc_t operator()(const thrust::tuple<acc_t, real_t, real_t> &tpl) const
         {
-          const quantity<si::dimensionless, real_t> 
+          const acc_t 
             drv      = thrust::get<0>(tpl);
           const quantity<si::temperature, real_t> 
             T        = thrust::get<1>(tpl) * si::kelvins;
           const quantity<si::temperature, real_t> 
             th       = thrust::get<2>(tpl) * si::kelvins;
 
-          return drv * common::theta_dry::d_th_d_rv(T, th) / si::kelvins;
+          return drv * acc_t(common::theta_dry::d_th_d_rv(T, th) / si::kelvins);
         }
       };
+
+      // real_t -> acc_t, so that reduce_by_key sums in acc_t
+      template <typename real_t, typename acc_t>
+      struct to_acc : thrust::unary_function<const real_t&, acc_t>
+      {
+        BOOST_GPU_ENABLED
+        acc_t operator()(const real_t &x) const { return x; }
+      };
     };
 
     // update th and rv according to change in 3rd specific wet moments
+    // (computed in acc_t, rounded to real_t once when stored in th and rv)
     // particles have to be sorted
     template <typename real_t, backend_t device>
     void particles_t<real_t, device>::impl::update_th_rv(
-      thrust_device::vector<real_t> &drv // change in water vapor mixing ratio
+      thrust_device::vector<acc_t> &drv // change in water vapor mixing ratio
     ) 
     {   
       if(!sorted) throw std::runtime_error("update_th_rv called on an unsorted set");
@@ -44,12 +54,12 @@ namespace libcloudphxx
       // multiplying specific 3rd moms diff  by -rho_w*4/3*pi
       thrust::transform(
         drv.begin(), drv.end(),                  // input - 1st arg
-        thrust::make_constant_iterator<real_t>(  // input - 2nd arg
-          - common::moist_air::rho_w<real_t>() / si::kilograms * si::cubic_metres
-          * real_t(4./3) * pi<real_t>()
+        thrust::make_constant_iterator<acc_t>(   // input - 2nd arg
+          - common::moist_air::rho_w<acc_t>() / si::kilograms * si::cubic_metres
+          * acc_t(4./3) * pi<acc_t>()
         ),
         drv.begin(),                             // output
-        thrust::multiplies<real_t>()
+        thrust::multiplies<acc_t>()
       );  
 
       // updating rv 
@@ -58,7 +68,7 @@ namespace libcloudphxx
         rv.begin(), rv.end(),  // input - 1st arg
         drv.begin(),           // input - 2nd arg
         rv.begin(),            // output
-        thrust::plus<real_t>() 
+        thrust::plus<acc_t>() 
       );
       assert(*thrust::min_element(rv.begin(), rv.end()) >= 0);
       nancheck(rv, "update_th_rv: rv after update");
@@ -66,7 +76,7 @@ namespace libcloudphxx
       // updating th
       {
         typedef thrust::zip_iterator<thrust::tuple<
-          typename thrust_device::vector<real_t>::iterator,
+          typename thrust_device::vector<acc_t>::iterator,
           typename thrust_device::vector<real_t>::iterator,
           typename thrust_device::vector<real_t>::iterator
         > > zip_it_t;
@@ -80,13 +90,15 @@ namespace libcloudphxx
               T.begin(),        // dth = drv * d_th_d_rv(T, th)
               th.begin()        //
             )),
-            detail::dth<real_t>()
+            detail::dth<real_t, acc_t>()
           ),
           th.begin(),                 // output
-          thrust::plus<real_t>()
+          thrust::plus<acc_t>()
         );
       }
       nancheck(th, "update_th_rv: th after update");
+
+      tpr_dirty = true;
     }
 
     // update particle-specific cell state
@@ -100,35 +112,64 @@ namespace libcloudphxx
       if(!sorted) throw std::runtime_error("update_uh_rv called on an unsorted set");
 
       // cell-wise change in state
-      thrust_device::vector<real_t> &dstate(tmp_device_real_cell);
+      thrust_device::vector<acc_t> &dstate(tmp_device_acc_cell);
       // init dstate with 0s
-      thrust::fill(dstate.begin(), dstate.end(), real_t(0));
+      thrust::fill(dstate.begin(), dstate.end(), acc_t(0));
       // calc sum of pdstate in each cell
+      update_pstate_sum(dstate, pdstate, sorted_id.begin(), n_part);
+      // add dstate to pstate
+      update_pstate_apply(pstate, dstate);
+    }
+
+    // adds the sums over cells of pdstate of the n SDs with indices given by id 
+    // (grouped by cell, e.g. a range of sorted_id) to dstate
+    template <typename real_t, backend_t device>
+    template <class ix_it_t>
+    void particles_t<real_t, device>::impl::update_pstate_sum(
+      thrust_device::vector<acc_t> &dstate,
+      thrust_device::vector<real_t> &pdstate,
+      const ix_it_t &id,
+      const thrust_size_t &n
+    ) 
+    {   
       thrust::pair<
         thrust_device::vector<thrust_size_t>::iterator,
-        typename thrust_device::vector<real_t>::iterator
-      > n = thrust::reduce_by_key(
-        sorted_ijk.begin(), sorted_ijk.end(),
-        thrust::make_permutation_iterator(pdstate.begin(), sorted_id.begin()),
+        typename thrust_device::vector<acc_t>::iterator
+      > it = thrust::reduce_by_key(
+        thrust::make_permutation_iterator(ijk.begin(), id), 
+        thrust::make_permutation_iterator(ijk.begin(), id) + n,
+        thrust::make_transform_iterator(
+          thrust::make_permutation_iterator(pdstate.begin(), id),
+          detail::to_acc<real_t, acc_t>()
+        ),
         count_ijk.begin(),
-        count_mom.begin()
+        count_mom.begin(),
+        thrust::equal_to<thrust_size_t>(),
+        thrust::plus<acc_t>()
       );
-      count_n = n.first - count_ijk.begin();
+      count_n = it.first - count_ijk.begin();
 
       // add this sum to dstate
       thrust::transform(
         count_mom.begin(), count_mom.begin() + count_n,                    // input - 1st arg
         thrust::make_permutation_iterator(dstate.begin(), count_ijk.begin()), // 2nd arg
         thrust::make_permutation_iterator(dstate.begin(), count_ijk.begin()), // output
-        thrust::plus<real_t>()
+        thrust::plus<acc_t>()
       );
+    }
 
-      // add dstate to pstate
+    // adds the per-cell change dstate to the particle-specific cell state pstate of all SDs
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::update_pstate_apply(
+      thrust_device::vector<real_t> &pstate,
+      const thrust_device::vector<acc_t> &dstate
+    ) 
+    {   
       thrust::transform(
         pstate.begin(), pstate.end(),
         thrust::make_permutation_iterator(dstate.begin(), ijk.begin()),
         pstate.begin(),
-        thrust::plus<real_t>()
+        thrust::plus<acc_t>()
       );
     }
 
@@ -144,6 +185,7 @@ namespace libcloudphxx
        pstate.begin(), pstate.end(),
        thrust::make_permutation_iterator(state.begin(), ijk.begin())
      );   
+     tpr_dirty = true;
     }
   };  
 };
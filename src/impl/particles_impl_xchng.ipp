@@ -0,0 +1,105 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  * @brief packing and unpacking of the SDs moved between slabs (multi_CUDA, multi_OpenMP and MPI);
+  * n is handled by each of them, as it is copied separately by multi_CUDA
+  */
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    // per-SD real_t attributes moved with the SDs, in the order in which they are packed
+    template <typename real_t, backend_t device>
+    std::vector<thrust_device::vector<real_t>*> particles_t<real_t, device>::impl::xchng_real_vctrs()
+    {
+      std::vector<thrust_device::vector<real_t>*> res = {&rd3, &rw2, &kpa, &vt, &x, &z};
+      if(n_dims == 3) res.push_back(&y);
+      if(opts_init.cond_solver == cond_solver_t::newton) res.push_back(&cond_drw2_dt);
+      if(opts_init.sstp_cond > 1 && opts_init.exact_sstp_cond)
+      {
+        res.push_back(&sstp_tmp_rv);
+        res.push_back(&sstp_tmp_th);
+        res.push_back(&sstp_tmp_rh);
+      }
+      return res;
+    }
+
+    // real_t attributes of count SDs with given ids copied to bfr starting at off,
+    // one attribute after another
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::xchng_pack_real(
+      const thrust_device::vector<thrust_size_t> &ids,
+      const thrust_size_t &count,
+      thrust_device::vector<real_t> &bfr,
+      const thrust_size_t &off
+    )
+    {
+      const std::vector<thrust_device::vector<real_t>*> vctrs = xchng_real_vctrs();
+      assert(bfr.size() >= off + count * vctrs.size());
+
+      for(int v = 0; v < vctrs.size(); ++v)
+        thrust::copy(
+          thrust::make_permutation_iterator(vctrs[v]->begin(), ids.begin()),
+          thrust::make_permutation_iterator(vctrs[v]->begin(), ids.begin()) + count,
+          bfr.begin() + off + v * count
+        );
+    }
+
+    // real_t attributes of the n_copied SDs packed in bfr starting at off stored
+    // from n_part_old on (n_part has to be increased by the caller)
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::xchng_unpack_real(
+      const thrust_device::vector<real_t> &bfr,
+      const thrust_size_t &off,
+      const thrust_size_t &n_copied
+    )
+    {
+      const std::vector<thrust_device::vector<real_t>*> vctrs = xchng_real_vctrs();
+      assert(n_part == n_part_old + n_copied);
+
+      for(int v = 0; v < vctrs.size(); ++v)
+      {
+        vctrs[v]->resize(n_part);
+        thrust::copy(
+          bfr.begin() + off + v * n_copied,
+          bfr.begin() + off + (v+1) * n_copied,
+          vctrs[v]->begin() + n_part_old
+        );
+      }
+    }
+
+    // ids of count SDs with given ids (indices) copied to bfr starting at off
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::xchng_pack_id(
+      const thrust_device::vector<thrust_size_t> &ids,
+      const thrust_size_t &count,
+      thrust_device::vector<sd_id_t> &bfr,
+      const thrust_size_t &off
+    )
+    {
+      assert(bfr.size() >= off + count);
+      thrust::copy(
+        thrust::make_permutation_iterator(sd_id.begin(), ids.begin()),
+        thrust::make_permutation_iterator(sd_id.begin(), ids.begin()) + count,
+        bfr.begin() + off
+      );
+    }
+
+    // ids of the n_copied SDs packed in bfr starting at off stored from n_part_old on,
+    // so that hskpng_resize_npart() does not give them new ones
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::xchng_unpack_id(
+      const thrust_device::vector<sd_id_t> &bfr,
+      const thrust_size_t &off,
+      const thrust_size_t &n_copied
+    )
+    {
+      assert(n_part == n_part_old + n_copied);
+      sd_id.resize(n_part);
+      thrust::copy(bfr.begin() + off, bfr.begin() + off + n_copied, sd_id.begin() + n_part_old);
+    }
+  };
+};
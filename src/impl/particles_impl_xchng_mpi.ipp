@@ -0,0 +1,187 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  * @brief exchange of SDs and of Courant number halos between MPI ranks
+  */
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    // getting x boundaries of the neighbouring slabs
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::xchng_init_mpi()
+    {
+#if defined(USE_MPI)
+      mpiErrchk(MPI_Sendrecv(
+        &opts_init.x1, 1, detail::mpi_type<real_t>(), rgt_rank, 0,
+        &lft_x1,       1, detail::mpi_type<real_t>(), lft_rank, 0,
+        MPI_COMM_WORLD, MPI_STATUS_IGNORE
+      ));
+      mpiErrchk(MPI_Sendrecv(
+        &opts_init.x0, 1, detail::mpi_type<real_t>(), lft_rank, 1,
+        &rgt_x0,       1, detail::mpi_type<real_t>(), rgt_rank, 1,
+        MPI_COMM_WORLD, MPI_STATUS_IGNORE
+      ));
+#endif
+    }
+
+    // moving SDs that left the slab (ids saved by bcnd() in i and k) to the neighbouring ranks,
+    // the MPI counterpart of what multi_CUDA does with peer-to-peer copies; the transfers in both
+    // directions are only posted here and completed by xchng_sds_mpi_wait() after the SDs
+    // that stayed are compacted
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::xchng_sds_mpi_post()
+    {
+#if defined(USE_MPI)
+      // i and k must have not changed since bcnd() !!
+      const thrust_device::vector<thrust_size_t> &lft_id(i);
+      const thrust_device::vector<thrust_size_t> &rgt_id(k);
+
+      const int real_vctrs_count = xchng_real_vctrs().size();
+
+      // the buffers hold both directions, one half each
+      const thrust_size_t n_half = in_n_bfr.size() / 2,
+                          real_half = in_real_bfr.size() / 2;
+
+      // to the left (receiving from the right) and to the right (receiving from the left)
+      for(int dir = 0; dir < 2; ++dir)
+      {
+        const thrust_device::vector<thrust_size_t> &ids(dir == 0 ? lft_id : rgt_id);
+        const thrust_size_t count = dir == 0 ? lft_count : rgt_count;
+        const int dst = dir == 0 ? lft_rank : rgt_rank,
+                  src = dir == 0 ? rgt_rank : lft_rank;
+
+        // x adjusted to the domain of the receiving rank
+        thrust::transform(
+          thrust::make_permutation_iterator(x.begin(), ids.begin()),
+          thrust::make_permutation_iterator(x.begin(), ids.begin()) + count,
+          thrust::make_permutation_iterator(x.begin(), ids.begin()), // in place
+          dir == 0 ? detail::remote<real_t>(opts_init.x0, lft_x1) : detail::remote<real_t>(opts_init.x1, rgt_x0)
+        );
+
+        // packing
+        assert(n_half >= count);
+        assert(real_half >= count * real_vctrs_count);
+        thrust::copy(
+          thrust::make_permutation_iterator(n.begin(), ids.begin()),
+          thrust::make_permutation_iterator(n.begin(), ids.begin()) + count,
+          out_n_bfr.begin() + dir * n_half
+        );
+        xchng_pack_real(ids, count, out_real_bfr, dir * real_half);
+        xchng_pack_id(ids, count, out_id_bfr, dir * n_half);
+
+        // the number of SDs received is known from the size of the message
+        xchng_sds_req.post(out_n_bfr, dir * n_half, count, dst, in_n_bfr, dir * n_half, n_half, src, 3 + 3 * dir, tmp_host_n_pool);
+        xchng_sds_req.post(out_real_bfr, dir * real_half, count * real_vctrs_count, dst, in_real_bfr, dir * real_half, real_half, src, 4 + 3 * dir, tmp_host_real_pool);
+        xchng_sds_req.post(out_id_bfr, dir * n_half, count, dst, in_id_bfr, dir * n_half, n_half, src, 2 + 3 * dir, tmp_host_id_pool);
+      }
+
+      // flag SDs sent left/right for removal
+      thrust::copy(
+        thrust::make_constant_iterator<n_t>(0),
+        thrust::make_constant_iterator<n_t>(0) + lft_count,
+        thrust::make_permutation_iterator(n.begin(), lft_id.begin())
+      );
+      thrust::copy(
+        thrust::make_constant_iterator<n_t>(0),
+        thrust::make_constant_iterator<n_t>(0) + rgt_count,
+        thrust::make_permutation_iterator(n.begin(), rgt_id.begin())
+      );
+#endif
+    }
+
+    // appending the SDs received from the neighbouring ranks
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::xchng_sds_mpi_wait()
+    {
+#if defined(USE_MPI)
+      namespace arg = thrust::placeholders;
+
+      if(!xchng_sds_req.pending()) return;
+
+      const int real_vctrs_count = xchng_real_vctrs().size();
+
+      const thrust_size_t n_half = in_n_bfr.size() / 2,
+                          real_half = in_real_bfr.size() / 2;
+
+      // n, real_t and id buffers of each direction, in the order of posting
+      const std::vector<thrust_size_t> n_rcvd = xchng_sds_req.wait();
+
+      for(int dir = 0; dir < 2; ++dir)
+      {
+        const thrust_size_t n_rcv = n_rcvd[3 * dir];
+        assert(n_rcvd[3 * dir + 1] == n_rcv * real_vctrs_count);
+        assert(n_rcvd[3 * dir + 2] == n_rcv);
+
+        // unpacking
+        n_part_old = n_part;
+        n_part += n_rcv;
+        if(n_part > opts_init.n_sd_max)
+          throw std::runtime_error(detail::formatter() << "Too many SDs received from the neighbouring ranks, n_sd_max: " << opts_init.n_sd_max << " needed: " << n_part);
+
+        n.resize(n_part);
+        thrust::copy(in_n_bfr.begin() + dir * n_half, in_n_bfr.begin() + dir * n_half + n_rcv, n.begin() + n_part_old);
+
+        xchng_unpack_real(in_real_bfr, dir * real_half, n_rcv);
+        xchng_unpack_id(in_id_bfr, dir * n_half, n_rcv);
+
+        // sanitize x==x1 that could happen due to round-off in remote()
+        thrust::transform_if(x.begin() + n_part_old, x.begin() + n_part, x.begin() + n_part_old, detail::nextafter_fctr<real_t>(0.), arg::_1 == opts_init.x1);
+      }
+
+      // resize all vectors of size n_part
+      hskpng_resize_npart();
+
+      // particles are not sorted now
+      sorted = false;
+      presorted = false;
+#endif
+    }
+
+    // filling the 1-cell x halo of the Courant number fields with values from the neighbouring ranks;
+    // the transfers are completed by xchng_courants_mpi_wait() before the halo is used in adve()
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::xchng_courants_mpi_post()
+    {
+#if defined(USE_MPI)
+      // e.g. a step_async() that threw before adve()
+      xchng_courants_mpi_wait();
+
+      // vectors with the number of elements in one x column
+      std::vector<std::pair<thrust_device::vector<real_t>*, int> > vctrs;
+      switch (n_dims)
+      {
+        case 3:
+          vctrs.push_back(std::make_pair(&courant_y, halo_y));
+        case 2:
+          vctrs.push_back(std::make_pair(&courant_z, halo_z));
+        case 1:
+          vctrs.push_back(std::make_pair(&courant_x, halo_x));
+      }
+
+      for(int v = 0; v < vctrs.size(); ++v)
+      {
+        thrust_device::vector<real_t> &vec(*vctrs[v].first);
+        const thrust_size_t col = vctrs[v].second,
+                            n_col = vec.size() / col; // nx + 2 halo columns (+ 1 for courant_x)
+
+        // the last column of this slab is the left halo of the right neighbour
+        xchng_courants_req.post(vec, opts_init.nx * col, col, rgt_rank, vec, 0, col, lft_rank, 8 + 2 * v, tmp_host_real_pool);
+        // and the first column (not shared with the left neighbour) is its right halo
+        xchng_courants_req.post(vec, (n_col - 1 - opts_init.nx) * col, col, lft_rank, vec, (n_col - 1) * col, col, rgt_rank, 9 + 2 * v, tmp_host_real_pool);
+      }
+#endif
+    }
+
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::impl::xchng_courants_mpi_wait()
+    {
+#if defined(USE_MPI)
+      xchng_courants_req.wait();
+#endif
+    }
+  };
+};
@@ -18,6 +18,8 @@ namespace libcloudphxx
       opts_init_t<real_t> glob_opts_init; // global copy of opts_init (threads store their own in impl), 
       const int n_cell_tot;               // total number of cells
       std::vector<real_t> real_n_cell_tot; // vector of the size of the total number of cells to store output
+      std::vector<real_t> real_n_cell_tot_moms; // ditto for the output of diag_moms (n_cell_tot per moment)
+      detail::async_worker async;         // worker thread running step_async() for step_async_begin()
 
       // cxx threads helper methods
       template<typename F, typename ... Args>
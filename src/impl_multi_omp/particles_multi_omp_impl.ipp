@@ -0,0 +1,172 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  */
+
+#include <omp.h>
+
+#include <cstdlib>
+#include <string>
+#if defined(__linux__)
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+
+// contains definitions of members of particles_t specialized for multiple OpenMP x-slabs
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    // multi_OpenMP pimpl stuff
+    template <typename real_t>
+    struct particles_t<real_t, multi_OpenMP>::impl
+    {
+      std::vector<std::unique_ptr<particles_t<real_t, OpenMP> > > particles; // pointer to particles_t of each slab
+      opts_init_t<real_t> glob_opts_init; // global copy of opts_init (slabs store their own in impl),
+      const int n_cell_tot;               // total number of cells
+      int n_thrd;                         // number of OpenMP threads per slab
+      std::vector<real_t> real_n_cell_tot; // vector of the size of the total number of cells to store output
+      std::vector<real_t> real_n_cell_tot_moms; // ditto for the output of diag_moms (n_cell_tot per moment)
+      detail::async_worker async;         // worker thread running step_async() for step_async_begin()
+
+      // cxx threads helper methods
+      void bind_slab(const int &dom_id);
+      void run(const std::vector<std::function<void()> > &funs);
+
+      template<typename F, typename ... Args>
+      void momp_run(F&& fun, Args&& ... args);
+
+      void step_async_and_copy(
+        const opts_t<real_t> &opts,
+        const int dom_id,
+        detail::barrier_t &
+      );
+
+      //ctor
+      impl(const opts_init_t<real_t> &_opts_init) :
+        glob_opts_init(_opts_init),
+        n_cell_tot(
+          std::max(1, glob_opts_init.nx) *
+          std::max(1, glob_opts_init.ny) *
+          std::max(1, glob_opts_init.nz)
+        )
+      {
+        if(glob_opts_init.src_switch) throw std::runtime_error("multi_OpenMP is not yet compatible with source. Use other backend or turn off opts_init.src_switch.");
+        if(glob_opts_init.chem_switch) throw std::runtime_error("multi_OpenMP is not yet compatible with chemistry. Use other backend or turn off opts_init.chem_switch.");
+
+        // multi_OpenMP works only for 2D and 3D
+        if(glob_opts_init.nz == 0)
+          throw std::runtime_error("multi_OpenMP backend works only for 2D and 3D simulations.");
+
+        if (!(glob_opts_init.x1 > glob_opts_init.x0 && glob_opts_init.x1 <= glob_opts_init.nx * glob_opts_init.dx))
+          throw std::runtime_error("!(x1 > x0 & x1 <= min(1,nx)*dx)");
+
+        // set number of slabs, by default one per OpenMP thread
+        int dom_count = glob_opts_init.dev_count;
+        if(dom_count < 0)
+          throw std::runtime_error("opts_init.dev_count (number of slabs) cannot be negative");
+        if(dom_count == 0)
+          dom_count = std::min(omp_get_max_threads(), glob_opts_init.nx);
+
+        if(dom_count > glob_opts_init.nx)
+          throw std::runtime_error(detail::formatter() <<"Number of slabs (" << dom_count << ") used is greater than nx (" << glob_opts_init.nx <<")");
+
+        // copy dev_count to opts_init for threads to use
+        glob_opts_init.dev_count = dom_count;
+
+        // OpenMP threads divided evenly among the slabs
+        n_thrd = std::max(1, omp_get_max_threads() / dom_count);
+
+        // resize the pointer vector
+        particles.reserve(dom_count);
+        // resize the output buffer
+        real_n_cell_tot.resize(n_cell_tot);
+
+        // create particles_t of each slab
+        int n_x_bfr;
+        for(int dom_id = 0; dom_id < dom_count; ++dom_id)
+        {
+          opts_init_t<real_t> opts_init_tmp(glob_opts_init);
+          n_x_bfr = dom_id * detail::get_dev_nx(glob_opts_init, 0);
+
+          if(dom_count > 1)
+          {
+            // modify nx for each slab
+            opts_init_tmp.nx = detail::get_dev_nx(glob_opts_init, dom_id);
+
+            // adjust x0, x1 for each slab
+            if(dom_id != 0) opts_init_tmp.x0 = 0.; // TODO: what if x0 greater than domain of first slab?
+            if(dom_id != dom_count-1) opts_init_tmp.x1 = opts_init_tmp.nx * opts_init_tmp.dx; //TODO: same as above
+            else opts_init_tmp.x1 = opts_init_tmp.x1 - n_x_bfr * opts_init_tmp.dx;
+
+            // adjust max numer of SDs in each slab
+            opts_init_tmp.n_sd_max = opts_init_tmp.n_sd_max / dom_count + 1;
+          }
+          particles.emplace_back(std::unique_ptr<particles_t<real_t, OpenMP>>(new particles_t<real_t, OpenMP>(opts_init_tmp, n_x_bfr, glob_opts_init.nx))); // impl stores a copy of opts_init
+        }
+      }
+    };
+
+    // if OpenMP thread binding is requested (OMP_PROC_BIND other than false), each slab's thread 
+    // is bound to its own n_thrd CPUs out of those available to the process, the OpenMP threads 
+    // it starts inherit the binding; otherwise the placement is left to the system
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::impl::bind_slab(const int &dom_id)
+    {
+#if defined(__linux__)
+      const char *bind = std::getenv("OMP_PROC_BIND");
+      if (bind == NULL || std::string(bind) == "false" || std::string(bind) == "FALSE") return;
+
+      cpu_set_t avail, slab;
+      if (sched_getaffinity(0, sizeof(cpu_set_t), &avail) != 0) return;
+
+      CPU_ZERO(&slab);
+      for (int cpu = 0, n = 0; cpu < CPU_SETSIZE && n < (dom_id + 1) * n_thrd; ++cpu)
+      {
+        if (!CPU_ISSET(cpu, &avail)) continue;
+        if (n++ >= dom_id * n_thrd) CPU_SET(cpu, &slab);
+      }
+      if (CPU_COUNT(&slab) > 0) pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &slab);
+#endif
+    }
+
+    // run functions concurrently, one per slab, each in a thread with its own team of n_thrd OpenMP threads;
+    // the first exception thrown is rethrown after all threads are joined (barrier_aborted
+    // thrown in the slabs released by a failing one only if there is no other)
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::impl::run(const std::vector<std::function<void()> > &funs)
+    {
+      std::vector<std::exception_ptr> errors(funs.size()), aborted(funs.size());
+      std::vector<std::thread> threads;
+      for (int i = 0; i < funs.size(); ++i)
+      {
+        threads.emplace_back(
+          [this, i, &funs, &errors, &aborted]()
+          {
+            bind_slab(i);
+            omp_set_num_threads(n_thrd);
+            try { funs[i](); }
+            catch (const detail::barrier_aborted &) { aborted[i] = std::current_exception(); }
+            catch (...) { errors[i] = std::current_exception(); }
+          }
+        );
+      }
+      for (auto &th : threads) th.join();
+      for (auto &err : errors) if (err) std::rethrow_exception(err);
+      for (auto &err : aborted) if (err) std::rethrow_exception(err);
+    }
+
+    // run a member function concurrently on all slabs
+    template <typename real_t>
+    template<typename F, typename ... Args>
+    void particles_t<real_t, multi_OpenMP>::impl::momp_run(F&& fun, Args&& ... args)
+    {
+      std::vector<std::function<void()> > funs;
+      for (int i = 0; i < glob_opts_init.dev_count; ++i)
+        funs.push_back(std::bind(fun, particles[i].get(), args...));
+      run(funs);
+    };
+  };
+};
@@ -0,0 +1,126 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  */
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    // same as the multi_CUDA step_async_and_copy(), but with the slabs sharing memory
+    // the particles are read directly from the out buffers of the neighbouring slabs
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::impl::step_async_and_copy(
+      const opts_t<real_t> &opts,
+      const int dom_id,
+      detail::barrier_t &barrier
+    )
+    {
+      // do step async on each slab
+      particles[dom_id]->step_async(opts);
+
+      // --- copy advected SDs to other slabs ---
+      if(opts.adve && glob_opts_init.dev_count>1)
+      {
+        namespace arg = thrust::placeholders;
+        typedef typename particles_t<real_t, OpenMP>::impl::n_t n_t;
+        typename particles_t<real_t, OpenMP>::impl &lcl(*particles[dom_id]->pimpl);
+
+        // helper aliases
+        const thrust_size_t &lft_count(lcl.lft_count);
+        const thrust_size_t &rgt_count(lcl.rgt_count);
+        thrust_size_t &n_part(lcl.n_part);
+        thrust_size_t &n_part_old(lcl.n_part_old);
+        thrust_device::vector<real_t> &x(lcl.x);
+        thrust_device::vector<n_t> &n(lcl.n);
+        // i and k must have not changed since impl->bcnd !!
+        const thrust_device::vector<thrust_size_t> &lft_id(lcl.i);
+        const thrust_device::vector<thrust_size_t> &rgt_id(lcl.k);
+
+        // IDs of slabs to the left/right, periodic boundary in x
+        const int lft_dom = dom_id > 0 ? dom_id - 1 : glob_opts_init.dev_count - 1,
+                  rgt_dom = dom_id < glob_opts_init.dev_count-1 ? dom_id + 1 : 0;
+        typename particles_t<real_t, OpenMP>::impl
+          &lft(*particles[lft_dom]->pimpl),
+          &rgt(*particles[rgt_dom]->pimpl);
+
+        // packs SDs with given ids into the out buffers, x adjusted to the domain of the receiving slab
+        auto pack = [&](const thrust_device::vector<thrust_size_t> &ids, const thrust_size_t &count, const real_t &x_lcl, const real_t &x_rmt)
+        {
+          assert(lcl.out_n_bfr.size() >= count);
+
+          thrust::copy(
+            thrust::make_permutation_iterator(n.begin(), ids.begin()),
+            thrust::make_permutation_iterator(n.begin(), ids.begin()) + count,
+            lcl.out_n_bfr.begin()
+          );
+
+          thrust::transform(
+            thrust::make_permutation_iterator(x.begin(), ids.begin()),
+            thrust::make_permutation_iterator(x.begin(), ids.begin()) + count,
+            thrust::make_permutation_iterator(x.begin(), ids.begin()), // in place
+            detail::remote<real_t>(x_lcl, x_rmt)
+          );
+
+          lcl.xchng_pack_real(ids, count, lcl.out_real_bfr, 0);
+          lcl.xchng_pack_id(ids, count, lcl.out_id_bfr, 0);
+        };
+
+        // appends SDs from the out buffers of a neighbouring slab
+        auto unpack = [&](const typename particles_t<real_t, OpenMP>::impl &src, const thrust_size_t &n_copied)
+        {
+          if (n_part + n_copied > lcl.opts_init.n_sd_max)
+            throw std::runtime_error(detail::formatter() << "multi_OpenMP: slab " << dom_id << " would exceed its n_sd_max (" 
+              << lcl.opts_init.n_sd_max << ") with SDs copied from a neighbouring slab, increase opts_init.n_sd_max");
+
+          n_part_old = n_part;
+          n_part += n_copied;
+
+          n.resize(n_part);
+          thrust::copy(src.out_n_bfr.begin(), src.out_n_bfr.begin() + n_copied, n.begin() + n_part_old);
+
+          lcl.xchng_unpack_real(src.out_real_bfr, 0, n_copied);
+          lcl.xchng_unpack_id(src.out_id_bfr, 0, n_copied);
+
+          // sanitize x==x1 that could happen due to round-off in remote()
+          thrust::transform_if(x.begin() + n_part_old, x.begin() + n_part, x.begin() + n_part_old, detail::nextafter_fctr<real_t>(0.), arg::_1 == lcl.opts_init.x1);
+        };
+
+        // to the left
+        pack(lft_id, lft_count, lcl.opts_init.x0, lft.opts_init.x1);
+        barrier.wait(); // all slabs packed
+        unpack(rgt, rgt.lft_count);
+        barrier.wait(); // all slabs unpacked, out buffers can be reused
+
+        // to the right
+        pack(rgt_id, rgt_count, lcl.opts_init.x1, rgt.opts_init.x0);
+        barrier.wait();
+        unpack(lft, lft.rgt_count);
+
+        // flag SDs sent left/right for removal
+        thrust::copy(
+          thrust::make_constant_iterator<n_t>(0),
+          thrust::make_constant_iterator<n_t>(0) + lft_count,
+          thrust::make_permutation_iterator(n.begin(), lft_id.begin())
+        );
+        thrust::copy(
+          thrust::make_constant_iterator<n_t>(0),
+          thrust::make_constant_iterator<n_t>(0) + rgt_count,
+          thrust::make_permutation_iterator(n.begin(), rgt_id.begin())
+        );
+
+        // resize all vectors of size n_part
+        lcl.hskpng_resize_npart();
+
+        // particles are not sorted now
+        lcl.sorted = false;
+        lcl.presorted = false;
+      }
+      // finalize async
+      if(glob_opts_init.dev_count>1)
+        particles[dom_id]->pimpl->step_finalize(opts);
+    }
+  };
+};
@@ -0,0 +1,52 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  * @brief collision efficiency tables, compiled once for all backends and precisions
+  */
+
+#include <cstddef>
+#include <libcloudph++/lgrngn/kernel.hpp>
+
+#include "detail/kernel_definitions/hall_efficiencies.hpp"
+#include "detail/kernel_definitions/hall_davis_no_waals_efficiencies.hpp"
+#include "detail/kernel_definitions/vohl_davis_no_waals_efficiencies.hpp"
+#include "detail/kernel_definitions/hall_pinsky_stratocumulus_efficiencies.hpp"
+#include "detail/kernel_definitions/hall_pinsky_cumulonimbus_efficiencies.hpp"
+#include "detail/kernel_definitions/hall_pinsky_1000mb_grav_efficiencies.hpp"
+
+#define LIBCLOUDPHXX_EFF_TAB(name) size = sizeof(name) / sizeof(name[0]); return name;
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    namespace detail
+    {
+      const double *efficiencies_tab(const kernel_t::kernel_t &kernel, std::size_t &size)
+      {
+        switch (kernel)
+        {
+          case kernel_t::hall:
+          case kernel_t::onishi_hall:
+            LIBCLOUDPHXX_EFF_TAB(hall_efficiencies)
+          case kernel_t::hall_davis_no_waals:
+          case kernel_t::onishi_hall_davis_no_waals:
+            LIBCLOUDPHXX_EFF_TAB(hall_davis_no_waals_efficiencies)
+          case kernel_t::vohl_davis_no_waals:
+            LIBCLOUDPHXX_EFF_TAB(vohl_davis_no_waals_efficiencies)
+          case kernel_t::hall_pinsky_stratocumulus:
+            LIBCLOUDPHXX_EFF_TAB(hall_pinsky_stratocumulus_efficiencies)
+          case kernel_t::hall_pinsky_cumulonimbus:
+            LIBCLOUDPHXX_EFF_TAB(hall_pinsky_cumulonimbus_efficiencies)
+          case kernel_t::hall_pinsky_1000mb_grav:
+            LIBCLOUDPHXX_EFF_TAB(hall_pinsky_1000mb_grav_efficiencies)
+          default:
+            size = 0;
+            return NULL;
+        }
+      }
+    };
+  };
+};
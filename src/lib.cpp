@@ -12,7 +12,7 @@ namespace libcloudphxx
     template <typename real_t>
     particles_proto_t<real_t> *factory(const backend_t backend, opts_init_t<real_t> opts_init)
     {
-      if(backend != multi_CUDA) opts_init.dev_count = 0; // override user-defined dev_count if not using multi_CUDA
+      if(backend != multi_CUDA && backend != multi_OpenMP) opts_init.dev_count = 0; // override user-defined dev_count if not using multi_CUDA or multi_OpenMP
 
       switch (backend)
       {
@@ -27,6 +27,12 @@ namespace libcloudphxx
 	  return new particles_t<real_t, CUDA>(opts_init, 0); // 0 cells to the left of this domain (i.e. it's not a distributed-memory run)
 #else
           throw std::runtime_error("CUDA backend was not compiled");
+#endif
+	case multi_OpenMP:
+#if defined(_OPENMP)
+	  return new particles_t<real_t, multi_OpenMP>(opts_init);
+#else
+          throw std::runtime_error("multi_OpenMP backend was not compiled"); 
 #endif
 	case OpenMP:
 #if defined(_OPENMP)
@@ -7,6 +7,7 @@
 namespace thrust_device = ::thrust::omp;
 
 #include "particles.tpp"
+#include "particles_multi_omp.tpp"
 #include <omp.h>
 
 namespace libcloudphxx
@@ -39,5 +40,8 @@ namespace libcloudphxx
     // instantiation 
     template class particles_t<float, OpenMP>;
     template class particles_t<double, OpenMP>;
+
+    template class particles_t<float, multi_OpenMP>;
+    template class particles_t<double, multi_OpenMP>;
   };
 };
@@ -12,6 +12,7 @@
 
 #include "detail/config.hpp"
 #include "detail/thrust.hpp"
+#include "detail/multiplicity.hpp"
 #include "detail/urand.hpp"
 #include "detail/eval_and_oper.hpp"
 #include "detail/kernel_utils.hpp"
@@ -20,23 +21,28 @@
 #include "detail/checknan.hpp"
 #include "detail/formatter.cpp"
 #include "detail/tpl_calc_wrapper.hpp"
+#include "detail/kernel_tab.hpp"
+#include "detail/vterm_tab.hpp"
 #include "detail/kernels.hpp"
 #include "detail/kernel_interpolation.hpp"
 #include "detail/functors_host.hpp"
+#include "detail/async_worker.hpp"
+#include "detail/multi_domain_utils.hpp"
+#include "detail/distmem_mpi.hpp"
+#include "detail/checkpoint.hpp"
+#include "detail/snapshot.hpp"
+#include "detail/workspace.hpp"
 
 //kernel definitions
-#include "detail/kernel_definitions/hall_efficiencies.hpp"
-#include "detail/kernel_definitions/hall_davis_no_waals_efficiencies.hpp"
-#include "detail/kernel_definitions/vohl_davis_no_waals_efficiencies.hpp"
-#include "detail/kernel_definitions/hall_pinsky_stratocumulus_efficiencies.hpp"
-#include "detail/kernel_definitions/hall_pinsky_cumulonimbus_efficiencies.hpp"
-#include "detail/kernel_definitions/hall_pinsky_1000mb_grav_efficiencies.hpp"
+#include "detail/kernel_efficiencies.hpp"
 
 // public API
 #include "particles_ctor.ipp"
 #include "particles_init.ipp"
 #include "particles_step.ipp"
 #include "particles_diag.ipp"
+#include "particles_checkpoint.ipp"
+#include "particles_snapshot.ipp"
 
 // details
 #include "impl/particles_impl.ipp"
@@ -60,16 +66,23 @@
 #include "impl/particles_impl_init_sync.ipp"
 #include "impl/particles_impl_init_hskpng_npart.ipp"
 #include "impl/particles_impl_init_hskpng_ncell.ipp"
+#include "impl/particles_impl_init_workspace.ipp"
 #include "impl/particles_impl_init_chem.ipp"
 #include "impl/particles_impl_init_kernel.ipp"
+#include "impl/particles_impl_init_kernel_tab.ipp"
 #include "impl/particles_impl_step_finalize.ipp"
 #include "impl/particles_impl_init_vterm.ipp"
 #include "impl/particles_impl_init_sanity_check.ipp"
+#include "impl/particles_impl_init_eulerian.ipp"
+#include "impl/particles_impl_checkpoint.ipp"
+#include "impl/particles_impl_snapshot.ipp"
 #include "impl/particles_impl_update_th_rv.ipp"
 #include "impl/particles_impl_hskpng_ijk.ipp"
 #include "impl/particles_impl_hskpng_Tpr.ipp"
 #include "impl/particles_impl_hskpng_vterm.ipp"
+#include "impl/particles_impl_init_vterm_tab.ipp"
 #include "impl/particles_impl_hskpng_sort.ipp"
+#include "impl/particles_impl_hskpng_reorder.ipp"
 #include "impl/particles_impl_hskpng_count.ipp"
 #include "impl/particles_impl_hskpng_remove.ipp"
 #include "impl/particles_impl_hskpng_resize.ipp"
@@ -78,6 +91,8 @@
 #include "impl/particles_impl_fill_outbuf.ipp"
 #include "impl/particles_impl_sync.ipp"
 #include "impl/particles_impl_bcnd.ipp" // bcnd has to be b4 adve for periodic struct; move it to separate file in detail...
+#include "impl/particles_impl_xchng.ipp"
+#include "impl/particles_impl_xchng_mpi.ipp"
 #include "impl/particles_impl_adve.ipp"
 #include "impl/particles_impl_cond_common.ipp"
 #include "impl/particles_impl_cond.ipp"
@@ -0,0 +1,48 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  * @brief checkpointing and restarting from a checkpoint
+  */
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::checkpoint(const std::string &path)
+    {
+      // a step started with step_async_begin() has to complete first
+      pimpl->async.wait();
+
+      if (!pimpl->init_called)
+        throw std::runtime_error("please call init() or restore() before checkpoint()");
+      if (pimpl->should_now_run_async)
+        throw std::runtime_error("please call step_async() before checkpoint()");
+
+      pimpl->checkpoint(detail::mpi_path(path, pimpl->mpi_rank, pimpl->mpi_size));
+    }
+
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::restore(
+      const std::string &path,
+      const arrinfo_t<real_t> th,
+      const arrinfo_t<real_t> rv,
+      const arrinfo_t<real_t> rhod,
+      const arrinfo_t<real_t> courant_x, // might be NULL
+      const arrinfo_t<real_t> courant_y, // might be NULL
+      const arrinfo_t<real_t> courant_z, // might be NULL
+      const std::map<enum chem_species_t, const arrinfo_t<real_t> > ambient_chem
+    )
+    {
+      // Eulerian-Lagrangian coupling, grid and memory allocation as in init()
+      pimpl->init_eulerian(th, rv, rhod, courant_x, courant_y, courant_z, ambient_chem);
+
+      // super-droplets and counters from the file
+      pimpl->restore(detail::mpi_path(path, pimpl->mpi_rank, pimpl->mpi_size));
+
+      pimpl->init_finalize();
+    }
+  };
+};
@@ -22,16 +22,61 @@ namespace libcloudphxx
   {
     // ctor
     template <typename real_t, backend_t device>
-    particles_t<real_t, device>::particles_t(const opts_init_t<real_t> &opts_init, const int &n_x_bfr, int n_x_tot) 
+    particles_t<real_t, device>::particles_t(const opts_init_t<real_t> &_opts_init, const int &_n_x_bfr, int n_x_tot) 
     {
+      opts_init_t<real_t> opts_init(_opts_init);
+      int n_x_bfr = _n_x_bfr;
+
+      int mpi_rank, mpi_size;
+      detail::mpi_init(mpi_rank, mpi_size);
+
 #if defined(__NVCC__)
       if(opts_init.dev_id >= 0)
         cudaSetDevice(opts_init.dev_id);
 #endif
-      if(opts_init.dev_count < 2) // no distmem
+
+#if defined(USE_MPI)
+      // distributed memory: each rank gets its own x-slab of the domain (opts_init.nx columns),
+      // the Eulerian arrays passed to init() and step_sync() cover only that slab
+      if(mpi_size > 1)
+      {
+        if(opts_init.dev_count > 1) throw std::runtime_error("multi_CUDA and multi_OpenMP backends cannot be used in MPI runs.");
+        if(opts_init.nz == 0) throw std::runtime_error("MPI runs work only for 2D and 3D simulations.");
+        if(opts_init.src_switch) throw std::runtime_error("MPI runs are not yet compatible with source. Turn off opts_init.src_switch.");
+        if(opts_init.chem_switch) throw std::runtime_error("MPI runs are not yet compatible with chemistry. Turn off opts_init.chem_switch.");
+
+        // number of columns in the slabs to the left and in the whole domain
+        int nx_bfr = 0, nx_tot;
+        mpiErrchk(MPI_Exscan(&opts_init.nx, &nx_bfr, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD));
+        if(mpi_rank == 0) nx_bfr = 0; // not defined by MPI_Exscan
+        mpiErrchk(MPI_Allreduce(&opts_init.nx, &nx_tot, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD));
+
+        if (!(opts_init.x1 > opts_init.x0 && opts_init.x1 <= nx_tot * opts_init.dx))
+          throw std::runtime_error("!(x1 > x0 & x1 <= sum of nx of all ranks * dx)");
+
+        // x0 and x1 are given for the whole domain, adjusted to each slab as for multi_CUDA devices
+        if(mpi_rank != 0) opts_init.x0 = 0.;
+        if(mpi_rank != mpi_size-1) opts_init.x1 = opts_init.nx * opts_init.dx;
+        else opts_init.x1 = opts_init.x1 - nx_bfr * opts_init.dx;
+
+        if (!(opts_init.x1 > opts_init.x0 && opts_init.x1 <= opts_init.nx * opts_init.dx))
+          throw std::runtime_error("x0 has to be within the slab of the first rank and x1 within the slab of the last rank");
+
+        // different random numbers on each rank
+        opts_init.rng_seed += mpi_rank;
+
+        // local arrays, not offset within a global one
+        n_x_bfr = 0;
+      }
+#endif
+
+      if(opts_init.dev_count < 2) // no distmem, or distmem with local arrays (MPI)
         n_x_tot = opts_init.nx;
 
-      pimpl.reset(new impl(opts_init, n_x_bfr, n_x_tot));
+      pimpl.reset(new impl(opts_init, n_x_bfr, n_x_tot, mpi_rank, mpi_size));
+
+      if(pimpl->distmem_mpi())
+        pimpl->xchng_init_mpi();
 
       this->opts_init = &pimpl->opts_init;
       pimpl->sanity_checks();
@@ -43,7 +88,11 @@ namespace libcloudphxx
 
     // dtor
     template <typename real_t, backend_t device>
-    particles_t<real_t, device>::~particles_t() {};
+    particles_t<real_t, device>::~particles_t() 
+    {
+      // a step started with step_async_begin() might still be running on pimpl
+      pimpl->async.stop();
+    };
 
     // outbuf
     template <typename real_t, backend_t device>
@@ -123,6 +123,24 @@ namespace libcloudphxx
       thrust::sequence(pimpl->count_ijk.begin(), pimpl->count_ijk.end());
     }
 
+    // records the number of coalescence substeps in each cell (adaptive_sstp_coal)
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::diag_sstp_coal()
+    {
+      if (pimpl->opts_init.adaptive_sstp_coal)
+        thrust::copy(
+          pimpl->sstp_coal_cell.begin(), 
+          pimpl->sstp_coal_cell.end(), 
+          pimpl->count_mom.begin()
+        );
+      else
+        thrust::fill(pimpl->count_mom.begin(), pimpl->count_mom.end(), real_t(pimpl->opts_init.sstp_coal));
+
+      // defined in all cells
+      pimpl->count_n = pimpl->n_cell;
+      thrust::sequence(pimpl->count_ijk.begin(), pimpl->count_ijk.end());
+    }
+
     // records super-droplet concentration per grid cell
     template <typename real_t, backend_t device>
     void particles_t<real_t, device>::diag_sd_conc()
@@ -264,6 +282,9 @@ namespace libcloudphxx
     {   
       if(pimpl->n_dims==0) return;
 
+      // Courant number halos posted in step_sync()
+      if(pimpl->distmem_mpi()) pimpl->xchng_courants_mpi_wait();
+
       typedef thrust::permutation_iterator<
         typename thrust_device::vector<thrust_size_t>::iterator,
         typename thrust::counting_iterator<thrust_size_t>
@@ -357,10 +378,7 @@ namespace libcloudphxx
 
       pimpl->hskpng_sort();
 
-      thrust::pair<
-        thrust_device::vector<thrust_size_t>::iterator,
-        typename thrust_device::vector<real_t>::iterator
-      > n = thrust::reduce_by_key(
+      auto n = thrust::reduce_by_key(
         // input - keys
         pimpl->sorted_ijk.begin(), pimpl->sorted_ijk.end(),  
         // input - values
@@ -393,7 +411,74 @@ namespace libcloudphxx
     template <typename real_t, backend_t device>
     std::map<output_t, real_t> particles_t<real_t, device>::diag_puddle()
     {
+#if defined(USE_MPI)
+      if (pimpl->distmem_mpi())
+      {
+        // summed over all ranks
+        std::vector<real_t> tmp;
+        for (auto &x : pimpl->output_puddle) tmp.push_back(x.second);
+        detail::mpi_allreduce_sum(tmp.data(), tmp.size());
+
+        std::map<output_t, real_t> res;
+        int i = 0;
+        for (auto &x : pimpl->output_puddle) res[x.first] = tmp[i++];
+        return res;
+      }
+#endif
       return pimpl->output_puddle;
     }
+
+    template <typename real_t, backend_t device>
+    cond_stats_t particles_t<real_t, device>::diag_cond_stats()
+    {
+      return pimpl->cond_stats;
+    }
+
+    template <typename real_t, backend_t device>
+    kernel_tab_info_t particles_t<real_t, device>::diag_kernel_tab()
+    {
+      return pimpl->kernel_tab_info;
+    }
+
+    template <typename real_t, backend_t device>
+    vt_tab_info_t particles_t<real_t, device>::diag_vt_tab()
+    {
+      return pimpl->vt_tab_info;
+    }
+
+    template <typename real_t, backend_t device>
+    workspace_info_t particles_t<real_t, device>::diag_workspace()
+    {
+      // a step started with step_async_begin() has to complete first
+      pimpl->async.wait();
+      return pimpl->ws.info();
+    }
+
+    // computes a batch of moments for different selections in one pass
+    template <typename real_t, backend_t device>
+    std::vector<real_t*> particles_t<real_t, device>::diag_moms(
+      const std::vector<moms_req_t<real_t> > &reqs
+    )
+    {
+      pimpl->moms_batch(reqs);
+
+      std::vector<real_t*> res;
+      for (thrust_size_t m = 0; m < pimpl->tmp_host_real_moms.size() / pimpl->n_cell; ++m)
+        res.push_back(&pimpl->tmp_host_real_moms[m * pimpl->n_cell]);
+      return res;
+    }
+
+    template <typename real_t, backend_t device>
+    std::vector<real_t> particles_t<real_t, device>::diag_moms_tot(
+      const std::vector<moms_req_t<real_t> > &reqs
+    )
+    {
+      std::vector<real_t> res = pimpl->moms_tot(reqs);
+#if defined(USE_MPI)
+      if (pimpl->distmem_mpi())
+        detail::mpi_allreduce_sum(res.data(), res.size());
+#endif
+      return res;
+    }
   };
 };
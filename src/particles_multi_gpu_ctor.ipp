@@ -22,7 +22,11 @@ namespace libcloudphxx
 
     // dtor
     template <typename real_t>
-    particles_t<real_t, multi_CUDA>::~particles_t() {}
+    particles_t<real_t, multi_CUDA>::~particles_t() 
+    {
+      // a step started with step_async_begin() might still be running on pimpl
+      pimpl->async.stop();
+    }
 
     // initialisation 
     template <typename real_t>
@@ -41,5 +45,103 @@ namespace libcloudphxx
         th, rv, rhod, courant_1, courant_2, courant_3, ambient_chem
       );
     }
+
+    // restore, one file per device
+    template <typename real_t>
+    void particles_t<real_t, multi_CUDA>::restore(
+      const std::string &path,
+      const arrinfo_t<real_t> th,
+      const arrinfo_t<real_t> rv,
+      const arrinfo_t<real_t> rhod,
+      const arrinfo_t<real_t> courant_1,
+      const arrinfo_t<real_t> courant_2,
+      const arrinfo_t<real_t> courant_3,
+      const std::map<enum chem_species_t, const arrinfo_t<real_t> > ambient_chem
+    )
+    {
+      std::vector<std::thread> threads;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+      {
+        threads.emplace_back(
+          detail::set_device_and_run, i, 
+          [=, &path, &ambient_chem](){
+            this->pimpl->particles[i]->restore(path + "." + std::to_string(i), th, rv, rhod, courant_1, courant_2, courant_3, ambient_chem);
+          }
+        );
+      }
+      for (auto &t : threads) t.join();
+    }
+
+    // checkpoint, one file per device
+    template <typename real_t>
+    void particles_t<real_t, multi_CUDA>::checkpoint(const std::string &path)
+    {
+      // a step started with step_async_begin() has to complete first
+      pimpl->async.wait();
+
+      std::vector<std::thread> threads;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+      {
+        threads.emplace_back(
+          detail::set_device_and_run, i, 
+          [i, this, &path](){
+            this->pimpl->particles[i]->checkpoint(path + "." + std::to_string(i));
+          }
+        );
+      }
+      for (auto &th : threads) th.join();
+    }
+
+    // streaming output, one file per device
+    template <typename real_t>
+    void particles_t<real_t, multi_CUDA>::snapshot_open(const std::string &path, const snapshot_opts_t &opts)
+    {
+      std::vector<std::thread> threads;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+      {
+        threads.emplace_back(
+          detail::set_device_and_run, i, 
+          [i, this, &path, &opts](){
+            this->pimpl->particles[i]->snapshot_open(path + "." + std::to_string(i), opts);
+          }
+        );
+      }
+      for (auto &th : threads) th.join();
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_CUDA>::snapshot()
+    {
+      // a step started with step_async_begin() has to complete first
+      pimpl->async.wait();
+
+      std::vector<std::thread> threads;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+      {
+        threads.emplace_back(
+          detail::set_device_and_run, i, 
+          [i, this](){
+            this->pimpl->particles[i]->snapshot();
+          }
+        );
+      }
+      for (auto &th : threads) th.join();
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_CUDA>::snapshot_close()
+    {
+      std::vector<std::thread> threads;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+      {
+        threads.emplace_back(
+          detail::set_device_and_run, i, 
+          [i, this](){
+            this->pimpl->particles[i]->snapshot_close();
+          }
+        );
+      }
+      for (auto &th : threads) th.join();
+    }
   };
 };
@@ -13,17 +13,6 @@ namespace libcloudphxx
 {
   namespace lgrngn
   {
-    namespace detail
-    {
-      template <class real_t>
-      std::map<output_t, real_t> empty_out_map()
-      {
-        std::map<output_t, real_t> res;
-        for(int i=0; i < chem_all+2; ++i) 
-          res[static_cast<output_t>(i)] = 0.;
-        return res;
-      }
-    }
     // diagnostic methods
     template <typename real_t>
     void particles_t<real_t, multi_CUDA>::diag_RH()
@@ -37,6 +26,12 @@ namespace libcloudphxx
       pimpl->mcuda_run(&particles_t<real_t, CUDA>::diag_vel_div);
     }
 
+    template <typename real_t>
+    void particles_t<real_t, multi_CUDA>::diag_sstp_coal()
+    {
+      pimpl->mcuda_run(&particles_t<real_t, CUDA>::diag_sstp_coal);
+    }
+
     template <typename real_t>
     void particles_t<real_t, multi_CUDA>::diag_sd_conc()
     {
@@ -144,11 +139,66 @@ namespace libcloudphxx
       return &(*(pimpl->real_n_cell_tot.begin()));
     }
 
-    template<class real_t>
-    std::map<output_t, real_t> add_puddle(std::map<output_t, real_t> x, std::map<output_t, real_t> y){
-      std::map<output_t, real_t> res;
-      for(int i=0; i < chem_all+2; ++i) 
-        res[static_cast<output_t>(i)] = x[static_cast<output_t>(i)] + y[static_cast<output_t>(i)];
+    template <typename real_t>
+    std::vector<real_t*> particles_t<real_t, multi_CUDA>::diag_moms(
+      const std::vector<moms_req_t<real_t> > &reqs
+    )
+    {
+      // run moms_batch on each gpu
+      std::vector<std::thread> threads;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+      {
+        threads.emplace_back(
+          detail::set_device_and_run, i, 
+          std::bind(
+            &particles_t<real_t, CUDA>::impl::moms_batch,
+            &(*(pimpl->particles[i]->pimpl)),
+            std::cref(reqs)
+          )
+        );
+      }
+      for (auto &th : threads) th.join();
+
+      // gathering per-device results, each moment in a separate n_cell_tot-long buffer
+      const int n_mom = pimpl->particles[0]->pimpl->tmp_host_real_moms.size() / pimpl->particles[0]->pimpl->n_cell;
+      pimpl->real_n_cell_tot_moms.resize(n_mom * pimpl->n_cell_tot);
+      for(auto &p : pimpl->particles)
+        for(int m = 0; m < n_mom; ++m)
+          thrust::copy(
+            p->pimpl->tmp_host_real_moms.begin() + m * p->pimpl->n_cell,
+            p->pimpl->tmp_host_real_moms.begin() + (m + 1) * p->pimpl->n_cell,
+            pimpl->real_n_cell_tot_moms.begin() + m * pimpl->n_cell_tot + p->pimpl->n_cell_bfr
+          );
+
+      std::vector<real_t*> res;
+      for(int m = 0; m < n_mom; ++m)
+        res.push_back(&pimpl->real_n_cell_tot_moms[m * pimpl->n_cell_tot]);
+      return res;
+    }
+
+    template <typename real_t>
+    std::vector<real_t> particles_t<real_t, multi_CUDA>::diag_moms_tot(
+      const std::vector<moms_req_t<real_t> > &reqs
+    )
+    {
+      std::vector<std::vector<real_t> > dev_res(this->opts_init->dev_count);
+      std::vector<std::thread> threads;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+      {
+        threads.emplace_back(
+          detail::set_device_and_run, i, 
+          [i, this, &dev_res, &reqs](){
+            dev_res[i] = this->pimpl->particles[i]->diag_moms_tot(reqs);
+          }
+        );
+      }
+      for (auto &th : threads) th.join();
+
+      // summed over all devices
+      std::vector<real_t> res(dev_res[0].size(), 0);
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        for (int m = 0; m < res.size(); ++m)
+          res[m] += dev_res[i][m];
       return res;
     }
 
@@ -172,7 +222,58 @@ namespace libcloudphxx
       // TODO: optimize this...
       for (int i = 0; i < this->opts_init->dev_count; ++i)
       {
-        res = add_puddle(res, futures[i].get());
+        res = detail::add_puddle(res, futures[i].get());
+      }
+      return res;
+    }
+
+    template <typename real_t>
+    cond_stats_t particles_t<real_t, multi_CUDA>::diag_cond_stats()
+    {
+      cond_stats_t res;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+      {
+        gpuErrchk(cudaSetDevice(i));
+        const cond_stats_t dev = this->pimpl->particles[i]->diag_cond_stats();
+        res.n_solve += dev.n_solve;
+        res.n_iter += dev.n_iter;
+        res.n_fallback += dev.n_fallback;
+        if (dev.n_iter_max > res.n_iter_max) res.n_iter_max = dev.n_iter_max;
+      }
+      return res;
+    }
+
+    // the table is the same on all devices
+    template <typename real_t>
+    kernel_tab_info_t particles_t<real_t, multi_CUDA>::diag_kernel_tab()
+    {
+      gpuErrchk(cudaSetDevice(0));
+      return this->pimpl->particles[0]->diag_kernel_tab();
+    }
+
+    template <typename real_t>
+    vt_tab_info_t particles_t<real_t, multi_CUDA>::diag_vt_tab()
+    {
+      gpuErrchk(cudaSetDevice(0));
+      return this->pimpl->particles[0]->diag_vt_tab();
+    }
+
+    // devices compute concurrently, hence the peaks are summed up
+    template <typename real_t>
+    workspace_info_t particles_t<real_t, multi_CUDA>::diag_workspace()
+    {
+      // a step started with step_async_begin() has to complete first
+      pimpl->async.wait();
+
+      workspace_info_t res;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+      {
+        gpuErrchk(cudaSetDevice(i));
+        const workspace_info_t dev = this->pimpl->particles[i]->diag_workspace();
+        res.reserved_bytes += dev.reserved_bytes;
+        res.resident_bytes += dev.resident_bytes;
+        res.n_alloc += dev.n_alloc;
+        for (auto &p : dev.peak_bytes) res.peak_bytes[p.first] += p.second;
       }
       return res;
     }
@@ -25,6 +25,9 @@ namespace libcloudphxx
       std::map<enum chem_species_t, arrinfo_t<real_t> > ambient_chem
     )
     {
+      // waiting for (and rethrowing errors of) a step started with step_async_begin()
+      pimpl->async.wait();
+
       pimpl->mcuda_run(&particles_t<real_t, CUDA>::step_sync, opts, th, rv, rhod, courant_1, courant_2, courant_3, ambient_chem);
     }
 
@@ -55,5 +58,33 @@ namespace libcloudphxx
       }
       for (auto &th : threads) th.join();
     }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_CUDA>::step_async_begin(
+      const opts_t<real_t> &opts
+    )
+    {
+      pimpl->async.wait();
+
+      // checked here and not only in step_async() to report it to the caller right away
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        if (!pimpl->particles[i]->pimpl->should_now_run_async)
+          throw std::runtime_error("please call step_sync() before calling step_async_begin()");
+
+      // opts copied, the caller may modify them while the step is running
+      pimpl->async.submit(std::bind(&particles_t<real_t, multi_CUDA>::step_async, this, opts));
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_CUDA>::step_async_wait()
+    {
+      pimpl->async.wait();
+    }
+
+    template <typename real_t>
+    bool particles_t<real_t, multi_CUDA>::step_async_pending()
+    {
+      return pimpl->async.pending();
+    }
   };
 };
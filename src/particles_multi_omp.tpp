@@ -0,0 +1,14 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  * @brief Thrust-based multi-slab OpenMP particle-tracking logic for Lagrangian microphysics
+  */
+
+#include "detail/multi_domain_utils.hpp"
+#include "impl_multi_omp/particles_multi_omp_impl.ipp"
+#include "impl_multi_omp/particles_multi_omp_impl_step_async_and_copy.ipp"
+#include "particles_multi_omp_ctor.ipp"
+#include "particles_multi_omp_diag.ipp"
+#include "particles_multi_omp_step.ipp"
@@ -0,0 +1,122 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  */
+
+// contains definitions of members of particles_t specialized for multiple OpenMP x-slabs
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    // constructor
+    template <typename real_t>
+    particles_t<real_t, multi_OpenMP>::particles_t(const opts_init_t<real_t> &_opts_init) 
+    {
+      pimpl.reset(new impl(_opts_init));
+  
+      // make opts_init point to global opts init
+      this->opts_init = &(pimpl->glob_opts_init);
+    }
+
+    // dtor
+    template <typename real_t>
+    particles_t<real_t, multi_OpenMP>::~particles_t() 
+    {
+      // a step started with step_async_begin() might still be running on pimpl
+      pimpl->async.stop();
+    }
+
+    // initialisation 
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::init(
+      const arrinfo_t<real_t> th,
+      const arrinfo_t<real_t> rv,
+      const arrinfo_t<real_t> rhod,
+      const arrinfo_t<real_t> courant_1,
+      const arrinfo_t<real_t> courant_2,
+      const arrinfo_t<real_t> courant_3,
+      const std::map<enum chem_species_t, const arrinfo_t<real_t> > ambient_chem
+    )
+    {
+      pimpl->momp_run(
+        &particles_t<real_t, OpenMP>::init,
+        th, rv, rhod, courant_1, courant_2, courant_3, ambient_chem
+      );
+    }
+
+    // restore, one file per slab
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::restore(
+      const std::string &path,
+      const arrinfo_t<real_t> th,
+      const arrinfo_t<real_t> rv,
+      const arrinfo_t<real_t> rhod,
+      const arrinfo_t<real_t> courant_1,
+      const arrinfo_t<real_t> courant_2,
+      const arrinfo_t<real_t> courant_3,
+      const std::map<enum chem_species_t, const arrinfo_t<real_t> > ambient_chem
+    )
+    {
+      std::vector<std::function<void()> > funs;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        funs.push_back([=, &path, &ambient_chem](){
+          this->pimpl->particles[i]->restore(path + "." + std::to_string(i), th, rv, rhod, courant_1, courant_2, courant_3, ambient_chem);
+        });
+      pimpl->run(funs);
+    }
+
+    // checkpoint, one file per slab
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::checkpoint(const std::string &path)
+    {
+      // a step started with step_async_begin() has to complete first
+      pimpl->async.wait();
+
+      std::vector<std::function<void()> > funs;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        funs.push_back([i, this, &path](){
+          this->pimpl->particles[i]->checkpoint(path + "." + std::to_string(i));
+        });
+      pimpl->run(funs);
+    }
+
+    // streaming output, one file per slab
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::snapshot_open(const std::string &path, const snapshot_opts_t &opts)
+    {
+      std::vector<std::function<void()> > funs;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        funs.push_back([i, this, &path, &opts](){
+          this->pimpl->particles[i]->snapshot_open(path + "." + std::to_string(i), opts);
+        });
+      pimpl->run(funs);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::snapshot()
+    {
+      // a step started with step_async_begin() has to complete first
+      pimpl->async.wait();
+
+      std::vector<std::function<void()> > funs;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        funs.push_back([i, this](){
+          this->pimpl->particles[i]->snapshot();
+        });
+      pimpl->run(funs);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::snapshot_close()
+    {
+      std::vector<std::function<void()> > funs;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        funs.push_back([i, this](){
+          this->pimpl->particles[i]->snapshot_close();
+        });
+      pimpl->run(funs);
+    }
+  };
+};
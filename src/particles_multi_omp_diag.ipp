@@ -0,0 +1,255 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  */
+
+
+// contains definitions of members of particles_t specialized for multiple OpenMP x-slabs
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    // diagnostic methods
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_RH()
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_RH);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_vel_div()
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_vel_div);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_sstp_coal()
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_sstp_coal);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_sd_conc()
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_sd_conc);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_dry_rng(
+      const real_t &r_mi, const real_t &r_mx
+    )
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_dry_rng, r_mi, r_mx);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_wet_rng(
+      const real_t &r_mi, const real_t &r_mx
+    )
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_wet_rng, r_mi, r_mx);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_dry_mom(const int &k)
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_dry_mom, k);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_wet_mom(const int &k)
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_wet_mom, k);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_wet_mass_dens(const real_t &a, const real_t &b)
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_wet_mass_dens, a, b);
+    }
+
+    // ...
+//</listing>
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_chem(const enum chem_species_t &spec)
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_chem, spec);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_rw_ge_rc()
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_rw_ge_rc);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_RH_ge_Sc()
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_RH_ge_Sc);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_all()
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_all);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_precip_rate()
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_precip_rate);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::diag_max_rw()
+    {
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::diag_max_rw);
+    }
+
+    template <typename real_t>
+    real_t* particles_t<real_t, multi_OpenMP>::outbuf()
+    {
+      // run fill_outbuf in each slab
+      std::vector<std::function<void()> > funs;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        funs.push_back(std::bind(
+          &particles_t<real_t, OpenMP>::impl::fill_outbuf,
+          &(*(pimpl->particles[i]->pimpl))
+        ));
+      pimpl->run(funs);
+
+      for(auto &p : pimpl->particles) // TODO: perform this copy in parallell?
+      {
+        thrust::copy(
+          p->pimpl->tmp_host_real_cell.begin(),
+          p->pimpl->tmp_host_real_cell.end(),
+          pimpl->real_n_cell_tot.begin() + p->pimpl->n_cell_bfr
+        );
+      }
+      return &(*(pimpl->real_n_cell_tot.begin()));
+    }
+
+    template <typename real_t>
+    std::vector<real_t*> particles_t<real_t, multi_OpenMP>::diag_moms(
+      const std::vector<moms_req_t<real_t> > &reqs
+    )
+    {
+      // run moms_batch in each slab
+      std::vector<std::function<void()> > funs;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        funs.push_back(std::bind(
+          &particles_t<real_t, OpenMP>::impl::moms_batch,
+          &(*(pimpl->particles[i]->pimpl)),
+          std::cref(reqs)
+        ));
+      pimpl->run(funs);
+
+      // gathering per-slab results, each moment in a separate n_cell_tot-long buffer
+      const int n_mom = pimpl->particles[0]->pimpl->tmp_host_real_moms.size() / pimpl->particles[0]->pimpl->n_cell;
+      pimpl->real_n_cell_tot_moms.resize(n_mom * pimpl->n_cell_tot);
+      for(auto &p : pimpl->particles)
+        for(int m = 0; m < n_mom; ++m)
+          thrust::copy(
+            p->pimpl->tmp_host_real_moms.begin() + m * p->pimpl->n_cell,
+            p->pimpl->tmp_host_real_moms.begin() + (m + 1) * p->pimpl->n_cell,
+            pimpl->real_n_cell_tot_moms.begin() + m * pimpl->n_cell_tot + p->pimpl->n_cell_bfr
+          );
+
+      std::vector<real_t*> res;
+      for(int m = 0; m < n_mom; ++m)
+        res.push_back(&pimpl->real_n_cell_tot_moms[m * pimpl->n_cell_tot]);
+      return res;
+    }
+
+    template <typename real_t>
+    std::vector<real_t> particles_t<real_t, multi_OpenMP>::diag_moms_tot(
+      const std::vector<moms_req_t<real_t> > &reqs
+    )
+    {
+      std::vector<std::vector<real_t> > dom_res(this->opts_init->dev_count);
+      std::vector<std::function<void()> > funs;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        funs.push_back([i, this, &dom_res, &reqs](){
+          dom_res[i] = this->pimpl->particles[i]->diag_moms_tot(reqs);
+        });
+      pimpl->run(funs);
+
+      // summed over all slabs
+      std::vector<real_t> res(dom_res[0].size(), 0);
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        for (int m = 0; m < res.size(); ++m)
+          res[m] += dom_res[i][m];
+      return res;
+    }
+
+    template <typename real_t>
+    std::map<output_t, real_t> particles_t<real_t, multi_OpenMP>::diag_puddle()
+    {
+      using pudmap_t = std::map<output_t, real_t>;
+      pudmap_t res = detail::empty_out_map<real_t>();
+
+      std::vector<pudmap_t> dom_res(this->opts_init->dev_count);
+      std::vector<std::function<void()> > funs;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        funs.push_back([i, this, &dom_res](){
+          dom_res[i] = this->pimpl->particles[i]->diag_puddle();
+        });
+      pimpl->run(funs);
+
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        res = detail::add_puddle(res, dom_res[i]);
+      return res;
+    }
+
+    template <typename real_t>
+    cond_stats_t particles_t<real_t, multi_OpenMP>::diag_cond_stats()
+    {
+      cond_stats_t res;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+      {
+        const cond_stats_t dev = this->pimpl->particles[i]->diag_cond_stats();
+        res.n_solve += dev.n_solve;
+        res.n_iter += dev.n_iter;
+        res.n_fallback += dev.n_fallback;
+        if (dev.n_iter_max > res.n_iter_max) res.n_iter_max = dev.n_iter_max;
+      }
+      return res;
+    }
+
+    // the table is the same in all slabs
+    template <typename real_t>
+    kernel_tab_info_t particles_t<real_t, multi_OpenMP>::diag_kernel_tab()
+    {
+      return this->pimpl->particles[0]->diag_kernel_tab();
+    }
+
+    template <typename real_t>
+    vt_tab_info_t particles_t<real_t, multi_OpenMP>::diag_vt_tab()
+    {
+      return this->pimpl->particles[0]->diag_vt_tab();
+    }
+
+    // slabs are computed concurrently, hence the peaks are summed up
+    template <typename real_t>
+    workspace_info_t particles_t<real_t, multi_OpenMP>::diag_workspace()
+    {
+      // a step started with step_async_begin() has to complete first
+      pimpl->async.wait();
+
+      workspace_info_t res;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+      {
+        const workspace_info_t dev = this->pimpl->particles[i]->diag_workspace();
+        res.reserved_bytes += dev.reserved_bytes;
+        res.resident_bytes += dev.resident_bytes;
+        res.n_alloc += dev.n_alloc;
+        for (auto &p : dev.peak_bytes) res.peak_bytes[p.first] += p.second;
+      }
+      return res;
+    }
+  };
+};
@@ -0,0 +1,86 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  */
+
+
+// contains definitions of members of particles_t specialized for multiple OpenMP x-slabs
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    // time-stepping methods
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::step_sync(
+      const opts_t<real_t> &opts,
+      arrinfo_t<real_t> th,
+      arrinfo_t<real_t> rv,
+      const arrinfo_t<real_t> rhod,
+      const arrinfo_t<real_t> courant_1,
+      const arrinfo_t<real_t> courant_2,
+      const arrinfo_t<real_t> courant_3,
+      std::map<enum chem_species_t, arrinfo_t<real_t> > ambient_chem
+    )
+    {
+      // waiting for (and rethrowing errors of) a step started with step_async_begin()
+      pimpl->async.wait();
+
+      pimpl->momp_run(&particles_t<real_t, OpenMP>::step_sync, opts, th, rv, rhod, courant_1, courant_2, courant_3, ambient_chem);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::step_async(
+      const opts_t<real_t> &opts
+    )
+    {
+      // sanity checks
+      if(opts.rcyc)
+        throw std::runtime_error("Particle recycling can't be used in the multi_OpenMP backend (it would consume whole memory quickly");
+
+      detail::barrier_t barrier(this->opts_init->dev_count);
+
+      // run in all slabs, a slab that fails releases the others waiting at the barrier
+      std::vector<std::function<void()> > funs;
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        funs.push_back(
+          [this, &opts, i, &barrier]()
+          {
+            try { pimpl->step_async_and_copy(opts, i, barrier); }
+            catch (...) { barrier.abort(); throw; }
+          }
+        );
+      pimpl->run(funs);
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::step_async_begin(
+      const opts_t<real_t> &opts
+    )
+    {
+      pimpl->async.wait();
+
+      // checked here and not only in step_async() to report it to the caller right away
+      for (int i = 0; i < this->opts_init->dev_count; ++i)
+        if (!pimpl->particles[i]->pimpl->should_now_run_async)
+          throw std::runtime_error("please call step_sync() before calling step_async_begin()");
+
+      // opts copied, the caller may modify them while the step is running
+      pimpl->async.submit(std::bind(&particles_t<real_t, multi_OpenMP>::step_async, this, opts));
+    }
+
+    template <typename real_t>
+    void particles_t<real_t, multi_OpenMP>::step_async_wait()
+    {
+      pimpl->async.wait();
+    }
+
+    template <typename real_t>
+    bool particles_t<real_t, multi_OpenMP>::step_async_pending()
+    {
+      return pimpl->async.pending();
+    }
+  };
+};
@@ -0,0 +1,39 @@
+// vim:filetype=cpp
+/** @file
+  * @copyright University of Warsaw
+  * @section LICENSE
+  * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+  * @brief streaming output of super-droplet attributes
+  */
+
+namespace libcloudphxx
+{
+  namespace lgrngn
+  {
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::snapshot_open(const std::string &path, const snapshot_opts_t &opts)
+    {
+      pimpl->snapshot_open(detail::mpi_path(path, pimpl->mpi_rank, pimpl->mpi_size), opts);
+    }
+
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::snapshot()
+    {
+      // a step started with step_async_begin() has to complete first
+      pimpl->async.wait();
+
+      if (!pimpl->init_called)
+        throw std::runtime_error("please call init() or restore() before snapshot()");
+      if (pimpl->should_now_run_async)
+        throw std::runtime_error("please call step_async() before snapshot()");
+
+      pimpl->snapshot();
+    }
+
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::snapshot_close()
+    {
+      pimpl->snapshot_close();
+    }
+  };
+};
@@ -23,6 +23,9 @@ namespace libcloudphxx
       std::map<enum chem_species_t, arrinfo_t<real_t> > ambient_chem
     )
     {
+      // waiting for (and rethrowing errors of) a step started with step_async_begin()
+      pimpl->async.wait();
+
       // sanity checks
       if (!pimpl->init_called)
         throw std::runtime_error("please call init() before calling step_sync()");
@@ -55,7 +58,7 @@ namespace libcloudphxx
         throw std::runtime_error("chemistry was switched off and ambient_chem is not empty");
 // </TODO>
 
-      if (pimpl->l2e[&pimpl->courant_x].size() == 0) // TODO: y, z,...
+      if (pimpl->l2e_courant_x.idx.size() == 0) // TODO: y, z,...
       {
         // TODO: many max or m1 used, unify it
 #if !defined(__NVCC__)
@@ -68,12 +71,14 @@ namespace libcloudphxx
       }
 
       // syncing in Eulerian fields (if not null)
-      pimpl->sync(th,             pimpl->th);
-      pimpl->sync(rv,             pimpl->rv);
+      pimpl->sync(th, rv, rhod); // in one pass if possible
       pimpl->sync(courant_x,      pimpl->courant_x);
       pimpl->sync(courant_y,      pimpl->courant_y);
       pimpl->sync(courant_z,      pimpl->courant_z);
-      pimpl->sync(rhod,           pimpl->rhod);
+
+      // x halo from the neighbouring ranks (done on all ranks, even if Courant numbers were not passed);
+      // only posted here, it is not needed before adve() in step_async()
+      if (pimpl->distmem_mpi()) pimpl->xchng_courants_mpi_post();
 
       nancheck(pimpl->th, " th after sync-in");
       nancheck(pimpl->rv, " rv after sync-in");
@@ -102,13 +107,16 @@ namespace libcloudphxx
       // condensation/evaporation 
       if (opts.cond) 
       {
+        detail::ws_stage stg(pimpl->ws, "cond");
+        pimpl->cond_stats = cond_stats_t();
+
         if(pimpl->opts_init.exact_sstp_cond && pimpl->opts_init.sstp_cond > 1)
         // apply substeps per-particle logic
         {
           for (int step = 0; step < pimpl->opts_init.sstp_cond; ++step) 
           {   
             pimpl->sstp_step_exact(step, !rhod.is_null());
-            pimpl->cond_sstp(pimpl->opts_init.dt / pimpl->opts_init.sstp_cond, opts.RH_max); 
+            pimpl->cond_sstp(pimpl->opts_init.dt / pimpl->opts_init.sstp_cond, opts.RH_max, step); 
           } 
           // copy sstp_tmp_rv and th to rv and th
           pimpl->update_state(pimpl->rv, pimpl->sstp_tmp_rv);
@@ -132,6 +140,7 @@ namespace libcloudphxx
       // TODO: chemistry substepping still done the old way, i.e. per cell not per particle
       if (opts.chem_dsl or opts.chem_dsc or opts.chem_rct) 
       {
+        detail::ws_stage stg(pimpl->ws, "chem");
         for (int step = 0; step < pimpl->opts_init.sstp_chem; ++step) 
         {   
           // calculate new volume of droplets (needed for chemistry)
@@ -182,6 +191,7 @@ namespace libcloudphxx
         // introduce new particles with the given time interval
         if(pimpl->stp_ctr == pimpl->opts_init.supstp_src) 
         {
+          detail::ws_stage stg(pimpl->ws, "src");
           pimpl->src(pimpl->opts_init.supstp_src * pimpl->opts_init.dt);
         }
       }
@@ -190,8 +200,7 @@ namespace libcloudphxx
       if(opts.cond || pimpl->stp_ctr == pimpl->opts_init.supstp_src)
       {
         // syncing out // TODO: this is not necesarry in off-line mode (see coupling with DALES)
-        pimpl->sync(pimpl->th, th);
-        pimpl->sync(pimpl->rv, rv);
+        pimpl->sync(th, rv); // in one pass if possible
         pimpl->stp_ctr = 0; //reset the counter
       }
 
@@ -220,6 +229,8 @@ namespace libcloudphxx
       pimpl->should_now_run_async = false;
 
       //sanity checks
+      if(opts.rcyc && pimpl->distmem_mpi())
+        throw std::runtime_error("Particle recycling can't be used in MPI runs (it would consume whole memory quickly");
       if((opts.chem_dsl || opts.chem_dsc || opts.chem_rct) && !pimpl->opts_init.chem_switch) throw std::runtime_error("all chemistry was switched off in opts_init");
       if(opts.coal && !pimpl->opts_init.coal_switch) throw std::runtime_error("all coalescence was switched off in opts_init");
       if(opts.sedi && !pimpl->opts_init.sedi_switch) throw std::runtime_error("all sedimentation was switched off in opts_init");
@@ -249,11 +260,15 @@ namespace libcloudphxx
 
       // updating terminal velocities
       if (opts.sedi || opts.coal)
+      {
+        detail::ws_stage stg(pimpl->ws, "vterm");
         pimpl->hskpng_vterm_all();
+      }
 
       // coalescence
-      if (opts.coal) 
+      if (opts.coal && !pimpl->opts_init.adaptive_sstp_coal) 
       {
+        detail::ws_stage stg(pimpl->ws, "coal");
         for (int step = 0; step < pimpl->opts_init.sstp_coal; ++step) 
         {
           // collide
@@ -272,14 +287,32 @@ namespace libcloudphxx
           *(pimpl->increase_sstp_coal) = false;
         }
       }
+      else if (opts.coal) 
+      {
+        detail::ws_stage stg(pimpl->ws, "coal");
+        // all substeps, each in the cells that have more substeps than the current one
+        // (dt is divided by the number of substeps in each cell)
+        pimpl->coal(pimpl->opts_init.dt);
+
+        // adjust the number of substeps in each cell for the next timestep
+        pimpl->hskpng_sstp_coal();
+      }
+
+      // Courant number halos posted in step_sync()
+      if (pimpl->distmem_mpi()) pimpl->xchng_courants_mpi_wait();
 
       // advection, it invalidates i,j,k and ijk!
-      if (opts.adve) pimpl->adve(); 
+      if (opts.adve) 
+      {
+        detail::ws_stage stg(pimpl->ws, "adve");
+        pimpl->adve(); 
+      }
 
       // sedimentation has to be done after advection, so that negative z doesnt crash hskpng_ijk in adve
       if (opts.sedi) 
       {
         // advection with terminal velocity
+        detail::ws_stage stg(pimpl->ws, "sedi");
         pimpl->sedi();
       }
 
@@ -288,7 +321,15 @@ namespace libcloudphxx
       // this has to be done last since i and k will be used by multi_gpu copy to other devices
       // TODO: instead of using i and k define new vectors ?
       // TODO: do this only if we advect/sediment?
-      pimpl->bcnd();
+      {
+        detail::ws_stage stg(pimpl->ws, "bcnd");
+        pimpl->bcnd();
+
+        // SDs that left the slab sent to the neighbouring ranks,
+        // the ones received are appended in step_finalize()
+        if (pimpl->distmem_mpi())
+          pimpl->xchng_sds_mpi_post();
+      }
 
       // some stuff to be done at the end of the step.
       // if using more than 1 GPU
@@ -298,5 +339,42 @@ namespace libcloudphxx
 
       pimpl->selected_before_counting = false;
     }
+
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::step_async_begin(
+      const opts_t<real_t> &opts
+    ) {
+      pimpl->async.wait();
+
+      // checked here and not only in step_async() to report it to the caller right away
+      if (!pimpl->should_now_run_async)
+        throw std::runtime_error("please call step_sync() before calling step_async_begin()");
+
+      // the worker thread communicates while the caller might too
+      if (pimpl->distmem_mpi() && !detail::mpi_thread_multiple())
+        throw std::runtime_error("step_async_begin() in MPI runs requires MPI initialised with MPI_THREAD_MULTIPLE");
+
+      // opts copied, the caller may modify them while the step is running
+      pimpl->async.submit([this, opts](){
+#if defined(__NVCC__)
+        // the worker is a separate host thread, which starts on the default device
+        if(pimpl->opts_init.dev_id >= 0)
+          cudaSetDevice(pimpl->opts_init.dev_id); // as in the ctor
+#endif
+        step_async(opts);
+      });
+    }
+
+    template <typename real_t, backend_t device>
+    void particles_t<real_t, device>::step_async_wait()
+    {
+      pimpl->async.wait();
+    }
+
+    template <typename real_t, backend_t device>
+    bool particles_t<real_t, device>::step_async_pending()
+    {
+      return pimpl->async.pending();
+    }
   };
 };
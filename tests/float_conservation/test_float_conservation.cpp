@@ -0,0 +1,79 @@
+// water mass conservation with float particle attributes: condensation in a parcel with
+// many SDs moves water between rv and the 3rd wet moment, their sum has to be conserved
+// up to the rounding of rv to float once per timestep (built with per-cell sums
+// accumulated in double, -DLIBCLOUDPHXX_ACC_T_DOUBLE=ON, see impl::acc_t)
+
+#include <libcloudph++/lgrngn/factory.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+using namespace libcloudphxx::lgrngn;
+
+typedef float real_t;
+
+struct lognormal : libcloudphxx::common::unary_function<real_t>
+{
+  real_t funval(const real_t lnr) const
+  {
+    const double mean_r = .04e-6 / 2, stdev = 1.4, n_tot = 100e6;
+    return n_tot * std::exp(
+      -std::pow(lnr - std::log(mean_r), 2) / 2 / std::pow(std::log(stdev), 2)
+    ) / std::log(stdev) / std::sqrt(2 * M_PI);
+  }
+};
+
+// vapour and liquid water mixing ratio
+double total_water(particles_proto_t<real_t> &prtcls, const real_t &rv)
+{
+  prtcls.diag_all();
+  prtcls.diag_wet_mom(3);
+  return rv + 4. / 3 * M_PI * 1e3 * prtcls.outbuf()[0];
+}
+
+int main()
+{
+  opts_init_t<real_t> opts_init;
+  opts_init.dt = 1;
+  opts_init.sd_conc = 1 << 16; // all in the one cell of the parcel
+  opts_init.n_sd_max = opts_init.sd_conc;
+  opts_init.dry_distros.emplace(real_t(.61), std::make_shared<lognormal>());
+
+  std::unique_ptr<particles_proto_t<real_t> > prtcls(factory<real_t>(serial, opts_init));
+
+  // supersaturated (RH of ca. 1.1)
+  real_t th = 300, rv = .0125, rhod = 1;
+  const std::vector<ptrdiff_t> strides(1, 1);
+  const arrinfo_t<real_t> th_ai(&th, strides), rv_ai(&rv, strides), rhod_ai(&rhod, strides);
+
+  prtcls->init(th_ai, rv_ai, rhod_ai);
+
+  opts_t<real_t> opts;
+  opts.adve = opts.sedi = opts.coal = false;
+  opts.cond = true;
+
+  const real_t rv_init = rv;
+  const double tot_init = total_water(*prtcls, rv);
+
+  const int n_steps = 20;
+  for (int it = 0; it < n_steps; ++it)
+  {
+    prtcls->step_sync(opts, th_ai, rv_ai, rhod_ai);
+    prtcls->step_async(opts);
+  }
+
+  const double tot = total_water(*prtcls, rv),
+               ulp = rv_init * std::numeric_limits<real_t>::epsilon(), // upper bound of one ulp of rv
+               tol = 2 * n_steps * ulp;
+
+  std::cerr << "rv: " << rv_init << " -> " << rv << ", total water: " << tot_init << " -> " << tot
+            << " (difference: " << tot - tot_init << ", tolerance: " << tol << ")" << std::endl;
+
+  // condensation did happen ...
+  if (!(rv_init - rv > 1e3 * ulp)) return 1;
+  // ... and water was conserved
+  if (!(std::abs(tot - tot_init) <= tol)) return 1;
+}
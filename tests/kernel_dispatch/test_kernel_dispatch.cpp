@@ -0,0 +1,95 @@
+// compares the cost of evaluating the collision kernel through a virtual call
+// (as done before the kernels were made non-polymorphic) with a direct call
+// resolved at compile time, as used now in the coalescence pass
+
+#include "lib.hpp"
+
+#include <thrust/system/cpp/execution_policy.h>
+#include <thrust/system/cpp/vector.h>
+namespace thrust_device = ::thrust::cpp;
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+#include <libcloudph++/lgrngn/particles.hpp>
+
+#include "detail/config.hpp"
+#include "detail/thrust.hpp"
+#include "detail/kernel_utils.hpp"
+#include "detail/tpl_calc_wrapper.hpp"
+#include "detail/kernels.hpp"
+
+using namespace libcloudphxx::lgrngn;
+
+typedef double real_t;
+typedef unsigned long long n_t;
+typedef tpl_calc_wrap<real_t, n_t> wrap_t;
+
+// emulates the former kernel_base with a virtual calc()
+struct virtual_kernel_base
+{
+  virtual real_t calc(const wrap_t &) const = 0;
+  virtual ~virtual_kernel_base() {}
+};
+
+template <class kernel_T>
+struct virtual_kernel : virtual_kernel_base
+{
+  kernel_T kernel;
+  virtual_kernel(const kernel_T &kernel) : kernel(kernel) {}
+  real_t calc(const wrap_t &tpl_wrap) const { return kernel.calc(tpl_wrap); }
+};
+
+template <class kernel_T>
+real_t sum_static(const kernel_T &kernel, const std::vector<wrap_t> &pairs)
+{
+  real_t sum = 0;
+  for (std::size_t i = 0; i < pairs.size(); ++i) sum += kernel.calc(pairs[i]);
+  return sum;
+}
+
+// noinline so that the compiler cannot devirtualise the call
+__attribute__((noinline))
+real_t sum_virtual(const virtual_kernel_base *p_kernel, const std::vector<wrap_t> &pairs)
+{
+  real_t sum = 0;
+  for (std::size_t i = 0; i < pairs.size(); ++i) sum += p_kernel->calc(pairs[i]);
+  return sum;
+}
+
+int main()
+{
+  const std::size_t n_pair = 1 << 20;
+  const int n_rep = 10;
+
+  std::vector<wrap_t> pairs;
+  pairs.reserve(n_pair);
+  for (std::size_t i = 0; i < n_pair; ++i)
+  {
+    const real_t rw2_a = std::pow(1e-6 * (1 + i % 97), 2), rw2_b = std::pow(1e-6 * (1 + i % 89), 2);
+    pairs.push_back(wrap_t(
+      thrust::make_tuple(n_t(1 + i % 7), n_t(1 + i % 5), rw2_a, rw2_b, real_t(1e-2 * (i % 13)), real_t(1e-2 * (i % 11)), real_t(0), real_t(0)),
+      thrust::make_tuple(real_t(1), real_t(1.8e-5))
+    ));
+  }
+
+  kernel_geometric<real_t, n_t> kernel;
+  virtual_kernel<kernel_geometric<real_t, n_t> > v_kernel(kernel);
+
+  typedef std::chrono::high_resolution_clock clock;
+  real_t res_static = 0, res_virtual = 0;
+
+  clock::time_point t0 = clock::now();
+  for (int r = 0; r < n_rep; ++r) res_static += sum_static(kernel, pairs);
+  clock::time_point t1 = clock::now();
+  for (int r = 0; r < n_rep; ++r) res_virtual += sum_virtual(&v_kernel, pairs);
+  clock::time_point t2 = clock::now();
+
+  std::cerr << "static dispatch:  " << std::chrono::duration<double>(t1 - t0).count() << " s" << std::endl;
+  std::cerr << "virtual dispatch: " << std::chrono::duration<double>(t2 - t1).count() << " s" << std::endl;
+
+  // both paths have to give identical results
+  if (res_static != res_virtual) throw std::runtime_error("static and virtual dispatch results differ");
+}
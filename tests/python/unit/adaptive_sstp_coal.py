@@ -0,0 +1,89 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+from math import exp, log, sqrt, pi
+import numpy as np
+
+def expvolumelnr(lnr):  
+  r_zero = 30.531e-6
+  n_zero = pow(2,8)
+  r=np.exp(lnr)
+  return n_zero * 3.*np.power(r,3)/np.power(r_zero,3)*np.exp(- np.power((r/r_zero),3));
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dt = pow(2,12)
+opts_init.sstp_coal = 1 
+opts_init.adaptive_sstp_coal = True
+opts_init.dry_distros = {.1:expvolumelnr}
+opts_init.sd_conc = 64
+opts_init.n_sd_max = 64 * 2
+opts_init.nx = 2
+opts_init.dx = 1
+opts_init.x1 = opts_init.nx * opts_init.dx
+opts_init.kernel = lgrngn.kernel_t.geometric
+opts_init.terminal_velocity = lgrngn.vt_t.beard77fast
+opts_init.sedi_switch = False
+
+rhod = np.ones((opts_init.nx,))
+th = 300. * np.ones((opts_init.nx,))
+rv = 0.01 * np.ones((opts_init.nx,))
+C = np.ones((opts_init.nx + 1,))
+
+opts = lgrngn.opts_t()
+opts.adve = False
+opts.sedi = False
+opts.cond = False
+opts.coal = True
+
+def run(opts_init):
+  global prtcls
+  prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+  prtcls.init(th, rv, rhod, C)
+
+  m3_init = dry_mom3()
+  assert (sstp_coal() == opts_init.sstp_coal).all()
+
+  sstp_max = 1
+  for it in range(10):
+    prtcls.step_sync(opts, th, rv)
+    prtcls.step_async(opts)
+    sstp = sstp_coal()
+    print sstp
+    assert (sstp >= 1).all()
+    assert (sstp <= opts_init.sstp_coal_max).all()
+    assert (sstp == np.floor(sstp)).all()
+    sstp_max = max(sstp_max, sstp.max())
+
+  # coalescence conserves dry mass in each cell
+  assert np.allclose(dry_mom3(), m3_init, rtol=1e-10, atol=0)
+
+  # global sstp_coal is not touched
+  assert prtcls.opts_init.sstp_coal == 1
+
+  return sstp_max
+
+def dry_mom3():
+  prtcls.diag_all()
+  prtcls.diag_dry_mom(3)
+  return np.frombuffer(prtcls.outbuf()).copy()
+
+def sstp_coal():
+  prtcls.diag_sstp_coal()
+  return np.frombuffer(prtcls.outbuf()).copy()
+
+# large timestep - collision probabilities exceed one without substepping
+sstp_max = run(opts_init)
+assert sstp_max > 1
+
+# the number of substeps in a cell is capped
+opts_init.sstp_coal_max = 1
+assert run(opts_init) == 1
+
+# ... not below the initial one
+opts_init.sstp_coal = 2
+try:
+  lgrngn.factory(lgrngn.backend_t.serial, opts_init).init(th, rv, rhod, C)
+  raise Exception("sstp_coal_max < sstp_coal not detected")
+except RuntimeError as e:
+  print e
@@ -0,0 +1,75 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+
+import numpy as np
+from math import exp, log, sqrt, pi
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev  = 1.4
+  n_tot  = 60e6
+  return n_tot * exp(
+    -pow((lnr - log(mean_r)), 2) / 2 / pow(log(stdev),2)
+  ) / log(stdev) / sqrt(2*pi);
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dry_distros = {.61:lognormal}
+opts_init.coal_switch = False
+opts_init.sedi_switch = False
+opts_init.dt = 1
+opts_init.sd_conc = 64
+opts_init.n_sd_max = 64 * 2
+opts_init.nx = 2
+opts_init.dx = 1
+opts_init.x1 = opts_init.nx * opts_init.dx
+opts_init.rng_seed = 396
+opts_init.exact_sstp_cond = True
+opts_init.sstp_cond = 10
+
+opts = lgrngn.opts_t()
+opts.adve = False
+opts.sedi = False
+opts.coal = False
+opts.cond = True
+
+rhod = np.ones(opts_init.nx)
+C    = np.ones(opts_init.nx + 1)
+
+def run(adaptive):
+  opts_init.adaptive_sstp_cond = adaptive
+  prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+  th = np.array([300., 300.])
+  rv = np.array([.0025, .0095]) # first cell subsaturated, second supersaturated
+  prtcls.init(th, rv, rhod, C)
+
+  prtcls.diag_all()
+  prtcls.diag_wet_mom(3)
+  water_init = 1000. * 4./3. * pi * np.frombuffer(prtcls.outbuf()).copy() + rv
+
+  n_solve = 0
+  for it in range(20):
+    # perturb the vapour field to keep the particles out of equilibrium
+    rv[1] += 1e-4
+    prtcls.step_sync(opts, th, rv)
+    prtcls.step_async(opts)
+    n_solve += prtcls.diag_cond_stats().n_solve
+
+  prtcls.diag_all()
+  prtcls.diag_wet_mom(3)
+  m3 = np.frombuffer(prtcls.outbuf()).copy()
+  water = 1000. * 4./3. * pi * m3 + rv
+  water[1] -= 20 * 1e-4
+  # condensation conserves total water regardless of the number of substeps of each SD
+  assert np.allclose(water, water_init, atol=0, rtol=1e-8)
+  return m3, rv.copy(), n_solve
+
+ref_m3, ref_rv, ref_n_solve = run(False)
+res_m3, res_rv, res_n_solve = run(True)
+print 'SD condensation steps: ' + str(ref_n_solve) + ' (fixed) vs. ' + str(res_n_solve) + ' (adaptive)'
+
+assert ref_n_solve == 20 * 2 * opts_init.sd_conc * opts_init.sstp_cond
+assert res_n_solve < ref_n_solve
+assert np.allclose(res_m3, ref_m3, rtol=1e-2, atol=0)
+assert np.allclose(res_rv, ref_rv, rtol=1e-3, atol=0)
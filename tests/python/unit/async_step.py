@@ -0,0 +1,105 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+import numpy as np
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev = 1.4
+  n_tot = 60e6
+  return n_tot * np.exp(
+    -pow((lnr - np.log(mean_r)), 2) / 2 / pow(np.log(stdev),2)
+  ) / np.log(stdev) / np.sqrt(2*np.pi);
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dt = 1
+opts_init.nx = 4
+opts_init.nz = 4
+opts_init.dx = 100
+opts_init.dz = 100
+opts_init.x1 = 400
+opts_init.z1 = 400
+opts_init.dry_distros = {.61:lognormal}
+opts_init.sd_conc = 32
+opts_init.n_sd_max = 32 * 16
+
+opts = lgrngn.opts_t()
+opts.adve = False
+opts.sedi = True
+opts.cond = True
+opts.coal = True
+
+def run(backend, use_async):
+  rhod = 1. * np.ones((opts_init.nx, opts_init.nz))
+  th = 300. * np.ones((opts_init.nx, opts_init.nz))
+  rv = 0.0105 * np.ones((opts_init.nx, opts_init.nz))
+  Cx = np.zeros((opts_init.nx + 1, opts_init.nz))
+  Cz = np.zeros((opts_init.nx, opts_init.nz + 1))
+
+  prtcls = lgrngn.factory(backend, opts_init)
+  prtcls.init(th, rv, rhod, Cx=Cx, Cz=Cz)
+
+  for it in range(20):
+    prtcls.step_sync(opts, th, rv, rhod) # waits for the previous step_async_begin()
+    if use_async:
+      prtcls.step_async_begin(opts)
+      # the Eulerian fields may be modified while particles are being processed
+      th += .001
+      # nothing pending once the step was waited for (step_sync() would wait anyhow)
+      if it % 2 == 0:
+        prtcls.step_async_wait()
+        assert not prtcls.step_async_pending()
+    else:
+      prtcls.step_async(opts)
+      th += .001
+
+  if use_async:
+    prtcls.step_async_wait()
+    assert not prtcls.step_async_pending()
+  prtcls.diag_all()
+  prtcls.diag_wet_mom(3)
+  return np.frombuffer(prtcls.outbuf()).copy(), rv
+
+for backend in [lgrngn.backend_t.serial, lgrngn.backend_t.OpenMP]:
+  try:
+    m3_sync, rv_sync = run(backend, False)
+  except RuntimeError: # e.g. OpenMP backend not compiled
+    continue
+  m3_async, rv_async = run(backend, True)
+  print backend, m3_sync.sum(), m3_async.sum()
+
+  # same sequence of operations -> same result
+  assert (m3_sync == m3_async).all()
+  assert (rv_sync == rv_async).all()
+
+# step_async_begin() without a preceding step_sync() is reported right away
+rhod = 1. * np.ones((1,))
+th = 300. * np.ones((1,))
+rv = 0.01 * np.ones((1,))
+opts_init = lgrngn.opts_init_t()
+opts_init.dt = 1
+opts_init.dry_distros = {.61:lognormal}
+opts_init.sd_conc = 32
+opts_init.n_sd_max = 32
+opts_init.coal_switch = False
+prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+prtcls.init(th, rv, rhod)
+try:
+  prtcls.step_async_begin(opts)
+  raise Exception("step_async_begin() before step_sync() not reported!")
+except RuntimeError:
+  pass
+
+# errors thrown on the worker thread are rethrown by step_async_wait()
+assert opts.coal # coalescence switched off in opts_init
+prtcls.step_sync(opts, th, rv)
+prtcls.step_async_begin(opts)
+try:
+  prtcls.step_async_wait()
+  raise Exception("error in the async step not reported!")
+except RuntimeError:
+  pass
+
+# ... once
+prtcls.step_async_wait()
@@ -0,0 +1,165 @@
+import sys, os
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+import numpy as np
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev = 1.4
+  n_tot = 60e6
+  return n_tot * np.exp(
+    -pow((lnr - np.log(mean_r)), 2) / 2 / pow(np.log(stdev),2)
+  ) / np.log(stdev) / np.sqrt(2*np.pi);
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dt = 1
+opts_init.nx = 4
+opts_init.nz = 4
+opts_init.dx = 100
+opts_init.dz = 100
+opts_init.x1 = 400
+opts_init.z1 = 400
+opts_init.dry_distros = {.61:lognormal}
+opts_init.sd_conc = 32
+opts_init.n_sd_max = 32 * 16
+opts_init.sstp_cond = 2
+opts_init.sstp_coal = 2
+
+opts = lgrngn.opts_t()
+opts.adve = True
+opts.sedi = True
+opts.cond = True
+opts.coal = True
+opts.rcyc = True
+
+path = "checkpoint.bin"
+
+rhod = 1. * np.ones((opts_init.nx, opts_init.nz))
+Cx = .2 * np.ones((opts_init.nx + 1, opts_init.nz))
+Cz = np.zeros((opts_init.nx, opts_init.nz + 1))
+
+def diag(prtcls, chem):
+  res = []
+  for mom in [0, 1, 3]:
+    prtcls.diag_all()
+    prtcls.diag_wet_mom(mom)
+    res.append(np.frombuffer(prtcls.outbuf()).copy())
+  prtcls.diag_all()
+  prtcls.diag_sd_conc()
+  res.append(np.frombuffer(prtcls.outbuf()).copy())
+  for spec in chem:
+    prtcls.diag_all()
+    prtcls.diag_chem(spec)
+    res.append(np.frombuffer(prtcls.outbuf()).copy())
+  return res
+
+def steps(prtcls, opts, th, rv, ambient_chem, n):
+  for it in range(n):
+    prtcls.step_sync(opts, th, rv, rhod, Cx=Cx, Cz=Cz, ambient_chem=ambient_chem)
+    prtcls.step_async(opts)
+
+# runs, checkpoints, restarts and continues both runs side by side
+def restart(backend, opts_init, opts, ambient_chem = {}, chem = []):
+  prtcls = lgrngn.factory(backend, opts_init)
+
+  th = 300. * np.ones((opts_init.nx, opts_init.nz))
+  rv = 0.0105 * np.ones((opts_init.nx, opts_init.nz))
+  prtcls.init(th, rv, rhod, Cx=Cx, Cz=Cz, ambient_chem=ambient_chem)
+  steps(prtcls, opts, th, rv, ambient_chem, 10)
+
+  # checkpoint together with a copy of the Eulerian state
+  prtcls.checkpoint(path)
+  th_ckpt, rv_ckpt = th.copy(), rv.copy()
+  ambient_chem_ckpt = dict((k, v.copy()) for k, v in ambient_chem.iteritems())
+
+  # restart, continued in parallel with the original run
+  restarted = lgrngn.factory(backend, opts_init)
+  restarted.restore(path, th_ckpt, rv_ckpt, rhod, Cx=Cx, Cz=Cz, ambient_chem=ambient_chem_ckpt)
+
+  for a, b in zip(diag(prtcls, chem), diag(restarted, chem)):
+    assert (a == b).all()
+  assert prtcls.diag_puddle() == restarted.diag_puddle()
+
+  steps(prtcls, opts, th, rv, ambient_chem, 10)
+  steps(restarted, opts, th_ckpt, rv_ckpt, ambient_chem_ckpt, 10)
+
+  # same state and same random numbers -> bit-identical results
+  for a, b in zip(diag(prtcls, chem), diag(restarted, chem)):
+    print backend, a.sum(), b.sum()
+    assert (a == b).all()
+  assert (th == th_ckpt).all()
+  assert (rv == rv_ckpt).all()
+  for k in ambient_chem:
+    assert (ambient_chem[k] == ambient_chem_ckpt[k]).all()
+  assert prtcls.diag_puddle() == restarted.diag_puddle()
+
+  return prtcls, th, rv
+
+for backend in [lgrngn.backend_t.serial, lgrngn.backend_t.OpenMP]:
+  try:
+    lgrngn.factory(backend, opts_init)
+  except RuntimeError: # e.g. OpenMP backend not compiled
+    continue
+
+  prtcls, th, rv = restart(backend, opts_init, opts)
+
+  # per-cell coalescence substep counts are part of the state
+  opts_init.adaptive_sstp_coal = True
+  restart(backend, opts_init, opts)
+  opts_init.adaptive_sstp_coal = False
+
+  # chemistry: per-particle chemical composition and the gas phase
+  opts_init.chem_switch = True
+  opts_init.chem_rho = 1.8e-3
+  opts_init.sstp_chem = 2
+  opts.chem_dsl = True
+  opts.chem_dsc = True
+  opts.chem_rct = True
+  ambient_chem = dict(
+    (v, mixr * np.ones((opts_init.nx, opts_init.nz))) for v, mixr in [
+      (lgrngn.chem_species_t.SO2,  .2e-9 * 64 / 28.9),
+      (lgrngn.chem_species_t.O3,   50e-9 * 48 / 28.9),
+      (lgrngn.chem_species_t.H2O2, .5e-9 * 34 / 28.9),
+      (lgrngn.chem_species_t.CO2,  360e-6 * 44 / 28.9),
+      (lgrngn.chem_species_t.NH3,  .1e-9 * 17 / 28.9),
+      (lgrngn.chem_species_t.HNO3, .1e-9 * 63 / 28.9)
+    ]
+  )
+  chem = [lgrngn.chem_species_t.SO2, lgrngn.chem_species_t.H, lgrngn.chem_species_t.NH3, lgrngn.chem_species_t.S_VI]
+  restart(backend, opts_init, opts, ambient_chem, chem)
+  opts_init.chem_switch = False
+  opts.chem_dsl = False
+  opts.chem_dsc = False
+  opts.chem_rct = False
+
+  # checkpoint() between step_sync() and step_async() is reported
+  prtcls.checkpoint(path) # without chemistry, restored on another grid below
+  prtcls.step_sync(opts, th, rv, rhod, Cx=Cx, Cz=Cz)
+  try:
+    prtcls.checkpoint(path)
+    raise Exception("checkpoint() after step_sync() not reported")
+  except RuntimeError:
+    pass
+
+  # restoring on a different grid is reported
+  opts_init_other = lgrngn.opts_init_t()
+  opts_init_other.dt = 1
+  opts_init_other.nx = 2
+  opts_init_other.nz = 4
+  opts_init_other.dx = 200
+  opts_init_other.dz = 100
+  opts_init_other.x1 = 400
+  opts_init_other.z1 = 400
+  opts_init_other.dry_distros = {.61:lognormal}
+  opts_init_other.sd_conc = 32
+  opts_init_other.n_sd_max = 32 * 8
+  other = lgrngn.factory(backend, opts_init_other)
+  try:
+    shp = (opts_init_other.nx, opts_init_other.nz)
+    other.restore(path, 300. * np.ones(shp), .01 * np.ones(shp), np.ones(shp))
+    raise Exception("grid mismatch not reported")
+  except RuntimeError:
+    pass
+
+  os.remove(path)
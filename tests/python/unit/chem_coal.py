@@ -87,3 +87,27 @@ assert np.isclose(H_init, H_final, atol=0., rtol=eps),\
 
 assert np.isclose(S_VI_init, S_VI_final, atol=0., rtol=eps),\
   "total amount of S_VI is not conserved during coalescence"
+
+# the same with recycling of the SDs removed in coalescence (chem of the split SDs copied)
+prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+prtcls.init(th, rv, rhod, ambient_chem = ambient_chem)
+Opts.rcyc = True
+
+def diag_chem_all():
+  res = []
+  prtcls.diag_all()
+  for spec in [lgrngn.chem_species_t.NH3, lgrngn.chem_species_t.H, lgrngn.chem_species_t.S_VI]:
+    prtcls.diag_chem(spec)
+    res.append(np.frombuffer(prtcls.outbuf())[0])
+  return res
+
+chem_init = diag_chem_all()
+
+for i in range(300):
+  prtcls.step_sync(Opts,th,rv,rhod, ambient_chem=ambient_chem)
+  prtcls.step_async(Opts)
+
+chem_final = diag_chem_all()
+
+assert np.allclose(chem_init, chem_final, atol=0., rtol=eps),\
+  "total amount of chem is not conserved during coalescence with recycling"
@@ -0,0 +1,77 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+
+import numpy as np
+from math import exp, log, sqrt, pi
+from time import time
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev  = 1.4
+  n_tot  = 60e6
+  return n_tot * exp(
+    -pow((lnr - log(mean_r)), 2) / 2 / pow(log(stdev),2)
+  ) / log(stdev) / sqrt(2*pi);
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dry_distros = {.61:lognormal}
+opts_init.coal_switch = False
+opts_init.sedi_switch = False
+opts_init.dt = 1
+opts_init.sd_conc = 64
+opts_init.n_sd_max = 64 * 2
+opts_init.nx = 2
+opts_init.dx = 1
+opts_init.x1 = opts_init.nx * opts_init.dx
+opts_init.rng_seed = 396
+
+opts = lgrngn.opts_t()
+opts.adve = False
+opts.sedi = False
+opts.coal = False
+opts.cond = True
+
+rhod = np.ones(opts_init.nx)
+C    = np.ones(opts_init.nx + 1)
+
+def run(cond_solver, exact_sstp_cond, sstp_cond):
+  opts_init.cond_solver = cond_solver
+  opts_init.exact_sstp_cond = exact_sstp_cond
+  opts_init.sstp_cond = sstp_cond
+  prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+  th = np.array([300., 300.])
+  rv = np.array([.0025, .0095]) # first cell subsaturated, second supersaturated
+  prtcls.init(th, rv, rhod, C)
+  n_iter = 0
+  n_solve = 0
+  mean_iter = [] # per step
+  t0 = time()
+  for it in range(20):
+    prtcls.step_sync(opts, th, rv)
+    prtcls.step_async(opts)
+    stats = prtcls.diag_cond_stats()
+    assert stats.n_solve == 2 * opts_init.sd_conc * sstp_cond
+    assert stats.n_iter_max <= stats.n_iter
+    n_iter += stats.n_iter
+    n_solve += stats.n_solve
+    mean_iter.append(float(stats.n_iter) / stats.n_solve)
+  print 'time: ' + str(time() - t0) + ' s, mean iterations per solve: ' + str(float(n_iter) / n_solve) + ', fallbacks in last step: ' + str(stats.n_fallback)
+  prtcls.diag_all()
+  prtcls.diag_wet_mom(3)
+  return np.frombuffer(prtcls.outbuf()).copy(), rv.copy(), stats, mean_iter
+
+for exact_sstp_cond, sstp_cond in [(False, 1), (False, 5), (True, 5)]:
+  print 'exact_sstp_cond = ' + str(exact_sstp_cond) + ', sstp_cond = ' + str(sstp_cond)
+  ref_m3, ref_rv, ref_stats, ref_iter = run(lgrngn.cond_solver_t.toms748, exact_sstp_cond, sstp_cond)
+  assert ref_stats.n_fallback == 0
+  res_m3, res_rv, res_stats, res_iter = run(lgrngn.cond_solver_t.newton, exact_sstp_cond, sstp_cond)
+
+  # both solvers converge to the same implicit Euler solution (up to the solver tolerance)
+  assert np.allclose(res_m3, ref_m3, rtol=1e-4, atol=0)
+  assert np.allclose(res_rv, ref_rv, rtol=1e-6, atol=0)
+
+  # Newton started from the increment of the previous step (none in the first one)
+  # needs no more iterations once the drops approach equilibrium
+  assert res_iter[-1] <= res_iter[0]
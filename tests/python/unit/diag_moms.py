@@ -0,0 +1,86 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+
+import numpy as np
+from math import exp, log, sqrt, pi
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev  = 1.4
+  n_tot  = 60e6
+  return n_tot * exp(
+    -pow((lnr - log(mean_r)), 2) / 2 / pow(log(stdev),2)
+  ) / log(stdev) / sqrt(2*pi);
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dry_distros = {.61:lognormal, 1.28:lognormal}
+opts_init.coal_switch = False
+opts_init.sedi_switch = False
+opts_init.dt = 1
+opts_init.sd_conc = 64
+opts_init.n_sd_max = 64 * 8
+opts_init.nx = 2
+opts_init.nz = 4
+opts_init.dx = 1
+opts_init.dz = 1
+opts_init.x1 = opts_init.nx * opts_init.dx
+opts_init.z1 = opts_init.nz * opts_init.dz
+
+rhod = np.ones((opts_init.nx, opts_init.nz))
+th = 300. * np.ones((opts_init.nx, opts_init.nz))
+rv = .01 * np.ones((opts_init.nx, opts_init.nz))
+
+prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+prtcls.init(th, rv, rhod)
+
+def req(rng_attr, rng_min, rng_max, mom_attr, moms):
+  r = lgrngn.moms_req_t()
+  r.rng_attr = rng_attr
+  r.rng_min = rng_min
+  r.rng_max = rng_max
+  r.mom_attr = mom_attr
+  r.moms = moms
+  return r
+
+reqs = [
+  req(lgrngn.attr_t.rd, 0, 1, lgrngn.attr_t.rd, [0, 1, 3]),
+  req(lgrngn.attr_t.rw, 1e-8, 1e-6, lgrngn.attr_t.rw, [0, 3]),
+  req(lgrngn.attr_t.rd, 1e-8, 1, lgrngn.attr_t.rw, [3]),
+  req(lgrngn.attr_t.kappa, 1, 2, lgrngn.attr_t.kappa, [1])
+]
+
+# reference values from the one-moment-at-a-time API
+ref = []
+for k in [0, 1, 3]:
+  prtcls.diag_dry_rng(0, 1)
+  prtcls.diag_dry_mom(k)
+  ref.append(np.frombuffer(prtcls.outbuf()).copy())
+for k in [0, 3]:
+  prtcls.diag_wet_rng(1e-8, 1e-6)
+  prtcls.diag_wet_mom(k)
+  ref.append(np.frombuffer(prtcls.outbuf()).copy())
+prtcls.diag_dry_rng(1e-8, 1)
+prtcls.diag_wet_mom(3)
+ref.append(np.frombuffer(prtcls.outbuf()).copy())
+prtcls.diag_kappa_rng(1, 2)
+prtcls.diag_kappa_mom(1)
+ref.append(np.frombuffer(prtcls.outbuf()).copy())
+
+res = [np.frombuffer(buf).copy() for buf in prtcls.diag_moms(reqs)]
+
+assert len(res) == len(ref)
+for r, f in zip(res, ref):
+  print r
+  assert np.allclose(r, f, atol=0, rtol=1e-10)
+
+# empty request list
+assert len(prtcls.diag_moms([])) == 0
+
+# domain totals, i.e. specific moments times the dry air mass in each cell (dv=1)
+tot = prtcls.diag_moms_tot(reqs)
+assert len(tot) == len(ref)
+for t, f in zip(tot, ref):
+  print t
+  assert np.isclose(t, (f * rhod.flatten()).sum(), atol=0, rtol=1e-10)
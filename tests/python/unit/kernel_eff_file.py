@@ -0,0 +1,86 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+import numpy as np
+import tempfile
+import os
+
+rhod = 1. * np.ones((1,))
+th = 300. * np.ones((1,))
+rv = 0.01 * np.ones((1,))
+
+def expvolumelnr(lnr):  
+  r_zero = 30.531e-6
+  n_zero = pow(2,23)
+  r=np.exp(lnr)
+  return n_zero * 3.*np.power(r,3)/np.power(r_zero,3)*np.exp(- np.power((r/r_zero),3));
+
+Opts = lgrngn.opts_t()
+Opts.adve = False
+Opts.sedi = False
+Opts.cond = False
+Opts.coal = True
+
+def run(kernel, eff_file = ""):
+  opts_init = lgrngn.opts_init_t()
+  opts_init.dt = 10
+  opts_init.dry_distros = {.1:expvolumelnr}
+  opts_init.sd_conc = 256
+  opts_init.n_sd_max = 256
+  opts_init.terminal_velocity=lgrngn.vt_t.beard76
+  opts_init.kernel = kernel
+  opts_init.kernel_parameters = np.array([])
+  opts_init.kernel_eff_file = eff_file
+
+  prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+  prtcls.init(th, rv, rhod)
+  for it in range(10):
+    prtcls.step_sync(Opts,th,rv,rhod)
+    prtcls.step_async(Opts)
+  prtcls.diag_all()
+  prtcls.diag_wet_mom(0)
+  return np.frombuffer(prtcls.outbuf()).copy()
+
+# unit efficiencies up to 1100um (the geometric kernel), comma- and whitespace-separated
+n = 201
+f = tempfile.NamedTemporaryFile(suffix=".txt")
+f.write(", ".join(["1"] * (n * (n+1) / 2 - 10)) + "\n" + " ".join(["1"] * 10))
+f.flush()
+
+m0_geom = run(lgrngn.kernel_t.geometric)
+m0_file = run(lgrngn.kernel_t.hall, f.name)
+m0_hall = run(lgrngn.kernel_t.hall)
+print m0_geom, m0_file, m0_hall
+
+# same seed, same kernel
+assert np.allclose(m0_file, m0_geom, rtol=1e-6)
+# the built-in efficiencies are smaller than one for small droplets, i.e. less coalescence
+assert m0_hall > m0_file
+
+# the built-in table is kept in double precision: the same numbers read from a file
+# (parsed as real_t) give bit-identical results
+src = open(os.path.join(os.path.dirname(os.path.abspath(__file__)), "../../../src/detail/kernel_definitions/hall_efficiencies.hpp")).read()
+h = tempfile.NamedTemporaryFile(suffix=".txt")
+h.write(src[src.index("[] = {") + 6 : src.index("};")])
+h.flush()
+m0_hall_file = run(lgrngn.kernel_t.hall, h.name)
+print m0_hall, m0_hall_file
+assert (m0_hall_file == m0_hall).all()
+
+# a table that is not a lower triangle of a square matrix
+g = tempfile.NamedTemporaryFile(suffix=".txt")
+g.write(" ".join(["1"] * 7))
+g.flush()
+try:
+  run(lgrngn.kernel_t.hall, g.name)
+  raise Exception("malformed efficiency file accepted")
+except RuntimeError:
+  pass
+
+# missing file
+try:
+  run(lgrngn.kernel_t.hall, "/nonexistent/efficiencies.txt")
+  raise Exception("missing efficiency file accepted")
+except RuntimeError:
+  pass
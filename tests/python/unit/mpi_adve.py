@@ -0,0 +1,88 @@
+# meant to be run with mpirun (e.g. -np 4), but works as a single-rank run as well
+import sys, os
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+import numpy as np
+from math import exp, log, sqrt, pi
+
+rank    = int(os.environ.get("OMPI_COMM_WORLD_RANK", os.environ.get("PMI_RANK", 0)))
+n_ranks = int(os.environ.get("OMPI_COMM_WORLD_SIZE", os.environ.get("PMI_SIZE", 1)))
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev  = 1.4
+  n_tot  = 60e6
+  return n_tot * exp(
+    -pow((lnr - log(mean_r)), 2) / 2 / pow(log(stdev),2)
+  ) / log(stdev) / sqrt(2*pi);
+
+def sd_conc(r):
+  return 4 + 2 * r
+
+def nx(r):
+  return 2 + r % 2
+
+# slabs of different width, with different number of SDs per cell
+opts_init = lgrngn.opts_init_t()
+opts_init.dry_distros = {.61:lognormal}
+opts_init.coal_switch = False
+opts_init.sedi_switch = False
+opts_init.dt = 1
+opts_init.nx = nx(rank) # number of columns of this rank
+opts_init.nz = 3
+opts_init.dx = 1
+opts_init.dz = 1
+opts_init.x1 = sum([nx(r) for r in range(n_ranks)]) * opts_init.dx # x0 and x1 of the whole domain
+opts_init.z1 = opts_init.nz * opts_init.dz
+opts_init.sd_conc = sd_conc(rank)
+opts_init.n_sd_max = 4 * sd_conc(n_ranks) * opts_init.nx * opts_init.nz # room for SDs coming from other ranks
+
+opts = lgrngn.opts_t()
+opts.adve = True
+opts.sedi = False
+opts.cond = False
+opts.coal = False
+opts.chem = False
+opts.rcyc = False
+
+rhod =   1. * np.ones((opts_init.nx, opts_init.nz))
+th   = 300. * np.ones((opts_init.nx, opts_init.nz))
+rv   = 0.01 * np.ones((opts_init.nx, opts_init.nz))
+Cx   =   1. * np.ones((opts_init.nx + 1, opts_init.nz))
+Cz   =   0. * np.ones((opts_init.nx, opts_init.nz + 1))
+
+prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+prtcls.init(th, rv, rhod, Cx=Cx, Cz=Cz)
+
+req = lgrngn.moms_req_t()
+req.rng_attr = lgrngn.attr_t.rd
+req.rng_min = 0
+req.rng_max = 1
+req.mom_attr = lgrngn.attr_t.rd
+req.moms = [0, 3]
+
+def sd_conc_diag():
+  prtcls.diag_all()
+  prtcls.diag_sd_conc()
+  return np.frombuffer(prtcls.outbuf()).reshape(opts_init.nx, opts_init.nz).copy()
+
+assert (sd_conc_diag() == sd_conc(rank)).all()
+tot_init = prtcls.diag_moms_tot([req])
+
+prtcls.step_sync(opts, th, rv, rhod, Cx=Cx, Cz=Cz)
+prtcls.step_async(opts)
+
+# every SD moved one cell to the right, the first column received SDs from the rank to the left
+tab = sd_conc_diag()
+print rank, "\n", tab
+assert (tab[1:,:] == sd_conc(rank)).all()
+assert (tab[0,:] == sd_conc((rank - 1) % n_ranks)).all()
+
+# collective diagnostics: totals over all ranks conserved
+tot = prtcls.diag_moms_tot([req])
+print rank, tot_init, tot
+assert np.allclose(tot, tot_init, atol=0, rtol=1e-10)
+# nothing fell out of the domain
+for key, val in prtcls.diag_puddle().items():
+  assert val == 0
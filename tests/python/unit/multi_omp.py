@@ -0,0 +1,91 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+import numpy as np
+from math import exp, log, sqrt, pi
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev  = 1.4
+  n_tot  = 60e6
+  return n_tot * exp(
+    -pow((lnr - log(mean_r)), 2) / 2 / pow(log(stdev),2)
+  ) / log(stdev) / sqrt(2*pi);
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dry_distros = {.61:lognormal}
+opts_init.coal_switch = False
+opts_init.sedi_switch = False
+opts_init.dt = 1
+opts_init.nx = 6
+opts_init.nz = 5
+opts_init.dx = 1
+opts_init.dz = 1
+opts_init.x1 = opts_init.nx * opts_init.dx
+opts_init.z1 = opts_init.nz * opts_init.dz
+opts_init.sd_conc = 10
+opts_init.n_sd_max = 10 * opts_init.nx * opts_init.nz
+
+opts = lgrngn.opts_t()
+opts.adve = True
+opts.sedi = False
+opts.cond = False
+opts.coal = False
+opts.chem = False
+
+rhod =   1. * np.ones((opts_init.nx, opts_init.nz))
+th   = 300. * np.ones((opts_init.nx, opts_init.nz))
+rv   = 0.01 * np.ones((opts_init.nx, opts_init.nz))
+
+def diag(prtcls):
+  prtcls.diag_all()
+  prtcls.diag_sd_conc()
+  sd_conc = np.copy(np.frombuffer(prtcls.outbuf()).reshape(opts_init.nx, opts_init.nz))
+  prtcls.diag_all()
+  prtcls.diag_dry_mom(3)
+  dry_mom3 = np.copy(np.frombuffer(prtcls.outbuf()).reshape(opts_init.nx, opts_init.nz))
+  return sd_conc, dry_mom3
+
+# particles advected by one cell in x per step, across slab boundaries and the periodic boundary
+for Cx, roll in [(1., 1), (-1., -1)]:
+  for dev_count in [1, 2, 3]:
+    opts_init.dev_count = dev_count
+    try:
+      prtcls = lgrngn.factory(lgrngn.backend_t.multi_OpenMP, opts_init)
+    except RuntimeError as e:
+      if str(e) == "multi_OpenMP backend was not compiled":
+        print "multi_OpenMP not compiled, skipping"
+        sys.exit(0)
+      raise
+
+    Cx_arr = Cx * np.ones((opts_init.nx + 1, opts_init.nz))
+    Cz_arr = 0. * np.ones((opts_init.nx, opts_init.nz + 1))
+    prtcls.init(th, rv, rhod, Cx_arr, Cz=Cz_arr)
+
+    sd_conc_in, mom_in = diag(prtcls)
+    assert (sd_conc_in == opts_init.sd_conc).all()
+
+    for it in range(opts_init.nx):
+      prtcls.step_sync(opts, th, rv, rhod)
+      prtcls.step_async(opts)
+
+      sd_conc, mom = diag(prtcls)
+      print dev_count, Cx, it, "\n", sd_conc
+      # every SD moved exactly one cell
+      assert (sd_conc == np.roll(sd_conc_in, roll, 0)).all()
+      assert np.allclose(mom, np.roll(mom_in, roll, 0), rtol=1e-6)
+      sd_conc_in, mom_in = sd_conc, mom
+
+    # after nx steps SDs are back in their initial cells
+    del prtcls
+
+# step_async_begin() without a preceding step_sync() is reported right away
+opts_init.dev_count = 2
+prtcls = lgrngn.factory(lgrngn.backend_t.multi_OpenMP, opts_init)
+prtcls.init(th, rv, rhod, Cx_arr, Cz=Cz_arr)
+try:
+  prtcls.step_async_begin(opts)
+  raise Exception("step_async_begin() before step_sync() not reported!")
+except RuntimeError:
+  pass
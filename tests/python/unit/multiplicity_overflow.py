@@ -0,0 +1,92 @@
+import sys, os
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+import numpy as np
+
+# optional argument: the expected width of n_t in bits (see LIBCLOUDPHXX_N_T_32BIT)
+n_t_bits = int(sys.argv[1]) if len(sys.argv) > 1 else None
+
+def lognormal(n_tot):
+  mean_r = .04e-6 / 2
+  stdev = 1.4
+  return lambda lnr: n_tot * np.exp(
+    -pow((lnr - np.log(mean_r)), 2) / 2 / pow(np.log(stdev),2)
+  ) / np.log(stdev) / np.sqrt(2*np.pi)
+
+# one cell of 1 m^3, few SDs, so that multiplicities are of the order of the concentration
+def opts_init(n_tot, src_n_tot = None):
+  res = lgrngn.opts_init_t()
+  res.dt = 1
+  res.nx = 1
+  res.nz = 1
+  res.dx = 1
+  res.dz = 1
+  res.x1 = 1
+  res.z1 = 1
+  res.dry_distros = {.61:lognormal(n_tot)}
+  res.sd_conc = 8
+  res.n_sd_max = 32
+  if src_n_tot is not None:
+    res.src_switch = True
+    res.src_dry_distros = {.61:lognormal(src_n_tot)}
+    res.src_sd_conc = 8
+    res.supstp_src = 1
+    res.src_z1 = res.dz
+  return res
+
+th = 300. * np.ones((1, 1))
+rv = 0.01 * np.ones((1, 1))
+rhod = 1. * np.ones((1, 1))
+
+opts = lgrngn.opts_t()
+opts.adve = False
+opts.sedi = False
+opts.cond = False
+opts.coal = False
+opts.src = True
+
+def init(oi):
+  prtcls = lgrngn.factory(lgrngn.backend_t.serial, oi)
+  prtcls.init(th, rv, rhod)
+  return prtcls
+
+def overflows(fun, what):
+  try:
+    fun()
+  except RuntimeError as e:
+    print what, ":", e
+    assert "multiplicity overflow" in str(e), what
+    return True
+  return False
+
+# width of n_t, as recorded in the header of a snapshot file
+prtcls = init(opts_init(60e6))
+snap_opts = lgrngn.snapshot_opts_t()
+snap_opts.attrs = [lgrngn.snap_attr_t.n]
+prtcls.snapshot_open("multiplicity_overflow.bin", snap_opts)
+prtcls.snapshot()
+prtcls.snapshot_close()
+n_t_size = np.fromfile("multiplicity_overflow.bin", dtype=np.uint32, count=9)[5]
+os.remove("multiplicity_overflow.bin")
+print "n_t is", 8 * n_t_size, "bit"
+assert n_t_size in (4, 8)
+if n_t_bits is not None:
+  assert 8 * n_t_size == n_t_bits
+
+# concentrations with multiplicities of ca. 1e11 fit in 64 bits, but not in 32 bits
+assert overflows(lambda: init(opts_init(1e11)), "init, 1e11") == (n_t_size == 4)
+
+# ... and those of ca. 1e22 in neither
+assert overflows(lambda: init(opts_init(1e22)), "init, 1e22")
+
+# the same for SDs added by the aerosol source
+def src(src_n_tot):
+  prtcls = init(opts_init(60e6, src_n_tot))
+  for it in range(2):
+    prtcls.step_sync(opts, th, rv, rhod)
+    prtcls.step_async(opts)
+
+assert not overflows(lambda: src(60e4), "src, 60e4")
+assert overflows(lambda: src(1e11), "src, 1e11") == (n_t_size == 4)
+assert overflows(lambda: src(1e22), "src, 1e22")
@@ -0,0 +1,68 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+
+from numpy import array as arr_t, frombuffer, allclose
+
+from math import exp, log, sqrt, pi
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev  = 1.4
+  n_tot  = 60e6
+  return n_tot * exp(
+    -pow((lnr - log(mean_r)), 2) / 2 / pow(log(stdev),2)
+  ) / log(stdev) / sqrt(2*pi);
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dry_distros = {.61:lognormal}
+opts_init.coal_switch=0
+opts_init.sedi_switch=0
+opts_init.dt = 1
+opts_init.sd_conc = 64
+opts_init.n_sd_max = 512
+opts_init.nx = 4
+opts_init.dx = 1
+opts_init.x1 = opts_init.nx * opts_init.dx
+
+backend = lgrngn.backend_t.serial
+
+opts = lgrngn.opts_t()
+opts.sedi=0
+opts.coal=0
+opts.cond=1
+opts.adve=1
+
+rhod = arr_t([  1.,   1.,   1.,   1.])
+C    = arr_t([  .3,  .3,  .3,  .3,  .3])
+
+def run(reorder_freq, reorder_threshold):
+  opts_init.reorder_freq = reorder_freq
+  opts_init.reorder_threshold = reorder_threshold
+  prtcls = lgrngn.factory(backend, opts_init)
+  th = arr_t([300., 300., 300., 300.])
+  rv = arr_t([.0025, .0095, .0080, .0090])
+  prtcls.init(th, rv, rhod, C)
+  for it in range(10):
+    prtcls.step_sync(opts, th, rv)
+    prtcls.step_async(opts)
+  prtcls.diag_all()
+  prtcls.diag_wet_mom(3)
+  return frombuffer(prtcls.outbuf()).copy(), rv.copy()
+
+# reordering particle attributes must not change the results
+ref_mom, ref_rv = run(0, 0)
+for freq, thrs in [(1, 0), (3, 0), (0, .1)]:
+  print 'reorder_freq = ' + str(freq) + ' reorder_threshold = ' + str(thrs)
+  mom, rv = run(freq, thrs)
+  assert allclose(mom, ref_mom, atol=0, rtol=1e-8)
+  assert allclose(rv, ref_rv, atol=0, rtol=1e-8)
+
+# sanity checks
+opts_init.reorder_freq = -1
+try:
+  lgrngn.factory(backend, opts_init).init(arr_t([300.]*4), arr_t([.01]*4), rhod, C)
+  raise Exception("negative reorder_freq not reported")
+except RuntimeError:
+  pass
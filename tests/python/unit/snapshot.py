@@ -0,0 +1,134 @@
+import sys, os
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+import numpy as np
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev = 1.4
+  n_tot = 60e6
+  return n_tot * np.exp(
+    -pow((lnr - np.log(mean_r)), 2) / 2 / pow(np.log(stdev),2)
+  ) / np.log(stdev) / np.sqrt(2*np.pi);
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dt = 1
+opts_init.nx = 4
+opts_init.nz = 4
+opts_init.dx = 100
+opts_init.dz = 100
+opts_init.x1 = 400
+opts_init.z1 = 400
+opts_init.dry_distros = {.61:lognormal}
+opts_init.sd_conc = 32
+opts_init.n_sd_max = 32 * 16
+
+opts = lgrngn.opts_t()
+opts.adve = True
+opts.sedi = True
+opts.cond = True
+opts.coal = True
+
+rhod = 1. * np.ones((opts_init.nx, opts_init.nz))
+Cx = .2 * np.ones((opts_init.nx + 1, opts_init.nz))
+Cz = np.zeros((opts_init.nx, opts_init.nz + 1))
+
+attrs = [lgrngn.snap_attr_t.n, lgrngn.snap_attr_t.x, lgrngn.snap_attr_t.z, lgrngn.snap_attr_t.rw2, lgrngn.snap_attr_t.rd3, lgrngn.snap_attr_t.kpa]
+n_steps = 7
+
+# reads a snapshot file, see src/detail/snapshot.hpp for the layout
+def read(path):
+  hdr = np.fromfile(path, dtype=np.uint32, count=9 + 16)
+  assert hdr[:2].tobytes() == b"LCPPSNAP"
+  version, endian, real_size, n_t_size, n_chem, sd_stride, n_attrs = hdr[2:9]
+  assert version == 2 and real_size == 8 and n_t_size in (4, 8) and n_chem == 0
+  n_dtype = np.uint64 if n_t_size == 8 else np.uint32
+  assert list(hdr[9:9+n_attrs]) == [int(a) for a in attrs]
+
+  raw = open(path, "rb").read()
+  pos = 64 * ((4 * len(hdr) + 63) // 64)
+  recs = []
+  while pos < len(raw):
+    record, n_part, n_sd, nbytes = np.frombuffer(raw, dtype=np.uint64, count=4, offset=pos)
+    off = pos + 64
+    rec = {"id" : np.frombuffer(raw, dtype=np.uint64, count=int(n_sd), offset=off)}
+    off += 64 * ((8 * int(n_sd) + 63) // 64)
+    for a in attrs:
+      dtype = n_dtype if a == lgrngn.snap_attr_t.n else np.float64
+      rec[a] = np.frombuffer(raw, dtype=dtype, count=int(n_sd), offset=off)
+      off += 64 * ((np.dtype(dtype).itemsize * int(n_sd) + 63) // 64)
+    assert off == pos + nbytes
+    recs.append((int(record), int(n_part), rec))
+    pos += int(nbytes)
+  return sd_stride, recs
+
+def run(path, sd_stride, stp_stride):
+  th = 300. * np.ones((opts_init.nx, opts_init.nz))
+  rv = 0.0105 * np.ones((opts_init.nx, opts_init.nz))
+
+  prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+  prtcls.init(th, rv, rhod, Cx=Cx, Cz=Cz)
+
+  snap_opts = lgrngn.snapshot_opts_t()
+  snap_opts.attrs = attrs
+  snap_opts.sd_stride = sd_stride
+  snap_opts.stp_stride = stp_stride
+  prtcls.snapshot_open(path, snap_opts)
+
+  # totals to compare with
+  req = lgrngn.moms_req_t()
+  req.moms = [0, 3]
+  tot = [prtcls.diag_moms_tot([req])]
+
+  prtcls.snapshot()
+  for it in range(n_steps):
+    prtcls.step_sync(opts, th, rv, rhod, Cx=Cx, Cz=Cz)
+    prtcls.step_async(opts)
+    tot.append(prtcls.diag_moms_tot([req]))
+    prtcls.snapshot() # written while the next step is being computed
+
+  prtcls.snapshot_close()
+  return tot
+
+# all SDs at every step
+tot = run("snapshot_all.bin", 1, 1)
+sd_stride, recs = read("snapshot_all.bin")
+assert len(recs) == n_steps + 1
+for it, (record, n_part, rec) in enumerate(recs):
+  assert record == it
+  assert len(rec[lgrngn.snap_attr_t.n]) == n_part
+  n = rec[lgrngn.snap_attr_t.n].astype(np.float64)
+  assert (rec[lgrngn.snap_attr_t.x] >= 0).all() and (rec[lgrngn.snap_attr_t.x] < opts_init.x1).all()
+  assert (rec[lgrngn.snap_attr_t.z] >= 0).all() and (rec[lgrngn.snap_attr_t.z] < opts_init.z1).all()
+  assert (rec[lgrngn.snap_attr_t.rw2] > 0).all() and (rec[lgrngn.snap_attr_t.rd3] > 0).all()
+  assert np.allclose(rec[lgrngn.snap_attr_t.kpa], .61)
+  # the same totals as computed by the library
+  assert np.isclose(n.sum(), tot[it][0], rtol=1e-12)
+  assert np.isclose((n * rec[lgrngn.snap_attr_t.rw2]**1.5).sum(), tot[it][1], rtol=1e-10)
+  # SD ids unique, and (no recycling) only those present at the start
+  assert len(np.unique(rec["id"])) == n_part
+  assert np.in1d(rec["id"], recs[0][2]["id"]).all()
+
+# every 3rd SD at every 2nd call, same run otherwise
+run("snapshot_sub.bin", 3, 2)
+sd_stride, sub = read("snapshot_sub.bin")
+assert sd_stride == 3
+assert [r[0] for r in sub] == range(0, n_steps + 1, 2)
+for record, n_part, rec in sub:
+  assert n_part == recs[record][1]
+  for a in attrs + ["id"]:
+    assert (rec[a] == recs[record][2][a][::3]).all()
+
+os.remove("snapshot_all.bin")
+os.remove("snapshot_sub.bin")
+
+# chem requested without chemistry is reported
+prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+snap_opts = lgrngn.snapshot_opts_t()
+snap_opts.attrs = [lgrngn.snap_attr_t.chem]
+try:
+  prtcls.snapshot_open("snapshot_chem.bin", snap_opts)
+  raise Exception("chem snapshot without chemistry not reported")
+except RuntimeError:
+  pass
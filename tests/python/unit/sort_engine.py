@@ -0,0 +1,65 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+
+import numpy as np
+from math import exp, log, sqrt, pi
+from time import time
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev  = 1.4
+  n_tot  = 60e6
+  return n_tot * exp(
+    -pow((lnr - log(mean_r)), 2) / 2 / pow(log(stdev),2)
+  ) / log(stdev) / sqrt(2*pi);
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dry_distros = {.61:lognormal}
+opts_init.kernel = lgrngn.kernel_t.geometric
+opts_init.terminal_velocity = lgrngn.vt_t.beard77fast
+opts_init.dt = 1
+opts_init.sd_conc = 64
+opts_init.n_sd_max = 64 * 16 * 16
+opts_init.nx = 16
+opts_init.nz = 16
+opts_init.dx = 10
+opts_init.dz = 10
+opts_init.x1 = opts_init.nx * opts_init.dx
+opts_init.z1 = opts_init.nz * opts_init.dz
+
+opts = lgrngn.opts_t()
+opts.adve = True
+opts.sedi = True
+opts.cond = True
+opts.coal = True
+
+rhod = np.ones((opts_init.nx, opts_init.nz))
+Cx = .1 * np.ones((opts_init.nx + 1, opts_init.nz))
+Cz = .05 * np.ones((opts_init.nx, opts_init.nz + 1))
+
+def run(sort_engine):
+  opts_init.sort_engine = sort_engine
+  prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+  th = 300. * np.ones((opts_init.nx, opts_init.nz))
+  rv = .0095 * np.ones((opts_init.nx, opts_init.nz))
+  prtcls.init(th, rv, rhod, Cx=Cx, Cz=Cz)
+  t0 = time()
+  for it in range(20):
+    prtcls.step_sync(opts, th, rv)
+    prtcls.step_async(opts)
+    prtcls.diag_all()
+    prtcls.diag_wet_mom(0)
+  print 'time: ' + str(time() - t0) + ' s'
+  prtcls.diag_all()
+  prtcls.diag_wet_mom(3)
+  return np.frombuffer(prtcls.outbuf()).copy()
+
+print 'full sort'
+ref = run(lgrngn.sort_t.full)
+print 'incremental sort'
+res = run(lgrngn.sort_t.incremental)
+
+# only the order of summation within cells may differ
+assert np.allclose(res, ref, atol=0, rtol=1e-8)
@@ -0,0 +1,125 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+import numpy as np
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev = 1.4
+  n_tot = 1e3 # few particles, to barely affect th and rv by condensation
+  return n_tot * np.exp(
+    -pow((lnr - np.log(mean_r)), 2) / 2 / pow(np.log(stdev),2)
+  ) / np.log(stdev) / np.sqrt(2*np.pi);
+
+opts = lgrngn.opts_t()
+opts.adve = False
+opts.sedi = False
+opts.coal = False
+opts.cond = True # th and rv synced out
+
+def check(shape, kwargs):
+  n = int(np.prod(shape))
+  rhod = 1. * np.ones(shape)
+  th = 300. * np.ones(shape)
+  # rv increasing with the C-order linear index -> so does RH
+  rv = (0.005 + 0.005 * np.arange(n) / max(n - 1, 1)).reshape(shape)
+  rv_in = rv.copy()
+  th_in = th.copy()
+
+  prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+  prtcls.init(th, rv, rhod, **kwargs)
+
+  prtcls.diag_RH()
+  RH = np.frombuffer(prtcls.outbuf()).copy()
+  assert len(RH) == n
+  if n > 1:
+    assert (np.diff(RH) > 0).all()
+
+  # syncing out writes every cell back to its own place
+  prtcls.step_sync(opts, th, rv, rhod, **kwargs)
+  print shape, abs(rv / rv_in - 1).max(), abs(th / th_in - 1).max()
+  assert abs(rv / rv_in - 1).max() < 1e-3
+  assert abs(th / th_in - 1).max() < 1e-3
+
+  # and keeps the same mapping on the next sync in
+  prtcls.step_async(opts)
+  prtcls.diag_RH()
+  RH = np.frombuffer(prtcls.outbuf()).copy()
+  if n > 1:
+    assert (np.diff(RH) > 0).all()
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dt = 1
+opts_init.dry_distros = {.61:lognormal}
+opts_init.sd_conc = 8
+
+# 0D
+opts_init.n_sd_max = 8
+check((1,), {})
+
+# 2D
+opts_init.nx, opts_init.nz = 3, 4
+opts_init.dx = opts_init.dz = 10
+opts_init.x1, opts_init.z1 = opts_init.nx * opts_init.dx, opts_init.nz * opts_init.dz
+opts_init.n_sd_max = 8 * opts_init.nx * opts_init.nz
+check((opts_init.nx, opts_init.nz), {
+  'Cx' : np.zeros((opts_init.nx + 1, opts_init.nz)),
+  'Cz' : np.zeros((opts_init.nx, opts_init.nz + 1))
+})
+
+# 3D
+opts_init.ny = 2
+opts_init.dy = 10
+opts_init.y1 = opts_init.ny * opts_init.dy
+opts_init.n_sd_max = 8 * opts_init.nx * opts_init.ny * opts_init.nz
+check((opts_init.nx, opts_init.ny, opts_init.nz), {
+  'Cx' : np.zeros((opts_init.nx + 1, opts_init.ny, opts_init.nz)),
+  'Cy' : np.zeros((opts_init.nx, opts_init.ny + 1, opts_init.nz)),
+  'Cz' : np.zeros((opts_init.nx, opts_init.ny, opts_init.nz + 1))
+})
+
+# 1D profiles in 2D and 3D set-ups (zero strides in x and y): the mapping is not contiguous,
+# so th, rv and rhod are gathered with c_arr_get3 and th and rv scattered with c_arr_set2;
+# compared with the same fields passed as full (contiguous) arrays
+def check_profiles(shape, kwargs):
+  nz = shape[-1]
+  prof = [
+    300. * np.ones(nz),                                 # th
+    0.005 + 0.005 * np.arange(nz) / max(nz - 1., 1.),   # rv
+    1. * np.ones(nz)                                    # rhod
+  ]
+
+  res = []
+  for use_prof in [False, True]:
+    th, rv, rhod = [a.copy() for a in prof] if use_prof else [a * np.ones(shape) for a in prof]
+    prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+    prtcls.init(th, rv, rhod, **kwargs)
+    prtcls.diag_RH()
+    RH = np.frombuffer(prtcls.outbuf()).copy()
+    prtcls.step_sync(opts, th, rv, rhod, **kwargs)
+    res.append((RH, th, rv))
+
+  (RH_full, th_full, rv_full), (RH_prof, th_prof, rv_prof) = res
+  assert (RH_prof == RH_full).all()
+
+  # cells are scattered back in order (serial backend), the last cell of each level remains
+  assert (th_prof == th_full.reshape(-1, nz)[-1]).all()
+  assert (rv_prof == rv_full.reshape(-1, nz)[-1]).all()
+
+opts_init.ny, opts_init.dy, opts_init.y1 = 0, 1, 1
+opts_init.n_sd_max = 8 * opts_init.nx * opts_init.nz
+check_profiles((opts_init.nx, opts_init.nz), {
+  'Cx' : np.zeros((opts_init.nx + 1, opts_init.nz)),
+  'Cz' : np.zeros((opts_init.nx, opts_init.nz + 1))
+})
+
+opts_init.ny = 2
+opts_init.dy = 10
+opts_init.y1 = opts_init.ny * opts_init.dy
+opts_init.n_sd_max = 8 * opts_init.nx * opts_init.ny * opts_init.nz
+check_profiles((opts_init.nx, opts_init.ny, opts_init.nz), {
+  'Cx' : np.zeros((opts_init.nx + 1, opts_init.ny, opts_init.nz)),
+  'Cy' : np.zeros((opts_init.nx, opts_init.ny + 1, opts_init.nz)),
+  'Cz' : np.zeros((opts_init.nx, opts_init.ny, opts_init.nz + 1))
+})
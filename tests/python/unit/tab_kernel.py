@@ -0,0 +1,75 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+from math import exp, log, sqrt, pi
+import numpy as np
+
+rhod = 1. * np.ones((1,))
+th = 300. * np.ones((1,))
+rv = 0.01 * np.ones((1,))
+
+def expvolumelnr(lnr):  
+  r_zero = 30.531e-6
+  n_zero = pow(2,23)
+  r=np.exp(lnr)
+  return n_zero * 3.*np.power(r,3)/np.power(r_zero,3)*np.exp(- np.power((r/r_zero),3));
+
+Opts = lgrngn.opts_t()
+Opts.adve = False
+Opts.sedi = False
+Opts.cond = False
+Opts.coal = True
+
+def run(kernel, tab, n_r = lgrngn.opts_init_t().tab_kernel_n_r):
+  opts_init = lgrngn.opts_init_t()
+  opts_init.dt = 10
+  opts_init.dry_distros = {.1:expvolumelnr}
+  opts_init.sd_conc = 512
+  opts_init.n_sd_max = 512
+  opts_init.terminal_velocity=lgrngn.vt_t.beard76
+  opts_init.kernel = kernel
+  opts_init.kernel_parameters = np.array([])
+  if(kernel == lgrngn.kernel_t.onishi_hall):
+    opts_init.kernel_parameters = np.array([0.04, 100]);
+  opts_init.tab_kernel = tab
+  opts_init.tab_kernel_n_r = n_r
+
+  prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+  prtcls.init(th, rv, rhod)
+
+  info = prtcls.diag_kernel_tab()
+  for it in range(10):
+    prtcls.step_sync(Opts,th,rv,rhod)
+    prtcls.step_async(Opts)
+
+  prtcls.diag_all()
+  prtcls.diag_wet_mom(0)
+  return info, np.frombuffer(prtcls.outbuf()).copy()
+
+for kernel in [lgrngn.kernel_t.long, lgrngn.kernel_t.hall, lgrngn.kernel_t.onishi_hall]:
+  info, m0_exact = run(kernel, False)
+  assert info.n_r == 0
+
+  info, m0_tab = run(kernel, True)
+  print kernel, info.n_r, info.r_min, info.r_max, info.err_max, info.err_rel
+  assert info.n_r == lgrngn.opts_init_t().tab_kernel_n_r
+  assert info.r_max > info.r_min
+  assert info.err_rel >= 0 and info.err_rel < .05
+
+  # coalescence proceeds at a similar rate with the tabulated and exact kernel
+  print m0_exact, m0_tab
+  assert abs(m0_tab - m0_exact) / m0_exact < .1
+
+  # the error (estimated over the whole range of the table) decreases with its resolution
+  info_coarse, _ = run(kernel, True, info.n_r / 4)
+  print kernel, info_coarse.n_r, info_coarse.err_max
+  assert info_coarse.r_min == info.r_min and info_coarse.r_max == info.r_max
+  assert info_coarse.err_max > info.err_max
+
+# tabulation not available for kernels without radius-dependent efficiencies
+try:
+  run(lgrngn.kernel_t.geometric, True)
+  raise Exception("tab_kernel with the geometric kernel should fail")
+except RuntimeError:
+  pass
@@ -0,0 +1,55 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+import numpy as np
+
+rhod = 1. * np.ones((1,))
+th = 300. * np.ones((1,))
+rv = 0.01 * np.ones((1,))
+
+def expvolumelnr(lnr):  
+  r_zero = 30.531e-6
+  n_zero = pow(2,23)
+  r=np.exp(lnr)
+  return n_zero * 3.*np.power(r,3)/np.power(r_zero,3)*np.exp(- np.power((r/r_zero),3));
+
+Opts = lgrngn.opts_t()
+Opts.adve = False
+Opts.sedi = False
+Opts.cond = False
+Opts.coal = True
+
+def run(vt_eq, tab):
+  opts_init = lgrngn.opts_init_t()
+  opts_init.dt = 10
+  opts_init.dry_distros = {.1:expvolumelnr}
+  opts_init.sd_conc = 256
+  opts_init.n_sd_max = 256
+  opts_init.kernel = lgrngn.kernel_t.geometric
+  opts_init.terminal_velocity = vt_eq
+  opts_init.tab_vterm = tab
+
+  prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+  prtcls.init(th, rv, rhod)
+  info = prtcls.diag_vt_tab()
+
+  for it in range(10):
+    prtcls.step_sync(Opts,th,rv,rhod)
+    prtcls.step_async(Opts)
+
+  prtcls.diag_all()
+  prtcls.diag_wet_mom(0)
+  return info, np.frombuffer(prtcls.outbuf()).copy()
+
+for vt_eq in [lgrngn.vt_t.beard76, lgrngn.vt_t.beard77, lgrngn.vt_t.beard77fast, lgrngn.vt_t.khvorostyanov_spherical, lgrngn.vt_t.khvorostyanov_nonspherical]:
+  info, m0_exact = run(vt_eq, False)
+  assert info.n_r == 0
+
+  info, m0_tab = run(vt_eq, True)
+  print vt_eq, info.n_r, info.n_T, info.n_rhod, info.err_rel, m0_exact, m0_tab
+  assert info.n_r > 1 and info.n_T > 1 and info.n_rhod > 1
+  assert info.err_rel >= 0 and info.err_rel < .02
+
+  # coalescence (driven by velocity differences) proceeds at a similar rate
+  assert abs(m0_tab - m0_exact) / m0_exact < .1
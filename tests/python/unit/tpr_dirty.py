@@ -0,0 +1,58 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+import numpy as np
+
+rhod = 1. * np.ones((1,))
+th = 300. * np.ones((1,))
+rv = 0.01 * np.ones((1,))
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev = 1.4
+  n_tot = 60e6
+  return n_tot * np.exp(
+    -pow((lnr - np.log(mean_r)), 2) / 2 / pow(np.log(stdev),2)
+  ) / np.log(stdev) / np.sqrt(2*np.pi);
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dt = 1
+opts_init.dry_distros = {.61:lognormal}
+opts_init.sd_conc = 64
+opts_init.n_sd_max = 64
+
+opts = lgrngn.opts_t()
+opts.adve = False
+opts.sedi = False
+opts.coal = False
+opts.cond = False
+
+def RH(prtcls):
+  prtcls.diag_RH()
+  return np.frombuffer(prtcls.outbuf()).copy()
+
+prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+prtcls.init(th, rv, rhod)
+
+# repeated diagnostics without a change of state give the same answer
+RH0 = RH(prtcls)
+assert (RH(prtcls) == RH0).all()
+
+# RH follows a change of rv passed to step_sync, even with no process enabled
+rv_moist = 0.012 * np.ones((1,))
+prtcls.step_sync(opts, th, rv_moist, rhod)
+RH1 = RH(prtcls)
+print RH0, RH1
+assert RH1[0] > RH0[0]
+
+# ... and of th
+th_warm = 305. * np.ones((1,))
+prtcls.step_sync(opts, th_warm, rv_moist, rhod)
+RH2 = RH(prtcls)
+print RH2
+assert RH2[0] < RH1[0]
+
+# and stays put afterwards
+assert (RH(prtcls) == RH2).all()
+
@@ -0,0 +1,90 @@
+import sys
+sys.path.insert(0, "../../bindings/python/")
+
+from libcloudphxx import lgrngn
+import numpy as np
+
+def lognormal(lnr):
+  mean_r = .04e-6 / 2
+  stdev = 1.4
+  n_tot = 60e6
+  return n_tot * np.exp(
+    -pow((lnr - np.log(mean_r)), 2) / 2 / pow(np.log(stdev),2)
+  ) / np.log(stdev) / np.sqrt(2*np.pi);
+
+def lognormal_src(lnr):
+  mean_r = .10e-6 / 2
+  stdev = 1.4
+  n_tot = 60e4
+  return n_tot * np.exp(
+    -pow((lnr - np.log(mean_r)), 2) / 2 / pow(np.log(stdev),2)
+  ) / np.log(stdev) / np.sqrt(2*np.pi);
+
+opts_init = lgrngn.opts_init_t()
+opts_init.dt = 1
+opts_init.nx = 4
+opts_init.nz = 4
+opts_init.dx = 100
+opts_init.dz = 100
+opts_init.x1 = 400
+opts_init.z1 = 400
+opts_init.dry_distros = {.61:lognormal}
+opts_init.src_dry_distros = {.61:lognormal_src}
+opts_init.sd_conc = 32
+opts_init.src_sd_conc = 16
+opts_init.supstp_src = 5
+opts_init.src_z1 = opts_init.dz
+opts_init.src_switch = True
+opts_init.n_sd_max = 32 * 16 * 2
+
+opts = lgrngn.opts_t()
+opts.adve = True
+opts.sedi = True
+opts.cond = True
+opts.coal = True
+opts.src = True
+
+th = 300. * np.ones((opts_init.nx, opts_init.nz))
+rv = 0.0105 * np.ones((opts_init.nx, opts_init.nz))
+rhod = 1. * np.ones((opts_init.nx, opts_init.nz))
+Cx = .2 * np.ones((opts_init.nx + 1, opts_init.nz))
+Cz = np.zeros((opts_init.nx, opts_init.nz + 1))
+
+prtcls = lgrngn.factory(lgrngn.backend_t.serial, opts_init)
+prtcls.init(th, rv, rhod, Cx=Cx, Cz=Cz)
+
+# everything reserved at init
+ws = prtcls.diag_workspace()
+reserved = ws.reserved_bytes
+assert reserved >= 8 * opts_init.n_sd_max
+assert ws.n_alloc == 0
+
+for it in range(10):
+  prtcls.step_sync(opts, th, rv, rhod, Cx=Cx, Cz=Cz)
+  prtcls.step_async(opts)
+
+# ... and nothing allocated in the step loop, including the source
+ws = prtcls.diag_workspace()
+print ws.reserved_bytes, ws.resident_bytes, ws.n_alloc, ws.peak_bytes
+assert ws.n_alloc == 0
+assert ws.reserved_bytes == reserved
+
+# the per-particle temporaries follow n_part
+prtcls.diag_all()
+prtcls.diag_sd_conc()
+n_part = np.frombuffer(prtcls.outbuf()).sum()
+assert 8 * n_part <= ws.resident_bytes <= reserved
+
+# bytes in use are accounted for per stage: the resident temporaries in all stages, and on top
+# of them the scoped ones leased e.g. by the source (the bin bookkeeping and the host copies in init_n_sd_conc())
+for stage in ["cond", "src", "vterm", "coal", "adve", "sedi", "bcnd", "remove", "hskpng"]:
+  assert stage in ws.peak_bytes, stage
+  assert 0 < ws.peak_bytes[stage] <= reserved, stage
+
+# the moments computed in one pass lease their output, the pool grows only for more moments
+req = lgrngn.moms_req_t()
+req.moms = [0, 3]
+prtcls.diag_moms([req])
+n_alloc = prtcls.diag_workspace().n_alloc
+prtcls.diag_moms([req])
+assert prtcls.diag_workspace().n_alloc == n_alloc